@@ -0,0 +1,69 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "hft_core/Histogram.hpp"
+#include "hft_core/Timer.hpp"
+#include "hft_core/Topology.hpp"
+
+namespace hft::bench {
+
+using core::Histogram;
+using core::HistogramSnapshot;
+using core::Timer;
+
+// CPU for the n-th benchmark thread: CPUs are handed out in order, wrapping
+// when there are more threads than CPUs.
+inline int bench_cpu(size_t n) {
+    static const std::vector<core::CpuInfo> cpus = core::CpuTopology::system().cpus();
+    return cpus.empty() ? -1 : cpus[n % cpus.size()].cpu;
+}
+
+inline void pin_bench_thread(size_t n) {
+    const int cpu = bench_cpu(n);
+    if (cpu >= 0) {
+        core::pin_current_thread(cpu);
+    }
+}
+
+// Latency samples in TSC ticks, converted at report time so the measured
+// loop only pays for the rdtscs. report() adds p50/p99/p99.9/max (ns) to the
+// JSON counters; with several benchmark threads each reports its own
+// recorder and the output is their average.
+class LatencyRecorder {
+public:
+    LatencyRecorder() : ticks_(std::make_unique<Histogram>()) {}
+
+    void record_since(uint64_t start_tsc) noexcept {
+        ticks_->record(Timer::rdtsc() - start_tsc);
+    }
+
+    void record_ticks(uint64_t ticks) noexcept {
+        ticks_->record(ticks);
+    }
+
+    void reset() noexcept {
+        ticks_->reset();
+    }
+
+    void report(benchmark::State& state) const {
+        const HistogramSnapshot ticks = ticks_->snapshot();
+        auto ns = [](uint64_t value) { return Timer::ticks_to_nanos(value); };
+        using benchmark::Counter;
+        auto counter = [](uint64_t value) {
+            return Counter(static_cast<double>(value), Counter::kAvgThreads);
+        };
+        state.counters["p50_ns"] = counter(ns(ticks.p50()));
+        state.counters["p99_ns"] = counter(ns(ticks.p99()));
+        state.counters["p999_ns"] = counter(ns(ticks.p999()));
+        state.counters["max_ns"] = counter(ns(ticks.max()));
+    }
+
+private:
+    std::unique_ptr<Histogram> ticks_;
+};
+
+} // namespace hft::bench
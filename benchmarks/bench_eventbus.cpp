@@ -0,0 +1,191 @@
+#include "bench_common.hpp"
+
+#include "hft_core/EventBus.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace hft::core;
+using hft::bench::LatencyRecorder;
+using hft::bench::bench_cpu;
+using hft::bench::pin_bench_thread;
+
+DECLARE_EVENT(BenchTick) {
+public:
+    BenchTick(uint64_t sent, size_t producer) : sent_tsc(sent), producer(producer) {}
+
+    uint64_t sent_tsc;
+    size_t producer;
+    double price = 101.25;
+};
+
+namespace {
+
+constexpr size_t kMaxProducers = 64;
+
+// Publish-to-handler latency per producer; written by the dispatching thread.
+struct Producers {
+    std::array<LatencyRecorder, kMaxProducers> latency;
+    std::array<std::atomic<uint64_t>, kMaxProducers> handled{};
+};
+
+Producers& producers() {
+    static Producers instance;
+    return instance;
+}
+
+void subscribe_recorder() {
+    EventBus::instance().subscribe<BenchTick>([](const BenchTick& tick) {
+        Producers& p = producers();
+        p.latency[tick.producer].record_since(tick.sent_tsc);
+        p.handled[tick.producer].fetch_add(1, std::memory_order_release);
+    });
+}
+
+void reset_bus() {
+    auto& bus = EventBus::instance();
+    bus.shutdown();
+    bus.unsubscribe<BenchTick>();
+}
+
+void BM_EventBusSyncPublish(benchmark::State& state) {
+    pin_bench_thread(0);
+    reset_bus();
+    subscribe_recorder();
+    producers().latency[0].reset();
+
+    auto& bus = EventBus::instance();
+    for (auto _ : state) {
+        bus.publish(BenchTick(Timer::rdtsc(), 0));
+    }
+    producers().latency[0].report(state);
+    reset_bus();
+}
+BENCHMARK(BM_EventBusSyncPublish);
+
+// Thread 0 starts the async worker (pinned to the first CPU) before the
+// loop; Google Benchmark holds the other threads at the loop start until
+// every thread is there, and again at the end.
+void start_async_bus(benchmark::State& state, WaitStrategy wait) {
+    if (state.thread_index() == 0) {
+        reset_bus();
+        subscribe_recorder();
+        AsyncOptions options;
+        options.wait_strategy = wait;
+        options.worker_cpus = {bench_cpu(0)};
+        EventBus::instance().set_async_options(options);
+        EventBus::instance().set_async_mode(true);
+    }
+    const size_t self = static_cast<size_t>(state.thread_index());
+    producers().latency[self].reset();
+    pin_bench_thread(1 + self);
+}
+
+// Each producer keeps one event in flight, so this is publish->dispatch
+// latency under 1..N contending producers rather than queueing delay.
+void BM_EventBusAsyncPublishToDispatch(benchmark::State& state) {
+    start_async_bus(state, static_cast<WaitStrategy>(state.range(0)));
+    const size_t self = static_cast<size_t>(state.thread_index());
+    auto& bus = EventBus::instance();
+    auto& handled = producers().handled[self];
+
+    for (auto _ : state) {
+        const uint64_t expected = handled.load(std::memory_order_relaxed) + 1;
+        bus.publish(BenchTick(Timer::rdtsc(), self));
+        while (handled.load(std::memory_order_acquire) < expected) {
+            std::this_thread::yield();
+        }
+    }
+    producers().latency[self].report(state);
+    if (self == 0) {
+        reset_bus();
+    }
+}
+BENCHMARK(BM_EventBusAsyncPublishToDispatch)->ArgName("wait_strategy")
+    ->Arg(static_cast<int>(WaitStrategy::Yield))
+    ->Arg(static_cast<int>(WaitStrategy::Block))
+    ->ThreadRange(1, 4)->UseRealTime();
+
+// Fire-and-forget publishing; latency includes time spent queued.
+void BM_EventBusAsyncThroughput(benchmark::State& state) {
+    start_async_bus(state, WaitStrategy::Block);
+    const size_t self = static_cast<size_t>(state.thread_index());
+    auto& bus = EventBus::instance();
+
+    for (auto _ : state) {
+        bus.publish(BenchTick(Timer::rdtsc(), self));
+    }
+    if (self == 0) {
+        bus.flush();
+    }
+    producers().latency[self].report(state);
+    state.SetItemsProcessed(state.iterations());
+    if (self == 0) {
+        reset_bus();
+    }
+}
+BENCHMARK(BM_EventBusAsyncThroughput)->ThreadRange(1, 4)->UseRealTime();
+
+struct JournalTick {
+    uint64_t timestamp;
+    uint64_t instrument;
+    double price;
+};
+
+std::string journal_path() {
+    return "/tmp/hft_bench_journal." + std::to_string(::getpid());
+}
+
+void BM_JournalPublish(benchmark::State& state) {
+    pin_bench_thread(0);
+    auto& bus = EventBus::instance();
+    bus.subscribe<JournalTick>([](const JournalTick& tick) { benchmark::DoNotOptimize(tick.price); });
+    bus.open_journal(journal_path());
+
+    uint64_t n = 0;
+    for (auto _ : state) {
+        bus.publish(JournalTick{n, n & 63, 101.25});
+        ++n;
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    bus.close_journal();
+    bus.unsubscribe<JournalTick>();
+    std::remove(journal_path().c_str());
+}
+BENCHMARK(BM_JournalPublish);
+
+// Replay of one million recorded ticks into a trivial handler.
+void BM_JournalReplay(benchmark::State& state) {
+    pin_bench_thread(0);
+    constexpr uint64_t kRecords = 1'000'000;
+    {
+        JournalWriter writer(journal_path());
+        for (uint64_t i = 0; i < kRecords; ++i) {
+            const JournalTick tick{i, i & 63, 101.25};
+            writer.append(detail::ipc_type_id<JournalTick>(), tick.timestamp, &tick, sizeof(tick));
+        }
+    }
+    auto& bus = EventBus::instance();
+    bus.subscribe<JournalTick>([](const JournalTick& tick) { benchmark::DoNotOptimize(tick.price); });
+
+    JournalReader journal(journal_path());
+    for (auto _ : state) {
+        journal.rewind();
+        benchmark::DoNotOptimize(bus.replay(journal).replayed);
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * journal.size()));
+
+    bus.unsubscribe<JournalTick>();
+    std::remove(journal_path().c_str());
+}
+BENCHMARK(BM_JournalReplay)->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
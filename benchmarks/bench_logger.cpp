@@ -0,0 +1,57 @@
+#include "bench_common.hpp"
+
+#include "hft_core/Logger.hpp"
+
+using namespace hft::core;
+using hft::bench::LatencyRecorder;
+using hft::bench::pin_bench_thread;
+
+namespace {
+
+// Logs go to /dev/null so the background writer is never the bottleneck;
+// full staging buffers drop instead of blocking the measured call.
+void configure_logger(LogFormat format) {
+    auto& logger = Logger::instance();
+    logger.set_level(LogLevel::INFO);
+    logger.set_backpressure(LogBackpressure::Drop);
+    logger.set_output_file("/dev/null", format);
+}
+
+void BM_LogCallSite(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        configure_logger(state.range(0) == 0 ? LogFormat::Text : LogFormat::Binary);
+    }
+    pin_bench_thread(1 + static_cast<size_t>(state.thread_index()));
+
+    LatencyRecorder latency;
+    const uint64_t dropped_before = Logger::instance().current_thread_stats().dropped;
+    uint64_t order_id = 0;
+    const double price = 101.25;
+    for (auto _ : state) {
+        const uint64_t start = Timer::rdtsc();
+        LOG_INFO("order {} filled {} @ {}", ++order_id, 100, price);
+        latency.record_since(start);
+    }
+    latency.report(state);
+    state.counters["dropped"] = benchmark::Counter(
+        static_cast<double>(Logger::instance().current_thread_stats().dropped - dropped_before),
+        benchmark::Counter::kAvgThreads);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LogCallSite)->ArgName("binary")->Arg(0)->Arg(1)->ThreadRange(1, 4)->UseRealTime();
+
+// Cost of a call site whose level is filtered out.
+void BM_LogDisabledLevel(benchmark::State& state) {
+    configure_logger(LogFormat::Text);
+    pin_bench_thread(1);
+    uint64_t order_id = 0;
+    for (auto _ : state) {
+        LOG_DEBUG("order {} filled", ++order_id);
+    }
+    benchmark::DoNotOptimize(order_id);
+}
+BENCHMARK(BM_LogDisabledLevel);
+
+} // namespace
+
+BENCHMARK_MAIN();
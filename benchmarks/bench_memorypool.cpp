@@ -0,0 +1,96 @@
+#include "bench_common.hpp"
+
+#include "hft_core/MemoryPool.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+
+using namespace hft::core;
+using hft::bench::LatencyRecorder;
+using hft::bench::pin_bench_thread;
+
+namespace {
+
+struct Order {
+    uint64_t id;
+    double price;
+    uint32_t quantity;
+    char symbol[12];
+};
+
+// Allocate + touch + free per iteration, all threads sharing one pool.
+template<typename Alloc, typename Free>
+void alloc_free_loop(benchmark::State& state, Alloc&& alloc, Free&& release) {
+    pin_bench_thread(static_cast<size_t>(state.thread_index()));
+    LatencyRecorder latency;
+    uint64_t id = 0;
+    for (auto _ : state) {
+        const uint64_t start = Timer::rdtsc();
+        Order* order = alloc();
+        order->id = ++id;
+        benchmark::DoNotOptimize(order);
+        release(order);
+        latency.record_since(start);
+    }
+    latency.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_Malloc(benchmark::State& state) {
+    alloc_free_loop(state,
+        [] { return static_cast<Order*>(std::malloc(sizeof(Order))); },
+        [](Order* order) { std::free(order); });
+}
+BENCHMARK(BM_Malloc)->ThreadRange(1, 8)->UseRealTime();
+
+// MemoryPool is single-threaded, so sharing it takes a lock.
+void BM_MemoryPoolLocked(benchmark::State& state) {
+    static MemoryPool<Order> pool(16);
+    static std::mutex mutex;
+    alloc_free_loop(state,
+        [] { std::lock_guard<std::mutex> lock(mutex); return pool.allocate(); },
+        [](Order* order) { std::lock_guard<std::mutex> lock(mutex); pool.deallocate(order); });
+}
+BENCHMARK(BM_MemoryPoolLocked)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_LockFreeMemoryPool(benchmark::State& state) {
+    static LockFreeMemoryPool<Order> pool(4096);
+    alloc_free_loop(state,
+        [] { return pool.allocate(); },
+        [](Order* order) { pool.deallocate(order); });
+}
+BENCHMARK(BM_LockFreeMemoryPool)->ThreadRange(1, 8)->UseRealTime();
+
+// Every node is handed to the next thread, which frees it: the
+// producer/consumer pattern where frees land in a foreign magazine.
+void BM_LockFreeMemoryPoolCrossThreadFree(benchmark::State& state) {
+    static LockFreeMemoryPool<Order> pool(4096);
+    static std::atomic<Order*> handoff[64];
+    const size_t self = static_cast<size_t>(state.thread_index());
+    const size_t peer = (self + 1) % static_cast<size_t>(state.threads());
+    pin_bench_thread(self);
+
+    LatencyRecorder latency;
+    for (auto _ : state) {
+        const uint64_t start = Timer::rdtsc();
+        if (Order* unclaimed = handoff[peer].exchange(pool.allocate(), std::memory_order_acq_rel)) {
+            pool.deallocate(unclaimed);
+        }
+        if (Order* received = handoff[self].exchange(nullptr, std::memory_order_acq_rel)) {
+            pool.deallocate(received);
+        }
+        latency.record_since(start);
+    }
+    // All threads have left the loop; each drains its own slot.
+    if (Order* left = handoff[self].exchange(nullptr)) {
+        pool.deallocate(left);
+    }
+    latency.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LockFreeMemoryPoolCrossThreadFree)->ThreadRange(2, 8)->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
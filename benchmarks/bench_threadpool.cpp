@@ -0,0 +1,104 @@
+#include "bench_common.hpp"
+
+#include "hft_core/InlineTask.hpp"
+#include "hft_core/ThreadPool.hpp"
+
+#include <atomic>
+#include <thread>
+
+using namespace hft::core;
+using hft::bench::LatencyRecorder;
+using hft::bench::pin_bench_thread;
+
+namespace {
+
+constexpr size_t kThroughputBatch = 1024;
+
+// One task in flight: post, wait until it has run, repeat. Measures
+// enqueue-to-run latency including the worker wake-up.
+template<typename Post>
+void ping_pong(benchmark::State& state, size_t workers, Post&& post) {
+    pin_bench_thread(workers);
+    LatencyRecorder latency;
+    std::atomic<bool> done{false};
+    for (auto _ : state) {
+        done.store(false, std::memory_order_relaxed);
+        const uint64_t start = Timer::rdtsc();
+        post([&latency, &done, start] {
+            latency.record_since(start);
+            done.store(true, std::memory_order_release);
+        });
+        while (!done.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+    latency.report(state);
+}
+
+// Batches of kThroughputBatch tasks from every benchmark thread.
+template<typename Post>
+void throughput(benchmark::State& state, size_t workers, Post&& post) {
+    pin_bench_thread(workers + static_cast<size_t>(state.thread_index()));
+    std::atomic<uint64_t> sink{0};
+    for (auto _ : state) {
+        CountdownLatch latch(kThroughputBatch);
+        for (size_t i = 0; i < kThroughputBatch; ++i) {
+            post([&latch, &sink, i] {
+                sink.fetch_add(i, std::memory_order_relaxed);
+                latch.count_down();
+            });
+        }
+        latch.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kThroughputBatch));
+}
+
+SchedulingMode mode_of(const benchmark::State& state) {
+    return state.range(0) == 0 ? SchedulingMode::SharedQueue : SchedulingMode::WorkStealing;
+}
+
+void BM_ThreadPoolEnqueueToRun(benchmark::State& state) {
+    ThreadPool pool(PlacementPolicy{}, 1, mode_of(state));
+    ping_pong(state, 1, [&pool](auto&& task) { pool.post(std::move(task)); });
+}
+BENCHMARK(BM_ThreadPoolEnqueueToRun)->ArgName("work_stealing")->Arg(0)->Arg(1)->UseRealTime();
+
+void BM_ThreadPoolThroughput(benchmark::State& state) {
+    static ThreadPool shared(PlacementPolicy{}, 2, SchedulingMode::SharedQueue);
+    static ThreadPool stealing(PlacementPolicy{}, 2, SchedulingMode::WorkStealing);
+    ThreadPool& pool = state.range(0) == 0 ? shared : stealing;
+    throughput(state, pool.size(), [&pool](auto&& task) { pool.post(std::move(task)); });
+}
+BENCHMARK(BM_ThreadPoolThroughput)->ArgName("work_stealing")->Arg(0)->Arg(1)
+    ->ThreadRange(1, 4)->UseRealTime();
+
+HighPriorityPoolOptions high_priority_options(const benchmark::State& state) {
+    HighPriorityPoolOptions options;
+    options.wait_strategy = static_cast<WaitStrategy>(state.range(0));
+    options.realtime = false;       // Spinning workers share cores with the producers here
+    return options;
+}
+
+void BM_HighPriorityEnqueueToRun(benchmark::State& state) {
+    HighPriorityThreadPool pool(1, PlacementPolicy{}, high_priority_options(state));
+    ping_pong(state, 1, [&pool](auto&& task) { pool.post(TaskPriority::Critical, std::move(task)); });
+}
+BENCHMARK(BM_HighPriorityEnqueueToRun)->ArgName("wait_strategy")
+    ->Arg(static_cast<int>(WaitStrategy::BusySpin))
+    ->Arg(static_cast<int>(WaitStrategy::Yield))
+    ->Arg(static_cast<int>(WaitStrategy::Block))
+    ->UseRealTime();
+
+void BM_HighPriorityThroughput(benchmark::State& state) {
+    static HighPriorityThreadPool pool(2, PlacementPolicy{}, [] {
+        HighPriorityPoolOptions options;
+        options.realtime = false;
+        return options;
+    }());
+    throughput(state, 2, [](auto&& task) { pool.post(TaskPriority::Normal, std::move(task)); });
+}
+BENCHMARK(BM_HighPriorityThroughput)->ThreadRange(1, 4)->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
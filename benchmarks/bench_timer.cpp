@@ -0,0 +1,69 @@
+#include "bench_common.hpp"
+
+using namespace hft::core;
+using hft::bench::pin_bench_thread;
+
+namespace {
+
+void BM_Rdtsc(benchmark::State& state) {
+    pin_bench_thread(0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Timer::rdtsc());
+    }
+}
+BENCHMARK(BM_Rdtsc);
+
+void BM_RdtscOrdered(benchmark::State& state) {
+    pin_bench_thread(0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Timer::rdtsc_ordered());
+    }
+}
+BENCHMARK(BM_RdtscOrdered);
+
+void BM_Rdtscp(benchmark::State& state) {
+    pin_bench_thread(0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Timer::rdtscp());
+    }
+}
+BENCHMARK(BM_Rdtscp);
+
+void BM_TscToNanos(benchmark::State& state) {
+    pin_bench_thread(0);
+    uint64_t start = Timer::rdtsc();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Timer::tsc_to_nanos(start, start + 12345));
+        ++start;
+    }
+}
+BENCHMARK(BM_TscToNanos);
+
+void BM_TscToEpochNs(benchmark::State& state) {
+    pin_bench_thread(0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Timer::tsc_to_epoch_ns(Timer::rdtsc()));
+    }
+}
+BENCHMARK(BM_TscToEpochNs);
+
+void BM_ChronoNanosSinceEpoch(benchmark::State& state) {
+    pin_bench_thread(0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Timer::nanos_since_epoch());
+    }
+}
+BENCHMARK(BM_ChronoNanosSinceEpoch);
+
+void BM_ScopedTimerIntoHistogram(benchmark::State& state) {
+    pin_bench_thread(0);
+    auto histogram = std::make_unique<Histogram>();
+    for (auto _ : state) {
+        ScopedTimer timer(*histogram);
+    }
+}
+BENCHMARK(BM_ScopedTimerIntoHistogram);
+
+} // namespace
+
+BENCHMARK_MAIN();
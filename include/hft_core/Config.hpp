@@ -1,16 +1,232 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
-#include <fstream>
 #include <mutex>
+#include <optional>
+#include <type_traits>
 #include <variant>
 #include <vector>
 
+#include "hft_core/ThreadBinding.hpp"
+
 namespace hft::core {
 
-using ConfigValue = std::variant<std::string, int, double, bool>;
+// Integers parse as int when they fit, otherwise int64_t / uint64_t.
+// Durations are written with a unit (500us, 2ms, 1.5s; ns, us, ms, s, min,
+// h). Lists are [a, b, c]: all-integer lists are int64_t, numeric ones
+// double, anything else strings.
+using ConfigValue = std::variant<std::string, int, double, bool,
+                                 int64_t, uint64_t, std::chrono::nanoseconds,
+                                 std::vector<int64_t>, std::vector<double>,
+                                 std::vector<std::string>>;
+using ConfigValues = std::unordered_map<std::string, ConfigValue>;
+
+// One key's difference between two versions.
+struct ConfigChange {
+    std::string key;
+    std::optional<ConfigValue> old_value;   // Empty if the key was added
+    std::optional<ConfigValue> new_value;   // Empty if the key was removed
+};
+
+namespace detail {
+
+template<typename T, typename Variant>
+struct is_config_alternative;
+
+template<typename T, typename... Types>
+struct is_config_alternative<T, std::variant<Types...>>
+    : std::bool_constant<(std::is_same_v<T, Types> || ...)> {};
+
+template<typename T>
+inline constexpr bool is_config_type_v = is_config_alternative<T, ConfigValue>::value;
+
+template<typename T>
+inline constexpr bool is_config_integer_v = std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+template<typename T>
+inline constexpr bool is_config_list_v = std::is_same_v<T, std::vector<int64_t>> ||
+                                         std::is_same_v<T, std::vector<double>> ||
+                                         std::is_same_v<T, std::vector<std::string>>;
+
+template<typename To, typename From>
+constexpr bool integer_fits(From value) noexcept {
+    if constexpr (std::is_signed_v<From> == std::is_signed_v<To>) {
+        return value >= std::numeric_limits<To>::min() && value <= std::numeric_limits<To>::max();
+    } else if constexpr (std::is_signed_v<From>) {
+        return value >= 0 && static_cast<std::make_unsigned_t<From>>(value) <= std::numeric_limits<To>::max();
+    } else {
+        return value <= static_cast<std::make_unsigned_t<To>>(std::numeric_limits<To>::max());
+    }
+}
+
+// Reads `value` as T: the exact alternative, or a lossless conversion
+// between the integer types, integer to double, and integer list to double
+// list. An empty list reads as any list type.
+template<typename T>
+bool config_value_as(const ConfigValue& value, T& out) {
+    if (const T* exact = std::get_if<T>(&value)) {
+        out = *exact;
+        return true;
+    }
+    return std::visit([&out](const auto& v) {
+        using V = std::decay_t<decltype(v)>;
+        if constexpr (is_config_integer_v<T> && is_config_integer_v<V>) {
+            if (integer_fits<T>(v)) {
+                out = static_cast<T>(v);
+                return true;
+            }
+        } else if constexpr (std::is_same_v<T, double> && is_config_integer_v<V>) {
+            out = static_cast<double>(v);
+            return true;
+        } else if constexpr (std::is_same_v<T, std::vector<double>> && std::is_same_v<V, std::vector<int64_t>>) {
+            out.assign(v.begin(), v.end());
+            return true;
+        } else if constexpr (is_config_list_v<T> && is_config_list_v<V>) {
+            if (v.empty()) {
+                out.clear();
+                return true;
+            }
+        }
+        return false;
+    }, value);
+}
+
+} // namespace detail
+
+class Config;
+
+// One immutable version of the configuration. Every load_from_file(), set()
+// and remove() publishes a new snapshot; existing ones never change.
+// Lookups take a string_view and go through a flat index built at publish,
+// so no std::string is constructed per read.
+class ConfigSnapshot {
+public:
+    ConfigSnapshot() = default;
 
+    // The index points into values_, so a copy builds its own.
+    ConfigSnapshot(const ConfigSnapshot& other)
+        : version_(other.version_), values_(other.values_), slots_(other.slots_) {
+        build_index();
+    }
+
+    ConfigSnapshot& operator=(const ConfigSnapshot&) = delete;
+
+    uint64_t version() const noexcept {
+        return version_;
+    }
+
+    template<typename T>
+    T get(std::string_view key, const T& default_value = T{}) const {
+        static_assert(detail::is_config_type_v<T>, "T must be one of the ConfigValue alternatives");
+        const ConfigValue* value = find(key);
+        T result;
+        if (value && detail::config_value_as(*value, result)) {
+            return result;
+        }
+        return default_value;
+    }
+
+    bool has(std::string_view key) const noexcept {
+        return find(key) != nullptr;
+    }
+
+    // nullptr if the key is not set.
+    const ConfigValue* find(std::string_view key) const noexcept {
+        if (index_.empty()) {
+            return nullptr;
+        }
+        const size_t hash = std::hash<std::string_view>{}(key);
+        const size_t mask = index_.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            const IndexEntry& entry = index_[i];
+            if (!entry.item) {
+                return nullptr;
+            }
+            if (entry.hash == hash && entry.item->first == key) {
+                return &entry.item->second;
+            }
+        }
+    }
+
+    const ConfigValues& values() const noexcept {
+        return values_;
+    }
+
+private:
+    friend class Config;
+    template<typename T> friend class ConfigHandle;
+
+    struct IndexEntry {
+        size_t hash = 0;
+        const ConfigValues::value_type* item = nullptr;
+    };
+
+    // Open addressing at <= 50% load over the (node-stable) map entries.
+    void build_index() {
+        index_.clear();
+        if (values_.empty()) {
+            return;
+        }
+        size_t size = 2;
+        while (size < values_.size() * 2) {
+            size <<= 1;
+        }
+        index_.resize(size);
+        for (const auto& item : values_) {
+            const size_t hash = std::hash<std::string_view>{}(item.first);
+            size_t i = hash & (size - 1);
+            while (index_[i].item) {
+                i = (i + 1) & (size - 1);
+            }
+            index_[i] = IndexEntry{hash, &item};
+        }
+    }
+
+    uint64_t version_ = 0;
+    ConfigValues values_;
+    std::vector<IndexEntry> index_;
+    std::vector<ConfigValue> slots_;    // Per-handle values, resolved at publish
+};
+
+// Typed, pre-resolved view of one key for hot paths. get() is one atomic
+// load of the current snapshot plus an indexed read: no lock, no hashing,
+// no exceptions. The default applies while the key is missing or holds a
+// type that does not convert (see ConfigSnapshot::get). Handles are cheap
+// to copy and valid as long as their Config.
+template<typename T>
+class ConfigHandle {
+    static_assert(detail::is_config_type_v<T>, "ConfigHandle type must be one of the ConfigValue alternatives");
+
+public:
+    T get() const noexcept(std::is_nothrow_copy_constructible_v<T>);
+
+    T operator*() const noexcept(std::is_nothrow_copy_constructible_v<T>) {
+        return get();
+    }
+
+private:
+    friend class Config;
+
+    ConfigHandle(const Config* config, size_t slot) noexcept : config_(config), slot_(slot) {}
+
+    const Config* config_;
+    size_t slot_;
+};
+
+// Readers never lock: they load the current snapshot through an atomic
+// pointer. Writers serialize on a mutex, copy the current snapshot, apply
+// their change and publish the copy (RCU). Retired snapshots are kept until
+// the Config is destroyed, so a reader can never see one freed under it;
+// each update costs a copy of the table, which suits settings that change
+// rarely. instance() is the process-wide default; independent instances
+// can be created, e.g. one per pinned pipeline, and bound to its threads.
 class Config {
 public:
     static Config& instance() {
@@ -18,162 +234,222 @@ public:
         return config;
     }
 
+    // The calling thread's bound Config (see ThreadBinding), else instance().
+    static Config& current() {
+        Config*& bound = thread_bound();
+        if (__builtin_expect(bound == nullptr, 0)) {
+            bound = &instance();
+        }
+        return *bound;
+    }
+
+    // Binds `config` to the calling thread (nullptr: back to instance()) and
+    // returns the previous binding.
+    static Config* bind_thread(Config* config) noexcept {
+        Config*& bound = thread_bound();
+        Config* previous = bound;
+        bound = config;
+        return previous;
+    }
+
+    Config() {
+        retired_.push_back(std::make_unique<ConfigSnapshot>());
+        current_.store(retired_.back().get(), std::memory_order_release);
+    }
+
+    Config(const Config&) = delete;
+    Config& operator=(const Config&) = delete;
+
+    // Applies every entry in the file as one new version.
     bool load_from_file(const std::string& filename) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        std::ifstream file(filename);
-        if (!file.is_open()) {
+        ConfigValues values;
+        if (!parse_file(filename, values)) {
             return false;
         }
+        apply(values);
+        return true;
+    }
 
-        std::string line;
-        while (std::getline(file, line)) {
-            if (line.empty() || line[0] == '#') {
-                continue;
+    // Sets `values` and erases `removed` as one version, skipping entries
+    // that already match. Returns what changed; nothing is published if
+    // that is empty.
+    std::vector<ConfigChange> apply(const ConfigValues& values,
+                                    const std::vector<std::string>& removed = {}) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        const ConfigSnapshot& current = snapshot();
+        std::vector<ConfigChange> changes;
+        for (const auto& [key, value] : values) {
+            const ConfigValue* existing = current.find(key);
+            if (!existing) {
+                changes.push_back(ConfigChange{key, std::nullopt, value});
+            } else if (!(*existing == value)) {
+                changes.push_back(ConfigChange{key, *existing, value});
+            }
+        }
+        for (const auto& key : removed) {
+            const ConfigValue* existing = current.find(key);
+            if (existing && values.find(key) == values.end()) {
+                changes.push_back(ConfigChange{key, *existing, std::nullopt});
             }
+        }
+        if (changes.empty()) {
+            return changes;
+        }
 
-            size_t pos = line.find('=');
-            if (pos == std::string::npos) {
-                continue;
+        auto next = copy_current();
+        for (const auto& change : changes) {
+            if (change.new_value) {
+                next->values_[change.key] = *change.new_value;
+            } else {
+                next->values_.erase(change.key);
             }
+        }
+        publish(std::move(next));
+        return changes;
+    }
 
-            std::string key = trim(line.substr(0, pos));
-            std::string value = trim(line.substr(pos + 1));
+    // Reads `filename` into `values` without touching any Config. The file
+    // is read into one buffer and parsed in place with std::from_chars.
+    static bool parse_file(const std::string& filename, ConfigValues& values);
 
-            // Remove quotes if present
-            if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
-                value = value.substr(1, value.size() - 2);
-            }
+    // Parses one value as written in a config file (quotes mark a string).
+    static ConfigValue parse_value(std::string_view text);
 
-            config_map_[key] = parse_value(value);
-        }
+    // The config-file spelling of `value`; parse_value() reads it back.
+    static std::string format_value(const ConfigValue& value);
 
-        return true;
+    template<typename T>
+    T get(std::string_view key, const T& default_value = T{}) const {
+        return snapshot().get<T>(key, default_value);
     }
 
+    // Binds to `key` once; see ConfigHandle. Handles for the same key, type
+    // and default share a slot.
     template<typename T>
-    T get(const std::string& key, const T& default_value = T{}) const {
+    ConfigHandle<T> handle(std::string_view key, const T& default_value = T{}) {
+        static_assert(detail::is_config_type_v<T>, "T must be one of the ConfigValue alternatives");
         std::lock_guard<std::mutex> lock(mutex_);
-        
-        auto it = config_map_.find(key);
-        if (it == config_map_.end()) {
-            return default_value;
-        }
 
-        try {
-            return std::get<T>(it->second);
-        } catch (const std::bad_variant_access&) {
-            return default_value;
+        const ConfigValue fallback(default_value);
+        for (size_t i = 0; i < slot_specs_.size(); ++i) {
+            if (slot_specs_[i].key == key && slot_specs_[i].fallback == fallback) {
+                return ConfigHandle<T>(this, i);
+            }
         }
+
+        slot_specs_.push_back(SlotSpec{std::string(key), fallback});
+        publish(copy_current());
+        return ConfigHandle<T>(this, slot_specs_.size() - 1);
     }
 
     template<typename T>
     void set(const std::string& key, const T& value) {
         std::lock_guard<std::mutex> lock(mutex_);
-        config_map_[key] = value;
+        auto next = copy_current();
+        next->values_[key] = value;
+        publish(std::move(next));
     }
 
-    bool has(const std::string& key) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return config_map_.find(key) != config_map_.end();
+    bool has(std::string_view key) const {
+        return snapshot().has(key);
     }
 
     void remove(const std::string& key) {
         std::lock_guard<std::mutex> lock(mutex_);
-        config_map_.erase(key);
+        if (!snapshot().has(key)) {
+            return;
+        }
+        auto next = copy_current();
+        next->values_.erase(key);
+        publish(std::move(next));
+    }
+
+    // The current version. The reference stays valid for the Config's
+    // lifetime, so a caller can read several keys from one consistent view.
+    const ConfigSnapshot& snapshot() const noexcept {
+        return *current_.load(std::memory_order_acquire);
+    }
+
+    uint64_t version() const noexcept {
+        return snapshot().version();
     }
 
     std::vector<std::string> get_keys() const {
-        std::lock_guard<std::mutex> lock(mutex_);
+        const ConfigSnapshot& current = snapshot();
         std::vector<std::string> keys;
-        keys.reserve(config_map_.size());
-        
-        for (const auto& pair : config_map_) {
+        keys.reserve(current.values_.size());
+
+        for (const auto& pair : current.values_) {
             keys.push_back(pair.first);
         }
-        
+
         return keys;
     }
 
-    bool save_to_file(const std::string& filename) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        std::ofstream file(filename);
-        if (!file.is_open()) {
-            return false;
-        }
+    bool save_to_file(const std::string& filename) const;
 
-        for (const auto& [key, value] : config_map_) {
-            file << key << "=";
-            
-            std::visit([&file](const auto& v) {
-                if constexpr (std::is_same_v<std::decay_t<decltype(v)>, std::string>) {
-                    file << "\"" << v << "\"";
-                } else {
-                    file << v;
-                }
-            }, value);
-            
-            file << "\n";
-        }
+private:
+    template<typename T> friend class ConfigHandle;
 
-        return true;
-    }
+    struct SlotSpec {
+        std::string key;
+        ConfigValue fallback;           // Also fixes the slot's type
+    };
 
-private:
-    Config() = default;
+    static Config*& thread_bound() noexcept {
+        static thread_local Config* bound = nullptr;
+        return bound;
+    }
 
-    std::string trim(const std::string& str) {
-        size_t start = str.find_first_not_of(" \t\r\n");
-        if (start == std::string::npos) {
-            return "";
-        }
-        
-        size_t end = str.find_last_not_of(" \t\r\n");
-        return str.substr(start, end - start + 1);
+    std::unique_ptr<ConfigSnapshot> copy_current() const {
+        return std::make_unique<ConfigSnapshot>(snapshot());
     }
 
-    ConfigValue parse_value(const std::string& value) {
-        // Try to parse as boolean
-        if (value == "true" || value == "TRUE") {
-            return true;
-        }
-        if (value == "false" || value == "FALSE") {
-            return false;
+    // Caller holds mutex_.
+    void publish(std::unique_ptr<ConfigSnapshot> next) {
+        next->version_ = snapshot().version_ + 1;
+        next->build_index();
+        next->slots_.clear();
+        next->slots_.reserve(slot_specs_.size());
+        for (const auto& spec : slot_specs_) {
+            const ConfigValue* value = next->find(spec.key);
+            next->slots_.push_back(std::visit([value](const auto& fallback) -> ConfigValue {
+                std::decay_t<decltype(fallback)> resolved;
+                if (value && detail::config_value_as(*value, resolved)) {
+                    return ConfigValue(std::move(resolved));
+                }
+                return ConfigValue(fallback);
+            }, spec.fallback));
         }
 
-        // Try to parse as integer
-        try {
-            size_t pos;
-            int int_val = std::stoi(value, &pos);
-            if (pos == value.length()) {
-                return int_val;
-            }
-        } catch (...) {}
-
-        // Try to parse as double
-        try {
-            size_t pos;
-            double double_val = std::stod(value, &pos);
-            if (pos == value.length()) {
-                return double_val;
-            }
-        } catch (...) {}
-
-        // Default to string
-        return value;
+        current_.store(next.get(), std::memory_order_release);
+        retired_.push_back(std::move(next));
     }
 
-    mutable std::mutex mutex_;
-    std::unordered_map<std::string, ConfigValue> config_map_;
+    mutable std::mutex mutex_;          // Serializes writers only
+    std::atomic<const ConfigSnapshot*> current_{nullptr};
+    std::vector<std::unique_ptr<ConfigSnapshot>> retired_;     // Owns every version, current included
+    std::vector<SlotSpec> slot_specs_;
 };
 
-// Convenience macros for configuration access
-#define CONFIG_GET_STRING(key, default_val) hft::core::Config::instance().get<std::string>(key, default_val)
-#define CONFIG_GET_INT(key, default_val) hft::core::Config::instance().get<int>(key, default_val)
-#define CONFIG_GET_DOUBLE(key, default_val) hft::core::Config::instance().get<double>(key, default_val)
-#define CONFIG_GET_BOOL(key, default_val) hft::core::Config::instance().get<bool>(key, default_val)
+template<typename T>
+T ConfigHandle<T>::get() const noexcept(std::is_nothrow_copy_constructible_v<T>) {
+    const ConfigSnapshot* current = config_->current_.load(std::memory_order_acquire);
+    return *std::get_if<T>(&current->slots_[slot_]);
+}
+
+// Convenience macros for configuration access, on the calling thread's
+// current Config
+#define CONFIG_GET_STRING(key, default_val) hft::core::Config::current().get<std::string>(key, default_val)
+#define CONFIG_GET_INT(key, default_val) hft::core::Config::current().get<int>(key, default_val)
+#define CONFIG_GET_INT64(key, default_val) hft::core::Config::current().get<int64_t>(key, default_val)
+#define CONFIG_GET_UINT64(key, default_val) hft::core::Config::current().get<uint64_t>(key, default_val)
+#define CONFIG_GET_DOUBLE(key, default_val) hft::core::Config::current().get<double>(key, default_val)
+#define CONFIG_GET_BOOL(key, default_val) hft::core::Config::current().get<bool>(key, default_val)
+#define CONFIG_GET_DURATION(key, default_val) \
+    hft::core::Config::current().get<std::chrono::nanoseconds>(key, default_val)
 
-#define CONFIG_SET(key, value) hft::core::Config::instance().set(key, value)
+#define CONFIG_SET(key, value) hft::core::Config::current().set(key, value)
 
-} // namespace hft::core
\ No newline at end of file
+} // namespace hft::core
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "hft_core/Config.hpp"
+#include "hft_core/EventBus.hpp"
+
+namespace hft::core {
+
+// Published once per changed key, after the reload that changed it has been
+// applied: a handler that reads the Config (or a ConfigHandle) sees the new
+// value.
+DECLARE_EVENT(ConfigChanged) {
+public:
+    explicit ConfigChanged(ConfigChange change)
+        : key(std::move(change.key)),
+          old_value(std::move(change.old_value)),
+          new_value(std::move(change.new_value)) {}
+
+    bool added() const noexcept { return !old_value.has_value(); }
+    bool removed() const noexcept { return !new_value.has_value(); }
+
+    std::string key;
+    std::optional<ConfigValue> old_value;
+    std::optional<ConfigValue> new_value;
+};
+
+struct ConfigWatcherOptions {
+    std::chrono::milliseconds settle{20};           // Quiet time after the last write before re-reading
+    std::chrono::milliseconds poll_interval{200};   // mtime polling where inotify is unavailable
+    bool remove_missing = true;     // Keys dropped from the file are removed from the Config
+    bool publish_events = true;     // Publish ConfigChanged on the EventBus
+};
+
+// Re-reads a config file whenever it is written or replaced (inotify on the
+// containing directory, so editors that save via rename are seen too) and
+// applies the difference as one Config version. Keys that only ever came
+// from set() are left alone. Hot-path readers are never blocked: the new
+// version is published through Config's snapshot pointer. Events are
+// published from the watcher thread.
+class ConfigWatcher {
+public:
+    explicit ConfigWatcher(std::string filename, ConfigWatcherOptions options = {},
+                           Config& config = Config::current(),
+                           EventBus& bus = EventBus::current());
+    ~ConfigWatcher();
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    // Loads the file, then watches it from a background thread. Throws
+    // std::logic_error if already running and std::system_error if the
+    // watch cannot be set up.
+    void start();
+    void stop();
+
+    bool running() const noexcept {
+        return running_.load(std::memory_order_acquire);
+    }
+
+    // Re-reads the file now. Returns what changed (already applied and
+    // published); empty if nothing did or the file could not be read.
+    std::vector<ConfigChange> reload();
+
+    uint64_t reload_count() const noexcept {
+        return reloads_.load(std::memory_order_relaxed);
+    }
+
+    // Reads that failed, e.g. while the file was briefly missing.
+    uint64_t failure_count() const noexcept {
+        return failures_.load(std::memory_order_relaxed);
+    }
+
+    const std::string& filename() const noexcept {
+        return filename_;
+    }
+
+private:
+    void run();
+
+    std::string filename_;
+    ConfigWatcherOptions options_;
+    Config& config_;
+    EventBus& bus_;
+
+    std::mutex reload_mutex_;
+    std::vector<std::string> file_keys_;    // Keys in the last successful read
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::mutex stop_mutex_;                 // Polling fallback only
+    std::condition_variable stop_cv_;
+    int inotify_fd_ = -1;
+    int wake_fd_ = -1;
+
+    std::atomic<uint64_t> reloads_{0};
+    std::atomic<uint64_t> failures_{0};
+};
+
+} // namespace hft::core
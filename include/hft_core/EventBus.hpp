@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include <vector>
 #include <unordered_map>
@@ -8,24 +9,58 @@
 #include <mutex>
 #include <shared_mutex>
 #include <atomic>
-#include <queue>
 #include <thread>
 #include <condition_variable>
 #include <chrono>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+
+#include "hft_core/IpcTransport.hpp"
+#include "hft_core/Journal.hpp"
+#include "hft_core/MemoryPool.hpp"
+#include "hft_core/RingBuffer.hpp"
+#include "hft_core/Span.hpp"
+#include "hft_core/ThreadBinding.hpp"
+#include "hft_core/ThreadPool.hpp"
+#include "hft_core/Timer.hpp"
+#include "hft_core/Trace.hpp"
 
 namespace hft::core {
 
+enum class TimestampSource {
+    Chrono,     // Nanoseconds since epoch from high_resolution_clock
+    Tsc         // Raw Timer::rdtsc() ticks
+};
+
 class Event {
 public:
     virtual ~Event() = default;
     uint64_t timestamp = 0;
     std::type_index type_id;
+
+    static void set_timestamp_source(TimestampSource source) noexcept {
+        timestamp_source_.store(source, std::memory_order_relaxed);
+    }
+
+    static TimestampSource timestamp_source() noexcept {
+        return timestamp_source_.load(std::memory_order_relaxed);
+    }
     
 protected:
-    Event(std::type_index tid) : type_id(tid) {
-        timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+    Event(std::type_index tid) : timestamp(current_timestamp()), type_id(tid) {}
+
+private:
+    static uint64_t current_timestamp() noexcept {
+        if (timestamp_source_.load(std::memory_order_relaxed) == TimestampSource::Tsc) {
+            return Timer::rdtsc();
+        }
+        return Timer::nanos_since_epoch();
     }
+
+    inline static std::atomic<TimestampSource> timestamp_source_{TimestampSource::Chrono};
 };
 
 template<typename T>
@@ -34,10 +69,37 @@ public:
     TypedEvent() : Event(std::type_index(typeid(T))) {}
 };
 
+namespace detail {
+
+template<typename T, typename = void>
+struct has_trace_id : std::false_type {};
+
+template<typename T>
+struct has_trace_id<T, std::void_t<decltype(std::declval<const T&>().trace_id())>>
+    : std::true_type {};
+
+// Payload of the event probes, so a reader can follow one event from
+// publish to its handlers: trace_id() if the type has one, otherwise the
+// Event construction timestamp (which survives the copy into async queues).
+template<typename EventType>
+uint64_t event_trace_id(const EventType& event) noexcept {
+    if constexpr (has_trace_id<EventType>::value) {
+        return static_cast<uint64_t>(event.trace_id());
+    } else if constexpr (std::is_base_of_v<Event, EventType>) {
+        return event.timestamp;
+    } else {
+        return reinterpret_cast<uintptr_t>(&event);
+    }
+}
+
+} // namespace detail
+
 class IEventHandler {
 public:
     virtual ~IEventHandler() = default;
     virtual void handle(const Event& event) = 0;
+    // events points to count contiguous objects of get_event_type()
+    virtual void handle_batch(const void* events, size_t count) = 0;
     virtual std::type_index get_event_type() const = 0;
 };
 
@@ -48,8 +110,25 @@ public:
     
     explicit EventHandler(HandlerFunc handler) : handler_(std::move(handler)) {}
     
+    // Plain (non-Event) types are always dispatched through handle_batch().
     void handle(const Event& event) override {
-        handler_(static_cast<const EventType&>(event));
+        if constexpr (std::is_base_of_v<Event, EventType>) {
+            const auto& typed = static_cast<const EventType&>(event);
+            HFT_TRACE_SCOPE(TraceProbe::EventHandlerBegin, TraceProbe::EventHandlerEnd,
+                            detail::event_trace_id(typed));
+            handler_(typed);
+        } else {
+            (void)event;
+        }
+    }
+
+    void handle_batch(const void* events, size_t count) override {
+        const auto* typed = static_cast<const EventType*>(events);
+        for (size_t i = 0; i < count; ++i) {
+            HFT_TRACE_SCOPE(TraceProbe::EventHandlerBegin, TraceProbe::EventHandlerEnd,
+                            detail::event_trace_id(typed[i]));
+            handler_(typed[i]);
+        }
     }
     
     std::type_index get_event_type() const override {
@@ -60,19 +139,365 @@ private:
     HandlerFunc handler_;
 };
 
-class EventBus {
+template<typename EventType>
+class BatchEventHandler : public IEventHandler {
+public:
+    using HandlerFunc = std::function<void(Span<const EventType>)>;
+
+    explicit BatchEventHandler(HandlerFunc handler) : handler_(std::move(handler)) {}
+
+    void handle(const Event& event) override {
+        if constexpr (std::is_base_of_v<Event, EventType>) {
+            const auto& typed = static_cast<const EventType&>(event);
+            HFT_TRACE_SCOPE(TraceProbe::EventHandlerBegin, TraceProbe::EventHandlerEnd,
+                            detail::event_trace_id(typed));
+            handler_(Span<const EventType>(&typed, 1));
+        } else {
+            (void)event;
+        }
+    }
+
+    // Traced as one handler call under the id of the first event.
+    void handle_batch(const void* events, size_t count) override {
+        const auto* typed = static_cast<const EventType*>(events);
+        HFT_TRACE_SCOPE(TraceProbe::EventHandlerBegin, TraceProbe::EventHandlerEnd,
+                        detail::event_trace_id(typed[0]));
+        handler_(Span<const EventType>(typed, count));
+    }
+
+    std::type_index get_event_type() const override {
+        return std::type_index(typeid(EventType));
+    }
+
+private:
+    HandlerFunc handler_;
+};
+
+enum class ProducerMode {
+    Single,     // Exactly one publishing thread: SPSC transport
+    Multi       // Any thread may publish: MPSC transport
+};
+
+struct AsyncOptions {
+    size_t queue_capacity = 4096;       // Per worker
+    ProducerMode producer_mode = ProducerMode::Multi;
+    WaitStrategy wait_strategy = WaitStrategy::Block;
+    uint32_t spin_budget = 2048;
+    size_t worker_count = 1;
+    std::vector<int> worker_cpus;       // Worker i is pinned to worker_cpus[i % size()]
+    size_t max_batch = 64;              // Queue slots drained per handler lookup
+};
+
+struct AsyncStats {
+    uint64_t dispatched = 0;            // Every event delivered: inline + pooled + batched
+    uint64_t inline_events = 0;
+    uint64_t pooled_events = 0;
+    uint64_t batched_events = 0;        // Delivered through publish_batch() chunks
+    uint64_t drains = 0;                // Non-empty batch drains by the workers
+};
+
+namespace detail {
+
+inline constexpr size_t kEventPoolInitialSize = 64;
+
+// Per-type storage for events too large to live inline in a queue slot.
+// Intentionally never destroyed: queued events may outlive any static
+// destruction order we could arrange with the EventBus singleton.
+template<typename EventType>
+LockFreeMemoryPool<EventType>& event_pool() {
+    static auto* pool = new LockFreeMemoryPool<EventType>(kEventPoolInitialSize);
+    return *pool;
+}
+
+inline constexpr size_t kBatchChunkEvents = 32;
+inline constexpr size_t kBatchPoolInitialSize = 8;
+
+// Contiguous storage for up to kBatchChunkEvents events of one type; the
+// events start at offset 0 so the chunk address is also the array address.
+template<typename EventType>
+struct EventBatch {
+    alignas(EventType) unsigned char storage[kBatchChunkEvents * sizeof(EventType)];
+};
+
+template<typename EventType>
+LockFreeMemoryPool<EventBatch<EventType>>& batch_pool() {
+    static auto* pool = new LockFreeMemoryPool<EventBatch<EventType>>(kBatchPoolInitialSize);
+    return *pool;
+}
+
+template<typename EventType>
+void release_inline_event(void* data, size_t) noexcept {
+    static_cast<EventType*>(data)->~EventType();
+}
+
+template<typename EventType>
+void release_pooled_event(void* data, size_t) noexcept {
+    auto* typed = static_cast<EventType*>(data);
+    typed->~EventType();
+    event_pool<EventType>().deallocate(typed);
+}
+
+template<typename EventType>
+void release_event_batch(void* data, size_t count) noexcept {
+    auto* typed = static_cast<EventType*>(data);
+    for (size_t i = 0; i < count; ++i) {
+        typed[i].~EventType();
+    }
+    batch_pool<EventType>().deallocate(static_cast<EventBatch<EventType>*>(data));
+}
+
+struct BatchTag {};
+
+// One slot of the async transport. Events up to kInlineEventSize bytes are
+// copied straight into the slot; larger ones are placed in event_pool<T>(),
+// and publish_batch() chunks in batch_pool<T>(). None of the paths touches
+// the global allocator once the pools are warm.
+class alignas(kCacheLineSize) AsyncEventSlot {
+public:
+    static constexpr size_t kInlineEventSize = 96;
+
+    enum class Storage : uint8_t { Inline, Pooled, Batch };
+
+    template<typename EventType>
+    explicit AsyncEventSlot(const EventType& event)
+        : type_(&typeid(EventType)), count_(1) {
+        if constexpr (sizeof(EventType) <= kInlineEventSize &&
+                      alignof(EventType) <= alignof(std::max_align_t)) {
+            data_ = new (storage_) EventType(event);
+            release_ = &release_inline_event<EventType>;
+            storage_kind_ = Storage::Inline;
+        } else {
+            auto& pool = event_pool<EventType>();
+            EventType* storage = pool.allocate();
+            try {
+                data_ = new (storage) EventType(event);
+            } catch (...) {
+                pool.deallocate(storage);
+                throw;
+            }
+            release_ = &release_pooled_event<EventType>;
+            storage_kind_ = Storage::Pooled;
+        }
+    }
+
+    template<typename EventType>
+    AsyncEventSlot(BatchTag, const EventType* events, size_t count)
+        : type_(&typeid(EventType)), count_(static_cast<uint32_t>(count)) {
+        auto& pool = batch_pool<EventType>();
+        auto* batch = pool.allocate();
+        auto* typed = reinterpret_cast<EventType*>(batch->storage);
+        size_t constructed = 0;
+        try {
+            for (; constructed < count; ++constructed) {
+                new (typed + constructed) EventType(events[constructed]);
+            }
+        } catch (...) {
+            release_event_batch<EventType>(batch, constructed);
+            throw;
+        }
+        data_ = typed;
+        release_ = &release_event_batch<EventType>;
+        storage_kind_ = Storage::Batch;
+    }
+
+    AsyncEventSlot(const AsyncEventSlot&) = delete;
+    AsyncEventSlot& operator=(const AsyncEventSlot&) = delete;
+
+    ~AsyncEventSlot() {
+        release_(data_, count_);
+    }
+
+    std::type_index type() const noexcept {
+        return std::type_index(*type_);
+    }
+
+    // count() contiguous events of type()
+    const void* data() const noexcept {
+        return data_;
+    }
+
+    size_t count() const noexcept {
+        return count_;
+    }
+
+    Storage storage() const noexcept {
+        return storage_kind_;
+    }
+
+private:
+    alignas(std::max_align_t) unsigned char storage_[kInlineEventSize];
+    void* data_;
+    void (*release_)(void*, size_t) noexcept;
+    const std::type_info* type_;
+    uint32_t count_;
+    Storage storage_kind_;
+};
+
+// Events that expose shard_key() are routed by it automatically.
+template<typename T, typename = void>
+struct has_shard_key : std::false_type {};
+
+template<typename T>
+struct has_shard_key<T, std::void_t<decltype(std::declval<const T&>().shard_key())>>
+    : std::true_type {};
+
+// One async worker: its queue, idle waiter, thread and dispatch counters.
+class alignas(kCacheLineSize) AsyncShard {
+public:
+    explicit AsyncShard(const AsyncOptions& options) {
+        if (options.producer_mode == ProducerMode::Single) {
+            spsc_queue_ = std::make_unique<SPSCRingBuffer<AsyncEventSlot>>(options.queue_capacity);
+        } else {
+            mpsc_queue_ = std::make_unique<MPSCRingBuffer<AsyncEventSlot>>(options.queue_capacity);
+        }
+        waiter_.configure(options.wait_strategy, options.spin_budget);
+    }
+
+    template<typename... Args>
+    void enqueue(const Args&... args) {
+        if (spsc_queue_) {
+            while (!spsc_queue_->try_emplace(args...)) {
+                std::this_thread::yield();
+            }
+        } else {
+            while (!mpsc_queue_->try_emplace(args...)) {
+                std::this_thread::yield();
+            }
+        }
+        waiter_.notify();
+    }
+
+    bool empty() const noexcept {
+        return spsc_queue_ ? spsc_queue_->empty() : mpsc_queue_->empty();
+    }
+
+    // Hands up to max_count slots to dispatch(slot) in queue order.
+    template<typename Dispatch>
+    size_t drain(Dispatch&& dispatch, size_t max_count) {
+        uint64_t counts[3] = {0, 0, 0};
+        auto consume = [&dispatch, &counts](AsyncEventSlot& slot) {
+            dispatch(slot);
+            counts[static_cast<size_t>(slot.storage())] += slot.count();
+        };
+        const size_t drained = spsc_queue_ ? spsc_queue_->consume_batch(consume, max_count)
+                                           : mpsc_queue_->consume_batch(consume, max_count);
+        if (drained != 0) {
+            bump(inline_dispatched_, counts[0]);
+            bump(pooled_dispatched_, counts[1]);
+            bump(batched_dispatched_, counts[2]);
+            bump(drains_, 1);
+        }
+        return drained;
+    }
+
+    template<typename Predicate>
+    void wait(Predicate ready) {
+        waiter_.wait(ready);
+    }
+
+    void notify() noexcept {
+        waiter_.notify();
+    }
+
+    // Only while no worker is running.
+    void reset_stats() noexcept {
+        inline_dispatched_.store(0, std::memory_order_relaxed);
+        pooled_dispatched_.store(0, std::memory_order_relaxed);
+        batched_dispatched_.store(0, std::memory_order_relaxed);
+        drains_.store(0, std::memory_order_relaxed);
+    }
+
+    void add_stats(AsyncStats& stats) const noexcept {
+        stats.inline_events += inline_dispatched_.load(std::memory_order_relaxed);
+        stats.pooled_events += pooled_dispatched_.load(std::memory_order_relaxed);
+        stats.batched_events += batched_dispatched_.load(std::memory_order_relaxed);
+        stats.drains += drains_.load(std::memory_order_relaxed);
+    }
+
+    std::thread thread;
+
+private:
+    // Counters have a single writer (the worker), so no RMW is needed.
+    static void bump(std::atomic<uint64_t>& counter, uint64_t delta) noexcept {
+        if (delta != 0) {
+            counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+    }
+
+    std::unique_ptr<SPSCRingBuffer<AsyncEventSlot>> spsc_queue_;
+    std::unique_ptr<MPSCRingBuffer<AsyncEventSlot>> mpsc_queue_;
+    Waiter waiter_;
+    std::atomic<uint64_t> inline_dispatched_{0};
+    std::atomic<uint64_t> pooled_dispatched_{0};
+    std::atomic<uint64_t> batched_dispatched_{0};
+    std::atomic<uint64_t> drains_{0};
+};
+
+using AsyncShards = std::vector<std::unique_ptr<AsyncShard>>;
+
+// One attached IPC segment and the thread that dispatches from it.
+struct IpcAttachment {
+    std::unique_ptr<IpcReader> reader;
+    IpcOptions options;
+    std::thread thread;
+    std::atomic<bool> running{true};
+    std::atomic<uint64_t> unknown{0};
+};
+
+} // namespace detail
+
+// instance() is the process-wide default. Independent buses (e.g. one per
+// pinned pipeline) share no handlers, queues or locks with it; each is
+// cache-line aligned so neighbouring instances do not false-share.
+class alignas(kCacheLineSize) EventBus {
 public:
     static EventBus& instance() {
         static EventBus bus;
         return bus;
     }
 
+    // The calling thread's bound EventBus (see ThreadBinding), else instance().
+    static EventBus& current() {
+        EventBus*& bound = thread_bound();
+        if (__builtin_expect(bound == nullptr, 0)) {
+            bound = &instance();
+        }
+        return *bound;
+    }
+
+    // Binds `bus` to the calling thread (nullptr: back to instance()) and
+    // returns the previous binding.
+    static EventBus* bind_thread(EventBus* bus) noexcept {
+        EventBus*& bound = thread_bound();
+        EventBus* previous = bound;
+        bound = bus;
+        return previous;
+    }
+
+    EventBus() : async_mode_(false), shutdown_requested_(false) {}
+
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
     template<typename EventType>
     void subscribe(std::function<void(const EventType&)> handler) {
         auto typed_handler = std::make_shared<EventHandler<EventType>>(std::move(handler));
         
         std::lock_guard<std::shared_mutex> lock(handlers_mutex_);
         handlers_[std::type_index(typeid(EventType))].push_back(typed_handler);
+        register_wire_type<EventType>();
+    }
+
+    // Batch handlers receive each publish_batch() packet (in chunks of up to
+    // kBatchChunkEvents) as one span; individually published events arrive
+    // as spans of one.
+    template<typename EventType>
+    void subscribe_batch(std::function<void(Span<const EventType>)> handler) {
+        auto typed_handler = std::make_shared<BatchEventHandler<EventType>>(std::move(handler));
+
+        std::lock_guard<std::shared_mutex> lock(handlers_mutex_);
+        handlers_[std::type_index(typeid(EventType))].push_back(typed_handler);
+        register_wire_type<EventType>();
     }
 
     template<typename EventType>
@@ -81,73 +506,385 @@ public:
         handlers_.erase(std::type_index(typeid(EventType)));
     }
 
+    // In async mode events go to worker 0 unless EventType has a
+    // shard_key() member, in which case it picks the worker. With an IPC
+    // writer or a journal open, trivially copyable event types are also
+    // written to the shared-memory segment or journal file.
     template<typename EventType>
     void publish(const EventType& event) {
-        if (async_mode_.load()) {
-            auto event_copy = std::make_unique<EventType>(event);
-            
-            {
-                std::lock_guard<std::mutex> lock(queue_mutex_);
-                event_queue_.push(std::move(event_copy));
-            }
-            queue_cv_.notify_one();
+        HFT_TRACE(TraceProbe::EventPublish, detail::event_trace_id(event));
+        publish_wire(Span<const EventType>(&event, 1));
+        publish_local(event);
+    }
+
+    // Events with the same shard key are handled by the same worker, in
+    // publish order; different keys may be dispatched in parallel.
+    template<typename EventType>
+    void publish(const EventType& event, uint64_t shard_key) {
+        HFT_TRACE(TraceProbe::EventPublish, detail::event_trace_id(event));
+        publish_wire(Span<const EventType>(&event, 1));
+        if (async_mode_.load(std::memory_order_acquire)) {
+            shard_for(shard_key).enqueue(event);
         } else {
             dispatch_event(event);
         }
     }
 
+    // Publishes a packet of events with one handler lookup. In async mode the
+    // packet is copied in pooled chunks, each occupying a single queue slot.
+    // Event types with shard_key() are still routed per event when more
+    // than one worker is running, to keep per-key ordering.
+    template<typename EventType>
+    void publish_batch(Span<const EventType> events) {
+        if (events.empty()) return;
+        trace_publish(events);
+        publish_wire(events);
+
+        if (async_mode_.load(std::memory_order_acquire)) {
+            if constexpr (detail::has_shard_key<EventType>::value) {
+                if (active_shards().size() > 1) {
+                    for (const auto& event : events) {
+                        shard_for(static_cast<uint64_t>(event.shard_key())).enqueue(event);
+                    }
+                    return;
+                }
+            }
+            enqueue_batch(*active_shards().front(), events);
+        } else {
+            dispatch_batch(events);
+        }
+    }
+
+    template<typename EventType>
+    void publish_batch(Span<const EventType> events, uint64_t shard_key) {
+        if (events.empty()) return;
+        trace_publish(events);
+        publish_wire(events);
+
+        if (async_mode_.load(std::memory_order_acquire)) {
+            enqueue_batch(shard_for(shard_key), events);
+        } else {
+            dispatch_batch(events);
+        }
+    }
+
     template<typename EventType, typename... Args>
     void emit(Args&&... args) {
         EventType event(std::forward<Args>(args)...);
         publish(event);
     }
 
+    // Makes this process the writer of shared-memory segment `name` (e.g.
+    // "/md_feed"): from now on every publish of a trivially copyable event
+    // type is also copied into it. Throws std::logic_error if a writer is
+    // already open and std::system_error if the segment cannot be created.
+    void open_ipc_writer(const std::string& name, const IpcOptions& options = {}) {
+        std::lock_guard<std::mutex> lock(ipc_mutex_);
+        if (ipc_writer_owner_) {
+            throw std::logic_error("IPC writer already open");
+        }
+        ipc_writer_owner_ = std::make_unique<detail::IpcWriter>(name, options);
+        ipc_writer_.store(ipc_writer_owner_.get(), std::memory_order_release);
+    }
+
+    // Starts a thread that follows segment `name` from its current position
+    // and publishes each event to this bus's subscribers, as if published
+    // locally (async mode included), but without writing it back to IPC.
+    // Types are matched by detail::ipc_type_id(); events of types nobody
+    // here subscribes to are counted and skipped. Each reader has its own
+    // cursor and never slows the writer; one that falls a full ring behind
+    // skips ahead and counts the loss.
+    void attach_ipc_reader(const std::string& name, const IpcOptions& options = {}) {
+        auto attachment = std::make_unique<detail::IpcAttachment>();
+        attachment->reader = std::make_unique<detail::IpcReader>(name);
+        attachment->options = options;
+
+        std::lock_guard<std::mutex> lock(ipc_mutex_);
+        attachment->thread = std::thread(&EventBus::ipc_reader_loop, this, std::ref(*attachment));
+#ifdef __linux__
+        if (options.reader_cpu >= 0) {
+            try {
+                set_thread_affinity(attachment->thread, options.reader_cpu);
+            } catch (...) {
+                attachment->running.store(false, std::memory_order_release);
+                attachment->thread.join();
+                throw;
+            }
+        }
+#endif
+        ipc_readers_.push_back(std::move(attachment));
+    }
+
+    // Stops the readers and closes the writer. Must not race with publishes
+    // of IPC event types.
+    void close_ipc() {
+        std::lock_guard<std::mutex> lock(ipc_mutex_);
+        for (auto& attachment : ipc_readers_) {
+            attachment->running.store(false, std::memory_order_release);
+        }
+        for (auto& attachment : ipc_readers_) {
+            if (attachment->thread.joinable()) {
+                attachment->thread.join();
+            }
+            retired_ipc_.received += attachment->reader->received();
+            retired_ipc_.lost += attachment->reader->lost();
+            retired_ipc_.unknown += attachment->unknown.load(std::memory_order_relaxed);
+        }
+        ipc_readers_.clear();
+
+        ipc_writer_.store(nullptr, std::memory_order_release);
+        if (ipc_writer_owner_) {
+            retired_ipc_.published += ipc_writer_owner_->published();
+            ipc_writer_owner_.reset();
+        }
+    }
+
+    // Records every publish of a trivially copyable event type to `path`
+    // until close_journal(), stamped with the event's `timestamp` member if
+    // it has one and the epoch time otherwise. Throws std::logic_error if a
+    // journal is already open and std::system_error on I/O errors.
+    void open_journal(const std::string& path, const JournalOptions& options = {}) {
+        std::lock_guard<std::mutex> lock(ipc_mutex_);
+        if (journal_owner_) {
+            throw std::logic_error("event journal already open");
+        }
+        journal_owner_ = std::make_unique<JournalWriter>(path, options);
+        journal_.store(journal_owner_.get(), std::memory_order_release);
+    }
+
+    // Must not race with publishes of journaled event types.
+    void close_journal() {
+        std::lock_guard<std::mutex> lock(ipc_mutex_);
+        journal_.store(nullptr, std::memory_order_release);
+        journal_owner_.reset();
+    }
+
+    // Publishes the journal's events to this bus's subscribers from the
+    // calling thread, in recorded order, as if published locally: nothing
+    // is written back to IPC or to an open journal. Types are matched as
+    // for attach_ipc_reader(). Paced mode assumes nanosecond timestamps.
+    ReplayStats replay(JournalReader& journal, const ReplayOptions& options = {}) {
+        ReplayStats stats;
+        std::unordered_map<uint64_t, WireDecoder> known;
+        const auto started = std::chrono::steady_clock::now();
+        const bool paced = options.mode == ReplayMode::Paced && options.speed > 0;
+        uint64_t first_timestamp = 0;
+
+        JournalRecord record;
+        for (uint64_t seen = 0; seen < options.max_events && journal.next(record); ++seen) {
+            if (paced) {
+                if (seen == 0) {
+                    first_timestamp = record.timestamp;
+                }
+                // Timestamps from several publishers are journaled in lock
+                // order, not time order: earlier ones go out immediately.
+                if (record.timestamp > first_timestamp) {
+                    const double offset = std::min(
+                        static_cast<double>(record.timestamp - first_timestamp) / options.speed, 9.0e18);
+                    pace_until(started + std::chrono::nanoseconds(static_cast<int64_t>(offset)));
+                }
+            }
+
+            const WireDecoder* decoder = find_wire_decoder(record.type_id, known);
+            if (!decoder || decoder->size != record.size) {
+                ++stats.unknown;
+                continue;
+            }
+            try {
+                decoder->deliver(*this, record.data);
+            } catch (const std::exception&) {
+                // Keep replaying
+            }
+            ++stats.replayed;
+        }
+
+        stats.elapsed_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - started).count());
+        return stats;
+    }
+
+    ReplayStats replay(const std::string& path, const ReplayOptions& options = {}) {
+        JournalReader journal(path);
+        return replay(journal, options);
+    }
+
+    IpcStats ipc_stats() const {
+        std::lock_guard<std::mutex> lock(ipc_mutex_);
+        IpcStats stats = retired_ipc_;
+        if (ipc_writer_owner_) {
+            stats.published += ipc_writer_owner_->published();
+        }
+        for (const auto& attachment : ipc_readers_) {
+            stats.received += attachment->reader->received();
+            stats.lost += attachment->reader->lost();
+            stats.unknown += attachment->unknown.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
     void set_async_mode(bool async) {
-        async_mode_.store(async);
-        if (async && !worker_thread_.joinable()) {
+        if (async && !workers_running_) {
             start_worker_thread();
         }
+        async_mode_.store(async, std::memory_order_release);
+    }
+
+    // Transport settings take effect the next time the workers start.
+    void set_async_options(const AsyncOptions& options) {
+        if (workers_running_) {
+            throw std::logic_error("set_async_options while async worker is running");
+        }
+        if (options.worker_count == 0) {
+            throw std::invalid_argument("AsyncOptions::worker_count must be at least 1");
+        }
+        async_options_ = options;
+        shards_stale_ = true;
+    }
+
+    const AsyncOptions& async_options() const noexcept {
+        return async_options_;
+    }
+
+    size_t worker_count() const noexcept {
+        return workers_running_ ? active_shards().size() : 0;
+    }
+
+    // Runs handlers inside an ArenaScope over the dispatching thread's
+    // Arena, so they can take temporaries from Arena::current(). The scope
+    // covers one publish in sync mode and one drained batch in async mode.
+    void set_dispatch_arena(bool enabled) noexcept {
+        dispatch_arena_.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool dispatch_arena() const noexcept {
+        return dispatch_arena_.load(std::memory_order_relaxed);
+    }
+
+    // Counters maintained by the worker threads; safe to read at any time.
+    AsyncStats async_stats() const noexcept {
+        AsyncStats stats;
+        if (const detail::AsyncShards* shards = shards_.load(std::memory_order_acquire)) {
+            for (const auto& shard : *shards) {
+                shard->add_stats(stats);
+            }
+        }
+        stats.dispatched = stats.inline_events + stats.pooled_events + stats.batched_events;
+        return stats;
+    }
+
+    // Warms the out-of-line storage for EventType so the first burst of
+    // large events does not fall back to operator new.
+    template<typename EventType>
+    static void reserve_event_pool(size_t count) {
+        detail::event_pool<EventType>().reserve(count);
+    }
+
+    template<typename EventType>
+    static size_t event_pool_misses() noexcept {
+        return detail::event_pool<EventType>().heap_allocations();
     }
 
     void flush() {
-        if (!async_mode_.load()) return;
-        
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-        queue_cv_.wait(lock, [this] { return event_queue_.empty(); });
+        if (!workers_running_) {
+            return;
+        }
+        for (const auto& shard : active_shards()) {
+            while (!shard->empty()) {
+                std::this_thread::yield();
+            }
+        }
     }
 
+    // Shards are created on first start and whenever the options changed
+    // since; otherwise the previous ones are reused, stats reset.
     void start_worker_thread() {
-        worker_thread_ = std::thread(&EventBus::worker_loop, this);
+        if (workers_running_) {
+            return;
+        }
+        shutdown_requested_.store(false, std::memory_order_release);
+        detail::AsyncShards* shards = shards_.load(std::memory_order_relaxed);
+        if (!shards || shards_stale_) {
+            auto created = std::make_unique<detail::AsyncShards>();
+            for (size_t i = 0; i < async_options_.worker_count; ++i) {
+                created->push_back(std::make_unique<detail::AsyncShard>(async_options_));
+            }
+            shards = created.get();
+            shard_sets_.push_back(std::move(created));
+            shards_.store(shards, std::memory_order_release);
+            shards_stale_ = false;
+        } else {
+            for (auto& shard : *shards) {
+                shard->reset_stats();
+            }
+        }
+        workers_running_ = true;
+
+        for (size_t i = 0; i < shards->size(); ++i) {
+            auto& shard = *(*shards)[i];
+            shard.thread = std::thread(&EventBus::worker_loop, this, std::ref(shard));
+#ifdef __linux__
+            if (!async_options_.worker_cpus.empty()) {
+                try {
+                    set_thread_affinity(shard.thread,
+                        async_options_.worker_cpus[i % async_options_.worker_cpus.size()]);
+                } catch (...) {
+                    shutdown();
+                    throw;
+                }
+            }
+#endif
+        }
     }
 
+    // Stops and joins the workers once their queues are drained. The
+    // queues themselves stay allocated until the bus is destroyed: a
+    // publisher that saw async mode just before may still be enqueuing,
+    // and such late events are dispatched on the next start with the same
+    // options.
     void shutdown() {
-        {
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            shutdown_requested_ = true;
-        }
-        queue_cv_.notify_one();
-        
-        if (worker_thread_.joinable()) {
-            worker_thread_.join();
+        async_mode_.store(false, std::memory_order_release);
+        shutdown_requested_.store(true, std::memory_order_release);
+
+        if (detail::AsyncShards* shards = shards_.load(std::memory_order_relaxed)) {
+            for (auto& shard : *shards) {
+                shard->notify();
+                if (shard->thread.joinable()) {
+                    shard->thread.join();
+                }
+            }
         }
+        workers_running_ = false;
     }
 
     ~EventBus() {
+        close_journal();
+        close_ipc();
         shutdown();
     }
 
 private:
-    EventBus() : async_mode_(false), shutdown_requested_(false) {}
+    static EventBus*& thread_bound() noexcept {
+        static thread_local EventBus* bound = nullptr;
+        return bound;
+    }
 
     template<typename EventType>
     void dispatch_event(const EventType& event) {
+        std::optional<ArenaScope> arena_scope;
+        if (dispatch_arena_.load(std::memory_order_relaxed)) {
+            arena_scope.emplace();
+        }
         std::shared_lock<std::shared_mutex> lock(handlers_mutex_);
-        
+
         auto it = handlers_.find(std::type_index(typeid(EventType)));
         if (it != handlers_.end()) {
             for (const auto& handler : it->second) {
                 try {
-                    handler->handle(event);
+                    if constexpr (std::is_base_of_v<Event, EventType>) {
+                        handler->handle(event);
+                    } else {
+                        handler->handle_batch(&event, 1);
+                    }
                 } catch (const std::exception& e) {
                     // Log error but continue processing other handlers
                 }
@@ -155,55 +892,242 @@ private:
         }
     }
 
-    void worker_loop() {
-        while (true) {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            queue_cv_.wait(lock, [this] { 
-                return !event_queue_.empty() || shutdown_requested_; 
-            });
+    template<typename EventType>
+    void dispatch_batch(Span<const EventType> events) {
+        std::optional<ArenaScope> arena_scope;
+        if (dispatch_arena_.load(std::memory_order_relaxed)) {
+            arena_scope.emplace();
+        }
+        std::shared_lock<std::shared_mutex> lock(handlers_mutex_);
+
+        auto it = handlers_.find(std::type_index(typeid(EventType)));
+        if (it != handlers_.end()) {
+            for (const auto& handler : it->second) {
+                try {
+                    handler->handle_batch(events.data(), events.size());
+                } catch (const std::exception& e) {
+                    // Log error but continue processing other handlers
+                }
+            }
+        }
+    }
+
+    template<typename EventType>
+    void publish_local(const EventType& event) {
+        if (async_mode_.load(std::memory_order_acquire)) {
+            if constexpr (detail::has_shard_key<EventType>::value) {
+                shard_for(static_cast<uint64_t>(event.shard_key())).enqueue(event);
+            } else {
+                active_shards().front()->enqueue(event);
+            }
+        } else {
+            dispatch_event(event);
+        }
+    }
+
+    template<typename EventType>
+    void publish_wire([[maybe_unused]] Span<const EventType> events) {
+        if constexpr (detail::is_ipc_event_v<EventType>) {
+            if (auto* writer = ipc_writer_.load(std::memory_order_acquire)) {
+                for (const auto& event : events) {
+                    writer->write(detail::ipc_type_id<EventType>(), &event, sizeof(EventType));
+                }
+            }
+            if (auto* journal = journal_.load(std::memory_order_acquire)) {
+                if constexpr (detail::has_journal_timestamp<EventType>::value) {
+                    for (const auto& event : events) {
+                        journal->append(detail::ipc_type_id<EventType>(), static_cast<uint64_t>(event.timestamp),
+                                        &event, sizeof(EventType));
+                    }
+                } else {
+                    journal->append(detail::ipc_type_id<EventType>(), Timer::epoch_ns(),
+                                    events.data(), sizeof(EventType), events.size());
+                }
+            }
+        }
+    }
+
+    // Rebuilds a trivially copyable event from its bytes (IPC or journal)
+    // and publishes it locally.
+    struct WireDecoder {
+        void (*deliver)(EventBus& bus, const void* data) = nullptr;
+        size_t size = 0;
+    };
+
+    // Caller holds handlers_mutex_ exclusively.
+    template<typename EventType>
+    void register_wire_type() {
+        if constexpr (detail::is_ipc_event_v<EventType>) {
+            wire_decoders_[detail::ipc_type_id<EventType>()] =
+                WireDecoder{&EventBus::deliver_wire_event<EventType>, sizeof(EventType)};
+        }
+    }
+
+    template<typename EventType>
+    static void deliver_wire_event(EventBus& bus, const void* data) {
+        alignas(EventType) unsigned char storage[sizeof(EventType)];
+        std::memcpy(storage, data, sizeof(EventType));
+        bus.publish_local(*std::launder(reinterpret_cast<const EventType*>(storage)));
+    }
+
+    // Decoders are never removed, so callers can cache them unlocked.
+    const WireDecoder* find_wire_decoder(uint64_t type_id, std::unordered_map<uint64_t, WireDecoder>& known) {
+        auto it = known.find(type_id);
+        if (it == known.end()) {
+            std::shared_lock<std::shared_mutex> lock(handlers_mutex_);
+            auto found = wire_decoders_.find(type_id);
+            if (found == wire_decoders_.end()) {
+                return nullptr;
+            }
+            it = known.emplace(type_id, found->second).first;
+        }
+        return &it->second;
+    }
+
+    // Sleeps while the deadline is far off, then spins to it.
+    static void pace_until(std::chrono::steady_clock::time_point deadline) {
+        constexpr auto kSpinWindow = std::chrono::microseconds(200);
+        const auto now = std::chrono::steady_clock::now();
+        if (deadline - now > kSpinWindow) {
+            std::this_thread::sleep_for(deadline - now - kSpinWindow);
+        }
+        while (std::chrono::steady_clock::now() < deadline) {
+            cpu_relax();
+        }
+    }
+
+    void ipc_reader_loop(detail::IpcAttachment& attachment) {
+        std::unordered_map<uint64_t, WireDecoder> known;
+        struct Context {
+            EventBus* bus;
+            detail::IpcAttachment* attachment;
+            std::unordered_map<uint64_t, WireDecoder>* known;
+        } context{this, &attachment, &known};
 
-            if (shutdown_requested_ && event_queue_.empty()) {
-                break;
+        auto sink = [](void* opaque, uint64_t type_id, const void* data, size_t size) {
+            auto& ctx = *static_cast<Context*>(opaque);
+            const WireDecoder* decoder = ctx.bus->find_wire_decoder(type_id, *ctx.known);
+            if (!decoder || decoder->size != size) {
+                ctx.attachment->unknown.fetch_add(1, std::memory_order_relaxed);
+                return;
             }
+            try {
+                decoder->deliver(*ctx.bus, data);
+            } catch (const std::exception&) {
+                // Keep following the segment
+            }
+        };
 
-            while (!event_queue_.empty()) {
-                auto event = std::move(event_queue_.front());
-                event_queue_.pop();
-                lock.unlock();
-                
-                // Dispatch event based on its type
-                dispatch_polymorphic_event(*event);
-                
-                lock.lock();
+        while (attachment.running.load(std::memory_order_acquire)) {
+            if (attachment.reader->poll(sink, &context, 64) == 0) {
+                attachment.reader->wait(attachment.options.wait_strategy, attachment.options.spin_budget);
             }
         }
     }
 
-    void dispatch_polymorphic_event(const Event& event) {
+    template<typename EventType>
+    static void trace_publish([[maybe_unused]] Span<const EventType> events) noexcept {
+#ifdef HFT_ENABLE_TRACING
+        for (const auto& event : events) {
+            HFT_TRACE(TraceProbe::EventPublish, detail::event_trace_id(event));
+        }
+#endif
+    }
+
+    template<typename EventType>
+    static void enqueue_batch(detail::AsyncShard& shard, Span<const EventType> events) {
+        for (size_t offset = 0; offset < events.size(); offset += detail::kBatchChunkEvents) {
+            const size_t count = std::min(detail::kBatchChunkEvents, events.size() - offset);
+            shard.enqueue(detail::BatchTag{}, events.data() + offset, count);
+        }
+    }
+
+    // Valid once async mode has been enabled; a publisher that raced with
+    // shutdown() may still be using it, which is why sets are never freed
+    // before the bus.
+    const detail::AsyncShards& active_shards() const noexcept {
+        return *shards_.load(std::memory_order_acquire);
+    }
+
+    detail::AsyncShard& shard_for(uint64_t shard_key) noexcept {
+        const detail::AsyncShards& shards = active_shards();
+        return *shards[shard_key % shards.size()];
+    }
+
+    void worker_loop(detail::AsyncShard& shard) {
+        const size_t max_batch = async_options_.max_batch == 0 ? 1 : async_options_.max_batch;
+
+        while (true) {
+            if (drain_batch(shard, max_batch) != 0) {
+                continue;
+            }
+
+            if (shutdown_requested_.load(std::memory_order_acquire)) {
+                if (shard.empty()) {
+                    break;
+                }
+                continue;
+            }
+
+            shard.wait([this, &shard] {
+                return !shard.empty() || shutdown_requested_.load(std::memory_order_acquire);
+            });
+        }
+    }
+
+    // Drains up to max_batch slots under one reader lock, resolving the
+    // handler list once per run of same-typed slots.
+    size_t drain_batch(detail::AsyncShard& shard, size_t max_batch) {
+        std::optional<ArenaScope> arena_scope;
+        if (dispatch_arena_.load(std::memory_order_relaxed)) {
+            arena_scope.emplace();
+        }
         std::shared_lock<std::shared_mutex> lock(handlers_mutex_);
-        
-        auto it = handlers_.find(event.type_id);
-        if (it != handlers_.end()) {
-            for (const auto& handler : it->second) {
+
+        const std::vector<std::shared_ptr<IEventHandler>>* handlers = nullptr;
+        std::type_index current_type = typeid(void);
+
+        auto dispatch = [&](detail::AsyncEventSlot& slot) {
+            if (slot.type() != current_type) {
+                current_type = slot.type();
+                auto it = handlers_.find(current_type);
+                handlers = it != handlers_.end() ? &it->second : nullptr;
+            }
+            if (!handlers) return;
+
+            for (const auto& handler : *handlers) {
                 try {
-                    handler->handle(event);
+                    handler->handle_batch(slot.data(), slot.count());
                 } catch (const std::exception& e) {
                     // Log error but continue processing other handlers
                 }
             }
-        }
+        };
+
+        return shard.drain(dispatch, max_batch);
     }
 
     std::unordered_map<std::type_index, std::vector<std::shared_ptr<IEventHandler>>> handlers_;
     mutable std::shared_mutex handlers_mutex_;
     
-    std::queue<std::unique_ptr<Event>> event_queue_;
-    std::mutex queue_mutex_;
-    std::condition_variable queue_cv_;
-    std::thread worker_thread_;
+    AsyncOptions async_options_;
+    std::vector<std::unique_ptr<detail::AsyncShards>> shard_sets_;    // Every set started, kept until destruction
+    std::atomic<detail::AsyncShards*> shards_{nullptr};                 // The latest; reused until the options change
+    bool shards_stale_ = false;
+    bool workers_running_ = false;
     
     std::atomic<bool> async_mode_;
     std::atomic<bool> shutdown_requested_;
+    std::atomic<bool> dispatch_arena_{false};
+
+    std::unordered_map<uint64_t, WireDecoder> wire_decoders_;  // Guarded by handlers_mutex_
+    mutable std::mutex ipc_mutex_;                              // Also serialises journal open/close
+    std::atomic<detail::IpcWriter*> ipc_writer_{nullptr};
+    std::unique_ptr<detail::IpcWriter> ipc_writer_owner_;
+    std::vector<std::unique_ptr<detail::IpcAttachment>> ipc_readers_;
+    IpcStats retired_ipc_;
+    std::atomic<JournalWriter*> journal_{nullptr};
+    std::unique_ptr<JournalWriter> journal_owner_;
 };
 
 #define DECLARE_EVENT(EventName) \
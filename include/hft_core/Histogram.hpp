@@ -0,0 +1,242 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "hft_core/RingBuffer.hpp"
+
+namespace hft::core {
+
+// Log-linear bucket layout over the full uint64_t range, as in HdrHistogram.
+// Values below 256 get a bucket each; above that every power of two is split
+// into 128 equal sub-buckets, so a recorded value is reported to within
+// 1/128 (< 0.8%) of itself. 7424 buckets, fixed at compile time.
+namespace histogram_layout {
+
+inline constexpr uint32_t kSubBucketBits = 8;
+inline constexpr uint32_t kSubBucketHalfBits = kSubBucketBits - 1;
+inline constexpr uint64_t kSubBucketMask = (uint64_t(1) << kSubBucketBits) - 1;
+inline constexpr size_t kBucketCount = (64 - kSubBucketHalfBits + 1) << kSubBucketHalfBits;
+
+inline size_t index_of(uint64_t value) noexcept {
+    const uint32_t shift = 63 - static_cast<uint32_t>(__builtin_clzll(value | kSubBucketMask)) -
+                           kSubBucketHalfBits;
+    return (static_cast<size_t>(shift) << kSubBucketHalfBits) + static_cast<size_t>(value >> shift);
+}
+
+inline uint64_t lowest_value(size_t index) noexcept {
+    if (index < (size_t(1) << kSubBucketBits)) {
+        return index;
+    }
+    const uint32_t shift = static_cast<uint32_t>(index >> kSubBucketHalfBits) - 1;
+    const uint64_t sub = index - (static_cast<size_t>(shift) << kSubBucketHalfBits);
+    return sub << shift;
+}
+
+// Largest value that lands in the same bucket.
+inline uint64_t highest_value(size_t index) noexcept {
+    const uint32_t shift = index < (size_t(1) << kSubBucketBits)
+        ? 0 : static_cast<uint32_t>(index >> kSubBucketHalfBits) - 1;
+    return lowest_value(index) + ((uint64_t(1) << shift) - 1);
+}
+
+} // namespace histogram_layout
+
+class Histogram;
+
+// Plain (non-atomic) copy of one or more histograms, for queries and merging.
+class HistogramSnapshot {
+public:
+    static constexpr size_t kBucketCount = histogram_layout::kBucketCount;
+
+    uint64_t count() const noexcept { return count_; }
+    uint64_t min() const noexcept { return count_ ? min_ : 0; }
+    uint64_t max() const noexcept { return max_; }
+    uint64_t sum() const noexcept { return sum_; }
+
+    double mean() const noexcept {
+        return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0;
+    }
+
+    // Smallest recorded value v (to bucket precision) with at least
+    // q * count() samples <= v. Clamped to the exact min and max.
+    uint64_t value_at_quantile(double q) const noexcept {
+        if (count_ == 0) {
+            return 0;
+        }
+        q = std::clamp(q, 0.0, 1.0);
+        uint64_t target = static_cast<uint64_t>(q * static_cast<double>(count_) + 0.5);
+        target = std::clamp<uint64_t>(target, 1, count_);
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            seen += counts_[i];
+            if (seen >= target) {
+                return std::clamp(histogram_layout::highest_value(i), min(), max_);
+            }
+        }
+        return max_;
+    }
+
+    uint64_t p50() const noexcept { return value_at_quantile(0.50); }
+    uint64_t p99() const noexcept { return value_at_quantile(0.99); }
+    uint64_t p999() const noexcept { return value_at_quantile(0.999); }
+
+    // Samples whose bucket is the one `value` falls in.
+    uint64_t count_at(uint64_t value) const noexcept {
+        return counts_[histogram_layout::index_of(value)];
+    }
+
+    void merge(const HistogramSnapshot& other) noexcept {
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        add_totals(other.count_, other.sum_, other.min_, other.max_);
+    }
+
+    void merge(const Histogram& histogram) noexcept;
+
+    void reset() noexcept {
+        counts_.fill(0);
+        count_ = 0;
+        sum_ = 0;
+        min_ = ~uint64_t(0);
+        max_ = 0;
+    }
+
+private:
+    void add_totals(uint64_t count, uint64_t sum, uint64_t min, uint64_t max) noexcept {
+        count_ += count;
+        sum_ += sum;
+        min_ = std::min(min_, min);
+        max_ = std::max(max_, max);
+    }
+
+    std::array<uint64_t, kBucketCount> counts_{};
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = ~uint64_t(0);
+    uint64_t max_ = 0;
+};
+
+// Fixed-memory latency histogram. record() is a couple of relaxed atomic
+// adds (plus a CAS only when a new min or max shows up): no locks, no
+// allocation, and it may be called from several threads at once, though it
+// is cheapest when one thread owns it. Snapshots can be taken from any
+// thread while recording continues.
+class alignas(kCacheLineSize) Histogram {
+public:
+    static constexpr size_t kBucketCount = histogram_layout::kBucketCount;
+
+    Histogram() noexcept = default;
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    void record(uint64_t value) noexcept {
+        counts_[histogram_layout::index_of(value)].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t current = min_.load(std::memory_order_relaxed);
+        while (value < current &&
+               !min_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+        current = max_.load(std::memory_order_relaxed);
+        while (value > current &&
+               !max_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    HistogramSnapshot snapshot() const noexcept {
+        HistogramSnapshot snapshot;
+        snapshot.merge(*this);
+        return snapshot;
+    }
+
+    // Samples recorded concurrently with reset() may be lost.
+    void reset() noexcept {
+        for (auto& count : counts_) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        sum_.store(0, std::memory_order_relaxed);
+        min_.store(~uint64_t(0), std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    friend class HistogramSnapshot;
+
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> min_{~uint64_t(0)};
+    std::atomic<uint64_t> max_{0};
+    std::array<std::atomic<uint64_t>, kBucketCount> counts_{};
+};
+
+inline void HistogramSnapshot::merge(const Histogram& histogram) noexcept {
+    // The count is taken from the copied buckets so quantiles stay
+    // consistent with it even while the histogram is being written.
+    uint64_t count = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        const uint64_t n = histogram.counts_[i].load(std::memory_order_relaxed);
+        counts_[i] += n;
+        count += n;
+    }
+    if (count != 0) {
+        add_totals(count, histogram.sum_.load(std::memory_order_relaxed),
+                   histogram.min_.load(std::memory_order_relaxed),
+                   histogram.max_.load(std::memory_order_relaxed));
+    }
+}
+
+// One Histogram shard per recording thread (threads beyond the shard count
+// share shards round-robin), so concurrent recorders never contend on a
+// cache line. snapshot() merges all shards.
+class ConcurrentHistogram {
+public:
+    explicit ConcurrentHistogram(size_t shards = 0)
+        : shard_count_(shards ? shards : std::max(1u, std::thread::hardware_concurrency())),
+          shards_(std::make_unique<Histogram[]>(shard_count_)) {}
+
+    void record(uint64_t value) noexcept {
+        local().record(value);
+    }
+
+    // The calling thread's shard.
+    Histogram& local() noexcept {
+        return shards_[thread_slot() % shard_count_];
+    }
+
+    size_t shard_count() const noexcept {
+        return shard_count_;
+    }
+
+    HistogramSnapshot snapshot() const noexcept {
+        HistogramSnapshot snapshot;
+        for (size_t i = 0; i < shard_count_; ++i) {
+            snapshot.merge(shards_[i]);
+        }
+        return snapshot;
+    }
+
+    void reset() noexcept {
+        for (size_t i = 0; i < shard_count_; ++i) {
+            shards_[i].reset();
+        }
+    }
+
+private:
+    static size_t thread_slot() noexcept {
+        static std::atomic<size_t> next{0};
+        thread_local const size_t slot = next.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    size_t shard_count_;
+    std::unique_ptr<Histogram[]> shards_;
+};
+
+} // namespace hft::core
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "hft_core/RingBuffer.hpp"
+
+namespace hft::core {
+
+// Move-only void() callable stored inline in kCapacity bytes: no heap
+// allocation, ever. Callables that do not fit (or are not nothrow movable)
+// are rejected at compile time; capture pointers instead of large objects.
+class InlineTask {
+public:
+    static constexpr size_t kCapacity = 64;
+
+    template<typename F>
+    static constexpr bool fits() noexcept {
+        using Fn = std::decay_t<F>;
+        return sizeof(Fn) <= kCapacity && alignof(Fn) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<Fn>;
+    }
+
+    InlineTask() noexcept = default;
+
+    template<typename F,
+             typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InlineTask>>>
+    InlineTask(F&& f) noexcept(std::is_nothrow_constructible_v<std::decay_t<F>, F&&>) {
+        using Fn = std::decay_t<F>;
+        static_assert(fits<Fn>(), "callable does not fit in InlineTask::kCapacity bytes");
+        new (storage_) Fn(std::forward<F>(f));
+        ops_ = &kOps<Fn>;
+    }
+
+    InlineTask(InlineTask&& other) noexcept {
+        take(other);
+    }
+
+    InlineTask& operator=(InlineTask&& other) noexcept {
+        if (this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    InlineTask(const InlineTask&) = delete;
+    InlineTask& operator=(const InlineTask&) = delete;
+
+    ~InlineTask() {
+        reset();
+    }
+
+    explicit operator bool() const noexcept {
+        return ops_ != nullptr;
+    }
+
+    void operator()() {
+        ops_->invoke(storage_);
+    }
+
+    void reset() noexcept {
+        if (ops_) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void*);
+        void (*move)(void* to, void* from) noexcept;
+        void (*destroy)(void*) noexcept;
+    };
+
+    template<typename Fn>
+    static inline constexpr Ops kOps = {
+        [](void* self) { (*static_cast<Fn*>(self))(); },
+        [](void* to, void* from) noexcept {
+            new (to) Fn(std::move(*static_cast<Fn*>(from)));
+            static_cast<Fn*>(from)->~Fn();
+        },
+        [](void* self) noexcept { static_cast<Fn*>(self)->~Fn(); },
+    };
+
+    void take(InlineTask& other) noexcept {
+        if (other.ops_) {
+            other.ops_->move(storage_, other.storage_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[kCapacity];
+    const Ops* ops_ = nullptr;
+};
+
+// Join point for fire-and-forget tasks: add() before posting, count_down()
+// at the end of each task, wait() for all of them. Allocation-free; waiters
+// park on a Waiter after spinning.
+class CountdownLatch {
+public:
+    explicit CountdownLatch(size_t count = 0) noexcept : count_(count) {}
+
+    CountdownLatch(const CountdownLatch&) = delete;
+    CountdownLatch& operator=(const CountdownLatch&) = delete;
+
+    void add(size_t count = 1) noexcept {
+        count_.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void count_down(size_t count = 1) noexcept {
+        // The waiter may destroy the latch as soon as the count hits zero, so
+        // it also waits until no count_down() is still inside notify().
+        active_.fetch_add(1, std::memory_order_acquire);
+        if (count_.fetch_sub(count, std::memory_order_acq_rel) == count) {
+            waiter_.notify();
+        }
+        active_.fetch_sub(1, std::memory_order_release);
+    }
+
+    bool try_wait() const noexcept {
+        return count_.load(std::memory_order_acquire) == 0;
+    }
+
+    void wait() {
+        waiter_.wait([this] { return try_wait(); });
+        while (active_.load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    std::atomic<size_t> count_;
+    std::atomic<uint32_t> active_{0};
+    Waiter waiter_;
+};
+
+} // namespace hft::core
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+
+#include "hft_core/RingBuffer.hpp"
+
+namespace hft::core {
+
+struct IpcOptions {
+    size_t capacity = 1 << 16;          // Writer: slots, rounded up to a power of two
+    size_t max_event_size = 192;        // Writer: largest event, in bytes
+    bool unlink_on_close = true;        // Writer: remove the name when closed
+    WaitStrategy wait_strategy = WaitStrategy::Block;   // Reader: idle behaviour
+    uint32_t spin_budget = 2048;        // Reader: polls before yielding or blocking
+    int reader_cpu = -1;                // Reader: pin the dispatch thread
+};
+
+struct IpcStats {
+    uint64_t published = 0;             // Written by this process
+    uint64_t received = 0;              // Dispatched from attached segments
+    uint64_t lost = 0;                  // Overwritten before a reader got to them
+    uint64_t unknown = 0;               // Read, but no local subscriber knows the type
+};
+
+namespace detail {
+
+struct IpcSegmentHeader;
+struct IpcSlotHeader;
+
+template<typename T, typename = void>
+struct has_ipc_type_id : std::false_type {};
+
+template<typename T>
+struct has_ipc_type_id<T, std::void_t<decltype(T::ipc_type_id)>> : std::true_type {};
+
+// Plain structs cross process boundaries as raw bytes. (Event subclasses do
+// not qualify: the virtual destructor makes them non-trivially-copyable.)
+template<typename T>
+inline constexpr bool is_ipc_event_v = std::is_trivially_copyable_v<T> && !std::is_empty_v<T>;
+
+constexpr uint64_t fnv1a(const char* text, uint64_t hash = 0xcbf29ce484222325ull) noexcept {
+    for (; *text; ++text) {
+        hash = (hash ^ static_cast<unsigned char>(*text)) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// Wire id of T: `static constexpr uint64_t ipc_type_id` if the type has
+// one, otherwise a hash of the mangled name and size, which agrees between
+// processes built with the same compiler.
+template<typename T>
+uint64_t ipc_type_id() noexcept {
+    if constexpr (has_ipc_type_id<T>::value) {
+        return static_cast<uint64_t>(T::ipc_type_id);
+    } else {
+        static const uint64_t id = (fnv1a(typeid(T).name()) ^ sizeof(T)) * 0x100000001b3ull;
+        return id;
+    }
+}
+
+// Single-writer broadcast ring in a named shared-memory segment. Each slot
+// carries a sequence word: a reader accepts a slot only if the sequence it
+// expects is there before and after copying it out, so a writer that laps
+// a slow reader is detected instead of blocking on it.
+class IpcWriter {
+public:
+    // Creates (or replaces) the segment. Throws std::system_error.
+    IpcWriter(const std::string& name, const IpcOptions& options);
+    ~IpcWriter();
+
+    IpcWriter(const IpcWriter&) = delete;
+    IpcWriter& operator=(const IpcWriter&) = delete;
+
+    // Safe to call from several threads. Throws std::length_error if size
+    // exceeds max_event_size().
+    void write(uint64_t type_id, const void* data, size_t size);
+
+    size_t max_event_size() const noexcept { return max_event_size_; }
+    uint64_t published() const noexcept;
+    const std::string& name() const noexcept { return name_; }
+
+private:
+    std::string name_;
+    bool unlink_;
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    IpcSegmentHeader* header_ = nullptr;
+    char* slots_ = nullptr;
+    size_t stride_ = 0;
+    uint64_t mask_ = 0;
+    size_t max_event_size_ = 0;
+};
+
+// One cursor into a segment; starts at the writer's current position.
+class IpcReader {
+public:
+    // Called once per event with its wire id and bytes.
+    using Sink = void (*)(void* context, uint64_t type_id, const void* data, size_t size);
+
+    // Throws std::system_error if the segment cannot be opened and
+    // std::runtime_error if it is not an IPC segment.
+    explicit IpcReader(const std::string& name);
+    ~IpcReader();
+
+    IpcReader(const IpcReader&) = delete;
+    IpcReader& operator=(const IpcReader&) = delete;
+
+    // Hands up to max_events new events to sink; returns how many.
+    size_t poll(Sink sink, void* context, size_t max_events);
+
+    // Returns once an event may be ready, or after spin_budget polls
+    // (BusySpin), a yield (Yield) or at most 10 ms asleep (Block).
+    void wait(WaitStrategy strategy, uint32_t spin_budget);
+
+    uint64_t received() const noexcept { return received_.load(std::memory_order_relaxed); }
+    uint64_t lost() const noexcept { return lost_.load(std::memory_order_relaxed); }
+
+private:
+    bool ready() const noexcept;
+
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    IpcSegmentHeader* header_ = nullptr;    // Writable: readers register as sleepers
+    const char* slots_ = nullptr;
+    size_t stride_ = 0;
+    uint64_t mask_ = 0;
+    size_t max_event_size_ = 0;
+    uint64_t cursor_ = 0;
+    std::unique_ptr<std::max_align_t[]> buffer_;    // One event, copied out before dispatch
+    std::atomic<uint64_t> received_{0};
+    std::atomic<uint64_t> lost_{0};
+};
+
+} // namespace detail
+
+} // namespace hft::core
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <type_traits>
+
+namespace hft::core {
+
+struct JournalOptions {
+    size_t chunk_size = size_t(64) << 20;   // File growth and mapping unit, rounded to pages
+    bool sync_on_close = false;             // msync + fsync before closing
+};
+
+// One journaled event. `data` points into the reader's mapping and stays
+// valid until the reader is destroyed.
+struct JournalRecord {
+    uint64_t timestamp = 0;     // Event timestamp, or epoch ns when it was journaled
+    uint64_t type_id = 0;       // detail::ipc_type_id() of the event type
+    const void* data = nullptr;
+    uint32_t size = 0;
+};
+
+enum class ReplayMode {
+    AsFastAsPossible,   // Back to back
+    Paced               // Gaps between timestamps kept, divided by ReplayOptions::speed
+};
+
+struct ReplayOptions {
+    ReplayMode mode = ReplayMode::AsFastAsPossible;
+    double speed = 1.0;                     // Paced: 10.0 replays ten times faster than recorded
+    uint64_t max_events = UINT64_MAX;       // Stop after this many records
+};
+
+struct ReplayStats {
+    uint64_t replayed = 0;      // Published to the bus
+    uint64_t unknown = 0;       // No local subscriber knows the type, or its size differs
+    uint64_t elapsed_ns = 0;
+};
+
+namespace detail {
+
+template<typename T, typename = void>
+struct has_journal_timestamp : std::false_type {};
+
+template<typename T>
+struct has_journal_timestamp<T, std::void_t<decltype(std::declval<const T&>().timestamp)>>
+    : std::is_convertible<decltype(std::declval<const T&>().timestamp), uint64_t> {};
+
+} // namespace detail
+
+// Append-only binary event journal. The file is a header followed by
+// 8-byte-aligned records: {size, flags, timestamp, type id} and the event
+// bytes. It grows chunk by chunk and records are copied straight into a
+// shared mapping of the current chunk, so an append is a memcpy and the
+// kernel writes pages back in large batches. A record never straddles a
+// chunk; the unused tail of a chunk is left zero. A record's size is
+// stored last, with release ordering, so records from a process that
+// crashed are readable up to the last complete one.
+class JournalWriter {
+public:
+    // Creates or truncates `path`. Throws std::system_error.
+    explicit JournalWriter(const std::string& path, const JournalOptions& options = {});
+    ~JournalWriter();
+
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+
+    // Appends `count` records of `size` bytes each, laid out back to back at
+    // `data`, under one lock. Safe to call from several threads. Throws
+    // std::length_error if a record cannot fit in a chunk and
+    // std::system_error if the file cannot grow.
+    void append(uint64_t type_id, uint64_t timestamp, const void* data, size_t size, size_t count = 1);
+
+    // Starts writeback of everything appended so far (MS_ASYNC).
+    void flush();
+
+    uint64_t records() const noexcept;
+    uint64_t bytes() const noexcept;
+    const std::string& path() const noexcept { return path_; }
+
+private:
+    char* map_chunk(uint64_t offset);
+    void unmap_chunk() noexcept;
+
+    std::string path_;
+    JournalOptions options_;
+    int fd_ = -1;
+    mutable std::mutex mutex_;
+    char* chunk_ = nullptr;         // Mapping of [chunk_offset_, chunk_offset_ + chunk_size)
+    uint64_t chunk_offset_ = 0;
+    size_t chunk_size_ = 0;
+    size_t position_ = 0;           // Within the chunk
+    uint64_t records_ = 0;
+};
+
+// Read-only view of a journal, mapped as a whole and read ahead as it is
+// walked, so replay speed is bounded by the handlers rather than the disk.
+class JournalReader {
+public:
+    // Throws std::system_error if the file cannot be mapped and
+    // std::runtime_error if it is not a journal.
+    explicit JournalReader(const std::string& path);
+    ~JournalReader();
+
+    JournalReader(const JournalReader&) = delete;
+    JournalReader& operator=(const JournalReader&) = delete;
+
+    // Fills `record` with the next record; false at the end.
+    bool next(JournalRecord& record) noexcept;
+    void rewind() noexcept;
+
+    size_t size() const noexcept { return size_; }
+
+private:
+    void read_ahead(size_t position) noexcept;
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    size_t chunk_size_ = 0;
+    size_t position_ = 0;
+    size_t advised_ = 0;            // Read-ahead requested up to here
+};
+
+} // namespace hft::core
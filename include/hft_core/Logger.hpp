@@ -1,17 +1,23 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <memory>
 #include <atomic>
 #include <thread>
-#include <queue>
+#include <vector>
 #include <mutex>
 #include <condition_variable>
-#include <fstream>
-#include <sstream>
+#include <iosfwd>
 #include <chrono>
-#include <iostream>
-#include <iomanip>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "hft_core/RingBuffer.hpp"
+#include "hft_core/ThreadBinding.hpp"
+#include "hft_core/Timer.hpp"
+#include "hft_core/Trace.hpp"
 
 namespace hft::core {
 
@@ -24,158 +30,623 @@ enum class LogLevel : int {
     FATAL = 5
 };
 
-struct LogMessage {
+enum class LogFormat {
+    Text,       // Formatted lines, written by the background thread
+    Binary      // Raw records, formatted offline by hft_log_decode
+};
+
+enum class LogArgType : uint8_t {
+    Bool,
+    Char,
+    Int64,
+    UInt64,
+    Double,
+    Pointer,
+    String
+};
+
+// What a producer does when its staging buffer is full.
+enum class LogBackpressure {
+    Block,              // Wait for the background thread to make room
+    Drop,               // Discard the new record and count it
+    OverwriteOldest     // Evict the oldest records to make room
+};
+
+// Output batching for the background thread. Formatted lines collect in one
+// reusable buffer that is written with a single write() when it reaches
+// buffer_size, when the oldest line is flush_interval old, or on flush().
+//
+// memory_mapped replaces write() with memcpy into pre-faulted windows of the
+// file; the next window and the next rotation segment are mapped ahead by a
+// helper thread. Rotated segments are named <file>.1, <file>.2, ...
+struct LogSinkOptions {
+    size_t buffer_size = 1 << 20;
+    std::chrono::milliseconds flush_interval{10};
+    bool fsync = false;                             // fdatasync() from a separate thread
+    std::chrono::milliseconds fsync_interval{1000};
+    bool memory_mapped = false;
+    size_t mmap_window_size = 16 << 20;
+    size_t rotate_size = 0;                         // Bytes per segment, 0 = never
+    std::chrono::seconds rotate_interval{0};        // Age per segment, 0 = never
+};
+
+// Counters for one producer thread's staging buffer.
+struct LogThreadStats {
+    std::string thread_label;
+    uint64_t enqueued = 0;      // Records accepted into the buffer
+    uint64_t dropped = 0;       // Records discarded (Drop policy or oversized)
+    uint64_t overwritten = 0;   // Records evicted by OverwriteOldest
+    uint64_t blocked = 0;       // Records that had to wait for room
+    size_t pending_bytes = 0;   // Bytes not yet drained
+};
+
+// Static descriptor of one LOG_* call site. It lives in a function-local
+// static next to the call, so the hot path only stores its address; the
+// background thread assigns ids the first time it sees a site.
+struct LogSite {
     LogLevel level;
-    std::string message;
-    std::string file;
+    const char* file;
     int line;
-    std::thread::id thread_id;
-    std::chrono::high_resolution_clock::time_point timestamp;
-    
-    LogMessage(LogLevel lvl, std::string msg, std::string f, int l)
-        : level(lvl), message(std::move(msg)), file(std::move(f)), line(l),
-          thread_id(std::this_thread::get_id()),
-          timestamp(std::chrono::high_resolution_clock::now()) {}
+    const char* format;
+    const LogArgType* arg_types;
+    uint32_t arg_count;
 };
 
-class Logger {
+namespace detail {
+
+class LogFileSink;
+
+inline constexpr uint32_t kRecordEntry = 0;
+inline constexpr uint32_t kWrapEntry = 1;
+
+// Fixed prefix of every record in a staging buffer. Encoded arguments
+// follow, each 8-byte aligned.
+struct RecordHeader {
+    uint32_t size;      // Total bytes including this header, multiple of 8
+    uint32_t kind;
+    const LogSite* site;
+    uint64_t tsc;
+};
+
+constexpr size_t align8(size_t bytes) noexcept {
+    return (bytes + 7) & ~size_t(7);
+}
+
+// Bounded SPSC byte ring owned by one producer thread. Records are always
+// contiguous: when one would straddle the end, the producer writes a wrap
+// entry covering the tail and restarts at offset zero.
+//
+// With LogBackpressure::OverwriteOldest the producer may also advance the
+// head, so the consumer copies each record out and only keeps it if its
+// CAS on the head confirms the record was not evicted meanwhile.
+class StagingBuffer {
 public:
-    static Logger& instance() {
-        static Logger logger;
-        return logger;
+    StagingBuffer(size_t capacity, LogBackpressure policy)
+        : capacity_(align8(capacity < 4096 ? 4096 : capacity)),
+          policy_(policy),
+          storage_(new uint64_t[capacity_ / sizeof(uint64_t)]) {
+        if (policy_ == LogBackpressure::OverwriteOldest) {
+            scratch_.reset(new uint64_t[max_record_size() / sizeof(uint64_t)]);
+        }
     }
 
-    void set_level(LogLevel level) noexcept {
-        min_level_.store(level, std::memory_order_relaxed);
+    size_t capacity() const noexcept {
+        return capacity_;
     }
 
-    void set_output_file(const std::string& filename) {
-        std::lock_guard<std::mutex> lock(config_mutex_);
-        output_file_ = filename;
-        if (file_stream_.is_open()) {
-            file_stream_.close();
-        }
-        file_stream_.open(filename, std::ios::app);
+    // Larger records are rejected; this bound also guarantees that an
+    // empty buffer always has room, wrap padding included.
+    size_t max_record_size() const noexcept {
+        return (capacity_ / 2) & ~size_t(7);
     }
 
-    void log(LogLevel level, const std::string& message, 
-             const std::string& file, int line) {
-        if (level < min_level_.load(std::memory_order_relaxed)) {
-            return;
+    LogBackpressure policy() const noexcept {
+        return policy_;
+    }
+
+    // Producer side. Returns nullptr when the record does not fit right now;
+    // never fails for OverwriteOldest, which evicts instead.
+    char* reserve(size_t bytes) noexcept {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t offset = tail % capacity_;
+        const size_t padding = offset + bytes > capacity_ ? capacity_ - offset : 0;
+        const size_t end = tail + padding + bytes;
+
+        if (end - cached_head_ > capacity_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            while (end - cached_head_ > capacity_) {
+                if (policy_ != LogBackpressure::OverwriteOldest) {
+                    return nullptr;
+                }
+                evict_oldest();
+            }
         }
 
-        auto log_msg = std::make_unique<LogMessage>(level, message, file, line);
-        
-        {
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            log_queue_.push(std::move(log_msg));
+        if (padding != 0) {
+            auto* wrap = reinterpret_cast<RecordHeader*>(data() + offset);
+            wrap->size = static_cast<uint32_t>(padding);
+            wrap->kind = kWrapEntry;
+            tail_.store(tail + padding, std::memory_order_release);
+            return data();
         }
-        queue_cv_.notify_one();
+        return data() + offset;
     }
 
-    void start_background_thread() {
-        background_thread_ = std::thread(&Logger::background_worker, this);
+    void commit(size_t bytes) noexcept {
+        tail_.store(tail_.load(std::memory_order_relaxed) + bytes, std::memory_order_release);
+        count(enqueued);
     }
 
-    void stop() {
-        {
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            stop_requested_ = true;
+    // Consumer side. Invokes f on the next record, skipping wrap entries;
+    // returns false when the buffer is empty.
+    template<typename F>
+    bool consume(F&& f) {
+        if (policy_ == LogBackpressure::OverwriteOldest) {
+            return consume_copy(f);
         }
-        queue_cv_.notify_one();
-        
-        if (background_thread_.joinable()) {
-            background_thread_.join();
+
+        for (;;) {
+            const size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            const auto* record = reinterpret_cast<const RecordHeader*>(data() + head % capacity_);
+            if (record->kind != kWrapEntry) {
+                f(*record);
+            }
+            head_.store(head + record->size, std::memory_order_release);
+            if (record->kind != kWrapEntry) {
+                return true;
+            }
         }
     }
 
-    ~Logger() {
-        stop();
+    bool empty() const noexcept {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
     }
 
+    size_t pending_bytes() const noexcept {
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t tail_position() const noexcept {
+        return tail_.load(std::memory_order_acquire);
+    }
+
+    size_t head_position() const noexcept {
+        return head_.load(std::memory_order_acquire);
+    }
+
+    // Single-writer counters, updated by the owning thread only.
+    static void count(std::atomic<uint64_t>& counter) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> enqueued{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> overwritten{0};
+    std::atomic<uint64_t> blocked{0};
+
+    // Set by the owning thread's exit hook; the worker frees the buffer
+    // once it has been drained.
+    std::atomic<bool> retired{false};
+    std::string thread_label;
+
 private:
-    Logger() : min_level_(LogLevel::INFO), stop_requested_(false) {
-        start_background_thread();
+    char* data() noexcept {
+        return reinterpret_cast<char*>(storage_.get());
     }
 
-    void background_worker() {
-        while (true) {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            queue_cv_.wait(lock, [this] { 
-                return !log_queue_.empty() || stop_requested_; 
-            });
+    void evict_oldest() noexcept {
+        const auto* oldest = reinterpret_cast<const RecordHeader*>(data() + cached_head_ % capacity_);
+        const size_t size = oldest->size;
+        const bool is_record = oldest->kind != kWrapEntry;
+        if (head_.compare_exchange_strong(cached_head_, cached_head_ + size,
+                                          std::memory_order_acq_rel, std::memory_order_acquire)) {
+            cached_head_ += size;
+            if (is_record) {
+                count(overwritten);
+            }
+        }
+    }
 
-            if (stop_requested_ && log_queue_.empty()) {
-                break;
+    template<typename F>
+    bool consume_copy(F& f) {
+        auto* copy = reinterpret_cast<RecordHeader*>(scratch_.get());
+        for (;;) {
+            size_t head = head_.load(std::memory_order_acquire);
+            if (head == tail_.load(std::memory_order_acquire)) {
+                return false;
             }
 
-            while (!log_queue_.empty()) {
-                auto msg = std::move(log_queue_.front());
-                log_queue_.pop();
-                lock.unlock();
-                
-                write_message(*msg);
-                
-                lock.lock();
+            const size_t offset = head % capacity_;
+            RecordHeader header;
+            std::memcpy(&header, data() + offset, sizeof(header));
+            // A torn header means the record is being evicted; the CAS below
+            // fails in that case, so only the copy length needs bounding.
+            size_t size = header.size;
+            if (size < sizeof(uint64_t) || size > capacity_ - offset) {
+                size = sizeof(uint64_t);
             }
+            const bool is_record = header.kind != kWrapEntry && size >= sizeof(RecordHeader) &&
+                                   size <= max_record_size();
+            if (is_record) {
+                std::memcpy(copy, data() + offset, size);
+            }
+
+            if (!head_.compare_exchange_strong(head, head + size, std::memory_order_acq_rel,
+                                               std::memory_order_acquire)) {
+                continue;
+            }
+            if (is_record) {
+                f(*copy);
+                return true;
+            }
+        }
+    }
+
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    size_t cached_head_ = 0;
+    alignas(64) const size_t capacity_;
+    const LogBackpressure policy_;
+    std::unique_ptr<uint64_t[]> storage_;
+    std::unique_ptr<uint64_t[]> scratch_;
+};
+
+template<typename T>
+constexpr LogArgType log_arg_type() noexcept {
+    using U = std::remove_cv_t<T>;
+    if constexpr (std::is_same_v<U, bool>) {
+        return LogArgType::Bool;
+    } else if constexpr (std::is_same_v<U, char>) {
+        return LogArgType::Char;
+    } else if constexpr (std::is_enum_v<U>) {
+        return std::is_signed_v<std::underlying_type_t<U>> ? LogArgType::Int64 : LogArgType::UInt64;
+    } else if constexpr (std::is_integral_v<U>) {
+        return std::is_signed_v<U> ? LogArgType::Int64 : LogArgType::UInt64;
+    } else if constexpr (std::is_floating_point_v<U>) {
+        return LogArgType::Double;
+    } else if constexpr (std::is_array_v<U> || std::is_same_v<U, const char*> ||
+                         std::is_same_v<U, char*> || std::is_same_v<U, std::string> ||
+                         std::is_same_v<U, std::string_view>) {
+        static_assert(!std::is_array_v<U> || std::is_same_v<std::remove_cv_t<std::remove_extent_t<U>>, char>,
+                      "only char arrays can be logged");
+        return LogArgType::String;
+    } else if constexpr (std::is_pointer_v<U>) {
+        return LogArgType::Pointer;
+    } else {
+        static_assert(sizeof(U) == 0, "unsupported LOG_* argument type");
+        return LogArgType::Pointer;
+    }
+}
+
+template<typename... Args>
+inline constexpr LogArgType log_arg_types[sizeof...(Args) + 1] = {log_arg_type<Args>()..., LogArgType::Pointer};
+
+template<typename T>
+std::string_view as_string_view(const T& value) noexcept {
+    using U = std::remove_cv_t<T>;
+    if constexpr (std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view>) {
+        return std::string_view(value);
+    } else if constexpr (std::is_array_v<U>) {
+        return std::string_view(value, ::strnlen(value, sizeof(U)));
+    } else {
+        return value ? std::string_view(value) : std::string_view("(null)");
+    }
+}
+
+template<typename T>
+size_t encoded_size(const T& value) noexcept {
+    if constexpr (log_arg_type<T>() == LogArgType::String) {
+        return align8(sizeof(uint32_t) + as_string_view(value).size());
+    } else {
+        return sizeof(uint64_t);
+    }
+}
+
+template<typename T>
+void encode_arg(char*& out, const T& value) noexcept {
+    constexpr LogArgType type = log_arg_type<T>();
+    if constexpr (type == LogArgType::String) {
+        std::string_view str = as_string_view(value);
+        const auto length = static_cast<uint32_t>(str.size());
+        std::memcpy(out, &length, sizeof(length));
+        std::memcpy(out + sizeof(length), str.data(), length);
+        out += align8(sizeof(length) + length);
+    } else {
+        if constexpr (type == LogArgType::Double) {
+            const double v = static_cast<double>(value);
+            std::memcpy(out, &v, sizeof(v));
+        } else if constexpr (type == LogArgType::Pointer) {
+            const auto v = reinterpret_cast<uint64_t>(value);
+            std::memcpy(out, &v, sizeof(v));
+        } else if constexpr (type == LogArgType::Int64) {
+            const auto v = static_cast<int64_t>(value);
+            std::memcpy(out, &v, sizeof(v));
+        } else {
+            const auto v = static_cast<uint64_t>(value);
+            std::memcpy(out, &v, sizeof(v));
+        }
+        out += sizeof(uint64_t);
+    }
+}
+
+// The first argument of a LOG_* call is its format when it is a string
+// literal (FormatLiteral, see HFT_LOG_FORMAT_IS_LITERAL): the site keeps
+// that pointer for the background thread. Anything else, char buffers
+// included, is logged as "{}" with that argument copied into the record.
+template<bool FormatLiteral, typename First, typename... Rest>
+LogSite make_log_site(LogLevel level, const char* file, int line,
+                      const First& first, const Rest&...) noexcept {
+    if constexpr (FormatLiteral) {
+        return LogSite{level, file, line, first, log_arg_types<Rest...>,
+                       static_cast<uint32_t>(sizeof...(Rest))};
+    } else {
+        return LogSite{level, file, line, "{}", log_arg_types<First, Rest...>,
+                       static_cast<uint32_t>(sizeof...(Rest) + 1)};
+    }
+}
+
+// Site used by Logger::log(level, message, file, line): level, line, file
+// and message are all carried in the record.
+extern const LogSite kRuntimeLogSite;
+
+} // namespace detail
+
+// instance() is the process-wide default. Independent loggers (e.g. one
+// per pinned pipeline, each with its own file) have their own staging
+// buffers and background thread.
+class alignas(kCacheLineSize) Logger {
+public:
+    static constexpr size_t kDefaultThreadBufferSize = 1 << 20;
+
+    static Logger& instance() {
+        static Logger logger;
+        return logger;
+    }
+
+    // The calling thread's bound Logger (see ThreadBinding), else instance().
+    static Logger& current() {
+        Logger*& bound = thread_bound();
+        if (__builtin_expect(bound == nullptr, 0)) {
+            bound = &instance();
         }
+        return *bound;
+    }
+
+    // Binds `logger` to the calling thread (nullptr: back to instance()) and
+    // returns the previous binding.
+    static Logger* bind_thread(Logger* logger) noexcept {
+        Logger*& bound = thread_bound();
+        Logger* previous = bound;
+        bound = logger;
+        return previous;
+    }
+
+    Logger();
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    void set_level(LogLevel level) noexcept {
+        min_level_.store(level, std::memory_order_relaxed);
+    }
+
+    LogLevel level() const noexcept {
+        return min_level_.load(std::memory_order_relaxed);
+    }
+
+    bool is_enabled(LogLevel level) const noexcept {
+        return level >= min_level_.load(std::memory_order_relaxed);
+    }
+
+    void set_output_file(const std::string& filename) {
+        set_output_file(filename, LogFormat::Text);
+    }
+
+    // LogFormat::Binary writes raw records; use hft_log_decode to read them.
+    void set_output_file(const std::string& filename, LogFormat format);
+
+    // Applies to sinks opened by later set_output_file() calls.
+    void set_sink_options(const LogSinkOptions& options);
+
+    LogSinkOptions sink_options() const;
+
+    // Capacity of staging buffers created by threads that log for the
+    // first time after this call.
+    void set_thread_buffer_size(size_t bytes) noexcept {
+        thread_buffer_size_.store(bytes, std::memory_order_relaxed);
     }
 
-    void write_message(const LogMessage& msg) {
-        std::ostringstream oss;
-        
-        auto time_t = std::chrono::system_clock::to_time_t(
-            std::chrono::system_clock::now());
-        auto tm = *std::localtime(&time_t);
-        
-        oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << " ";
-        oss << "[" << level_to_string(msg.level) << "] ";
-        oss << "[" << msg.thread_id << "] ";
-        oss << msg.message;
-        oss << " (" << msg.file << ":" << msg.line << ")\n";
-
-        std::string formatted = oss.str();
-        
-        {
-            std::lock_guard<std::mutex> lock(config_mutex_);
-            if (file_stream_.is_open()) {
-                file_stream_ << formatted;
-                file_stream_.flush();
-            } else {
-                std::cout << formatted;
+    // Full-buffer policy for staging buffers created after this call, like
+    // set_thread_buffer_size(). Defaults to LogBackpressure::Block.
+    void set_backpressure(LogBackpressure policy) noexcept {
+        backpressure_.store(policy, std::memory_order_relaxed);
+    }
+
+    LogBackpressure backpressure() const noexcept {
+        return backpressure_.load(std::memory_order_relaxed);
+    }
+
+    // Snapshot of every registered producer thread's counters.
+    std::vector<LogThreadStats> thread_stats() const;
+
+    // Counters of the calling thread's staging buffer (zero if it has not
+    // logged yet).
+    LogThreadStats current_thread_stats() const;
+
+    void log(LogLevel level, const std::string& message,
+             const std::string& file, int line) {
+        if (!is_enabled(level)) {
+            return;
+        }
+
+        write_args(detail::kRuntimeLogSite, static_cast<int64_t>(level),
+                   static_cast<int64_t>(line), file, message);
+    }
+
+    // Hot path behind the LOG_* macros: copies the raw argument bytes into
+    // this thread's staging buffer. All formatting is deferred.
+    // FormatLiteral must match the make_log_site() that built `site`.
+    template<bool FormatLiteral, typename First, typename... Rest>
+    void write(const LogSite& site, const First& first, const Rest&... rest) noexcept {
+        if constexpr (FormatLiteral) {
+            write_args(site, rest...);
+        } else {
+            write_args(site, first, rest...);
+        }
+    }
+
+    // Blocks until every record logged before the call has been written.
+    void flush();
+
+    void start_background_thread();
+
+    void stop();
+
+private:
+    static Logger*& thread_bound() noexcept {
+        static thread_local Logger* bound = nullptr;
+        return bound;
+    }
+
+    template<typename... Args>
+    void write_args(const LogSite& site, const Args&... args) noexcept {
+        const size_t size = detail::align8(
+            sizeof(detail::RecordHeader) + (size_t{0} + ... + detail::encoded_size(args)));
+
+        detail::StagingBuffer* buffer = thread_buffer();
+        if (!buffer) {
+            return;
+        }
+        if (size > buffer->max_record_size()) {
+            detail::StagingBuffer::count(buffer->dropped);
+            return;
+        }
+
+        char* out = buffer->reserve(size);
+        if (!out) {
+            if (buffer->policy() == LogBackpressure::Drop) {
+                detail::StagingBuffer::count(buffer->dropped);
+                return;
             }
+            detail::StagingBuffer::count(buffer->blocked);
+            wake_worker();
+            do {
+                if (stop_requested_.load(std::memory_order_relaxed)) {
+                    detail::StagingBuffer::count(buffer->dropped);
+                    return;
+                }
+                std::this_thread::yield();
+                out = buffer->reserve(size);
+            } while (!out);
         }
+
+        auto* header = reinterpret_cast<detail::RecordHeader*>(out);
+        header->size = static_cast<uint32_t>(size);
+        header->kind = detail::kRecordEntry;
+        header->site = &site;
+        header->tsc = Timer::rdtsc();
+
+        [[maybe_unused]] char* payload = out + sizeof(detail::RecordHeader);
+        (detail::encode_arg(payload, args), ...);
+        buffer->commit(size);
+        HFT_TRACE(TraceProbe::LogEnqueue, size);
+    }
+
+    // The calling thread's buffer for the Logger it used last.
+    struct ThreadBufferCache {
+        uint64_t logger_id = 0;
+        detail::StagingBuffer* buffer = nullptr;
+    };
+
+    static ThreadBufferCache& cached_buffer() noexcept {
+        static thread_local ThreadBufferCache cache;
+        return cache;
     }
 
-    const char* level_to_string(LogLevel level) const {
-        switch (level) {
-            case LogLevel::TRACE: return "TRACE";
-            case LogLevel::DEBUG: return "DEBUG";
-            case LogLevel::INFO:  return "INFO";
-            case LogLevel::WARN:  return "WARN";
-            case LogLevel::ERROR: return "ERROR";
-            case LogLevel::FATAL: return "FATAL";
-            default: return "UNKNOWN";
+    detail::StagingBuffer* thread_buffer() noexcept {
+        const ThreadBufferCache& cache = cached_buffer();
+        if (__builtin_expect(cache.logger_id == id_, 1)) {
+            return cache.buffer;
         }
+        return register_thread();
     }
 
+    // Finds or creates the calling thread's buffer and caches it.
+    detail::StagingBuffer* register_thread() noexcept;
+
+    void background_worker();
+
+    void wake_worker() noexcept;
+
+    static LogThreadStats make_stats(const detail::StagingBuffer& buffer);
+
+    const uint64_t id_;                 // Unique for the process lifetime; never 0
     std::atomic<LogLevel> min_level_;
-    std::queue<std::unique_ptr<LogMessage>> log_queue_;
-    std::mutex queue_mutex_;
-    std::condition_variable queue_cv_;
+    std::atomic<size_t> thread_buffer_size_{kDefaultThreadBufferSize};
+    std::atomic<LogBackpressure> backpressure_{LogBackpressure::Block};
+
+    std::vector<std::shared_ptr<detail::StagingBuffer>> buffers_;
+    mutable std::mutex registry_mutex_;
+    std::atomic<uint64_t> registry_version_{0};
+
     std::thread background_thread_;
     std::atomic<bool> stop_requested_;
-    
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable flush_cv_;
+    std::atomic<uint64_t> completed_passes_{0};
+    bool wake_requested_ = false;
+
+    std::atomic<bool> flush_requested_{false};
+
     std::string output_file_;
-    std::ofstream file_stream_;
-    std::mutex config_mutex_;
+    LogFormat output_format_ = LogFormat::Text;
+    LogSinkOptions sink_options_;
+    std::unique_ptr<detail::LogFileSink> sink_;
+    bool binary_header_pending_ = false;
+    mutable std::mutex config_mutex_;
 };
 
-#define LOG_TRACE(msg) hft::core::Logger::instance().log(hft::core::LogLevel::TRACE, msg, __FILE__, __LINE__)
-#define LOG_DEBUG(msg) hft::core::Logger::instance().log(hft::core::LogLevel::DEBUG, msg, __FILE__, __LINE__)
-#define LOG_INFO(msg)  hft::core::Logger::instance().log(hft::core::LogLevel::INFO, msg, __FILE__, __LINE__)
-#define LOG_WARN(msg)  hft::core::Logger::instance().log(hft::core::LogLevel::WARN, msg, __FILE__, __LINE__)
-#define LOG_ERROR(msg) hft::core::Logger::instance().log(hft::core::LogLevel::ERROR, msg, __FILE__, __LINE__)
-#define LOG_FATAL(msg) hft::core::Logger::instance().log(hft::core::LogLevel::FATAL, msg, __FILE__, __LINE__)
+// Decodes a file written with LogFormat::Binary into the text format.
+bool decode_binary_log(std::istream& in, std::ostream& out);
+
+// First of the LOG_* arguments, for unevaluated use only.
+#define HFT_LOG_FIRST_ARG_(first, ...) first
+#define HFT_LOG_FIRST_ARG(...) HFT_LOG_FIRST_ARG_(__VA_ARGS__, 0)
+
+// Whether the first LOG_* argument is a string literal: a char array with a
+// compile-time constant address. A char buffer on the stack has the same
+// type but may be rewritten or gone by the time the record is formatted.
+#define HFT_LOG_FORMAT_IS_LITERAL(...) \
+    (std::is_array_v<std::remove_reference_t<decltype(HFT_LOG_FIRST_ARG(__VA_ARGS__))>> && \
+     __builtin_constant_p(HFT_LOG_FIRST_ARG(__VA_ARGS__)))
+
+#define HFT_LOG(level, ...) \
+    do { \
+        auto& hft_logger_ = hft::core::Logger::current(); \
+        if (hft_logger_.is_enabled(level)) { \
+            constexpr bool hft_literal_ = HFT_LOG_FORMAT_IS_LITERAL(__VA_ARGS__); \
+            [&hft_logger_](const auto&... hft_args_) { \
+                static const hft::core::LogSite hft_site_ = \
+                    hft::core::detail::make_log_site<hft_literal_>(level, __FILE__, __LINE__, hft_args_...); \
+                hft_logger_.write<hft_literal_>(hft_site_, hft_args_...); \
+            }(__VA_ARGS__); \
+        } \
+    } while (0)
+
+// LOG_INFO("filled {} @ {}", qty, px) or LOG_INFO(message_string), to the
+// calling thread's current Logger
+#define LOG_TRACE(...) HFT_LOG(hft::core::LogLevel::TRACE, __VA_ARGS__)
+#define LOG_DEBUG(...) HFT_LOG(hft::core::LogLevel::DEBUG, __VA_ARGS__)
+#define LOG_INFO(...)  HFT_LOG(hft::core::LogLevel::INFO, __VA_ARGS__)
+#define LOG_WARN(...)  HFT_LOG(hft::core::LogLevel::WARN, __VA_ARGS__)
+#define LOG_ERROR(...) HFT_LOG(hft::core::LogLevel::ERROR, __VA_ARGS__)
+#define LOG_FATAL(...) HFT_LOG(hft::core::LogLevel::FATAL, __VA_ARGS__)
 
-} // namespace hft::core
\ No newline at end of file
+} // namespace hft::core
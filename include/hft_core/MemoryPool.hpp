@@ -1,40 +1,92 @@
 #pragma once
 
 #include <memory>
+#include <memory_resource>
 #include <vector>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <mutex>
 #include <new>
 #include <cstdlib>
 
 namespace hft::core {
 
+struct MemoryPoolOptions {
+    bool huge_pages = false;    // 2 MiB pages: MAP_HUGETLB, else madvise(MADV_HUGEPAGE)
+    bool prefault = false;      // Touch every page up front
+    bool lock_memory = false;   // mlock() the blocks so they are never paged out
+    int numa_node = -1;         // mbind() the blocks to this node; -1 leaves placement to the OS
+};
+
+namespace detail {
+
+// Backing memory for the pools. Huge-page and node-bound regions come from
+// mmap (huge pages are rounded up to whole 2 MiB pages); others come from
+// aligned_alloc.
+struct PoolRegion {
+    PoolRegion* next = nullptr;
+    void* base = nullptr;
+    size_t bytes = 0;
+    bool mapped = false;
+    bool huge_pages = false;    // MAP_HUGETLB or THP advice took effect
+    bool locked = false;
+    bool numa_bound = false;    // mbind() to options.numa_node succeeded
+};
+
+inline constexpr size_t kHugePageSize = size_t(2) << 20;
+
+// Returns usable memory of at least `bytes` (updated to the actual size) and
+// fills `region`; throws std::bad_alloc on failure.
+void* allocate_pool_region(size_t& bytes, size_t alignment, const MemoryPoolOptions& options,
+                           PoolRegion& region);
+
+void release_pool_region(const PoolRegion& region) noexcept;
+
+} // namespace detail
+
+// Single-threaded object pool. Free slots are chained through their own
+// storage, so the free list costs no memory and allocate()/deallocate() are
+// a couple of loads and stores. Slots are handed out in address order.
 template<typename T, size_t BlockSize = 4096>
 class MemoryPool {
 public:
-    explicit MemoryPool(size_t initial_blocks = 1) {
-        allocate_block();
+    explicit MemoryPool(size_t initial_blocks = 1, const MemoryPoolOptions& options = {})
+        : options_(options) {
+        // One contiguous region for all initial blocks.
+        add_region((initial_blocks ? initial_blocks : 1) * BlockSize);
     }
 
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
+
     ~MemoryPool() {
-        for (auto* block : blocks_) {
-            std::free(block);
+        while (regions_) {
+            detail::PoolRegion* region = regions_;
+            regions_ = region->next;
+            const detail::PoolRegion copy = *region;
+            region->~PoolRegion();
+            detail::release_pool_region(copy);
         }
     }
 
     T* allocate() {
-        if (free_list_.empty()) {
+        if (!free_list_) {
             allocate_block();
         }
-        
-        T* ptr = free_list_.back();
-        free_list_.pop_back();
-        return ptr;
+
+        Slot* slot = free_list_;
+        free_list_ = slot->next;
+        --available_;
+        return reinterpret_cast<T*>(slot);
     }
 
     void deallocate(T* ptr) noexcept {
         if (ptr) {
-            free_list_.push_back(ptr);
+            Slot* slot = reinterpret_cast<Slot*>(ptr);
+            slot->next = free_list_;
+            free_list_ = slot;
+            ++available_;
         }
     }
 
@@ -58,89 +110,613 @@ public:
     }
 
     size_t capacity() const noexcept {
-        return blocks_.size() * objects_per_block_;
+        return capacity_;
     }
 
     size_t available() const noexcept {
-        return free_list_.size();
+        return available_;
+    }
+
+    // True when every region is backed by huge pages / locked in memory /
+    // bound to options.numa_node. Each can be refused by the OS (no reserved
+    // huge pages, RLIMIT_MEMLOCK, no NUMA support), in which case the pool
+    // still works with regular pages.
+    bool huge_pages_active() const noexcept {
+        return all_regions([](const detail::PoolRegion& region) { return region.huge_pages; });
+    }
+
+    bool memory_locked() const noexcept {
+        return all_regions([](const detail::PoolRegion& region) { return region.locked; });
+    }
+
+    bool numa_bound() const noexcept {
+        return all_regions([](const detail::PoolRegion& region) { return region.numa_bound; });
     }
 
 private:
-    static constexpr size_t objects_per_block_ = BlockSize / sizeof(T);
-    
-    std::vector<void*> blocks_;
-    std::vector<T*> free_list_;
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static constexpr size_t kHeaderSize =
+        (sizeof(detail::PoolRegion) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+    static constexpr size_t kAlignment =
+        alignof(Slot) > alignof(detail::PoolRegion) ? alignof(Slot) : alignof(detail::PoolRegion);
+
+    static_assert(BlockSize >= kHeaderSize + sizeof(Slot), "BlockSize too small for one object");
 
     void allocate_block() {
-        void* block = std::aligned_alloc(alignof(T), BlockSize);
-        if (!block) {
+        add_region(BlockSize);
+    }
+
+    // Region layout: PoolRegion header, then back-to-back slots linked in
+    // address order onto the front of the free list.
+    void add_region(size_t bytes) {
+        detail::PoolRegion info;
+        void* memory = detail::allocate_pool_region(bytes, kAlignment, options_, info);
+
+        auto* region = new (memory) detail::PoolRegion(info);
+        region->next = regions_;
+        regions_ = region;
+
+        Slot* slots = reinterpret_cast<Slot*>(static_cast<char*>(memory) + kHeaderSize);
+        const size_t count = (bytes - kHeaderSize) / sizeof(Slot);
+        for (size_t i = 0; i + 1 < count; ++i) {
+            slots[i].next = &slots[i + 1];
+        }
+        slots[count - 1].next = free_list_;
+        free_list_ = slots;
+
+        capacity_ += count;
+        available_ += count;
+    }
+
+    template<typename Predicate>
+    bool all_regions(Predicate predicate) const noexcept {
+        for (const detail::PoolRegion* region = regions_; region; region = region->next) {
+            if (!predicate(*region)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const MemoryPoolOptions options_;
+    Slot* free_list_ = nullptr;
+    detail::PoolRegion* regions_ = nullptr;
+    size_t capacity_ = 0;
+    size_t available_ = 0;
+};
+
+// Bump-pointer allocator for temporaries that all die together, e.g. at the
+// end of a tick. Allocation is a pointer increment; reset() rewinds to the
+// first block in O(1) and keeps every block for reuse, so once warm an arena
+// never touches malloc. Destructors of arena objects are never run.
+//
+// Not thread-safe. thread_local_instance() gives each thread its own, and
+// ArenaScope binds one as Arena::current() for code running inside it.
+class Arena final : public std::pmr::memory_resource {
+public:
+    static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+    // Resume point for rewind(); see ArenaScope.
+    struct Marker {
+        detail::PoolRegion* block = nullptr;
+        char* cursor = nullptr;
+    };
+
+    explicit Arena(size_t block_size = kDefaultBlockSize, const MemoryPoolOptions& options = {})
+        : block_size_(block_size), options_(options) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena() override {
+        while (first_) {
+            detail::PoolRegion* block = first_;
+            first_ = block->next;
+            const detail::PoolRegion copy = *block;
+            block->~PoolRegion();
+            detail::release_pool_region(copy);
+        }
+    }
+
+    void* allocate_bytes(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        const uintptr_t aligned =
+            (reinterpret_cast<uintptr_t>(cursor_) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        if (aligned + bytes <= reinterpret_cast<uintptr_t>(limit_) && cursor_) {
+            cursor_ = reinterpret_cast<char*>(aligned + bytes);
+            return reinterpret_cast<void*>(aligned);
+        }
+        return allocate_slow(bytes, alignment);
+    }
+
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        return new (allocate_bytes(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template<typename T>
+    T* allocate_array(size_t count) {
+        return static_cast<T*>(allocate_bytes(sizeof(T) * count, alignof(T)));
+    }
+
+    Marker mark() const noexcept {
+        return Marker{current_, cursor_};
+    }
+
+    // Frees everything allocated since `marker` was taken.
+    void rewind(const Marker& marker) noexcept {
+        if (!marker.block) {
+            reset();
+            return;
+        }
+        current_ = marker.block;
+        cursor_ = marker.cursor;
+        limit_ = block_end(current_);
+    }
+
+    void reset() noexcept {
+        current_ = first_;
+        cursor_ = first_ ? block_begin(first_) : nullptr;
+        limit_ = first_ ? block_end(first_) : nullptr;
+    }
+
+    // Bytes of retained blocks, used or not.
+    size_t capacity() const noexcept {
+        size_t bytes = 0;
+        for (const detail::PoolRegion* block = first_; block; block = block->next) {
+            bytes += block->bytes - kHeaderSize;
+        }
+        return bytes;
+    }
+
+    // The calling thread's arena, created on first use.
+    static Arena& thread_local_instance() {
+        static thread_local Arena arena;
+        return arena;
+    }
+
+    // Arena bound by the innermost ArenaScope on this thread, or nullptr.
+    static Arena* current() noexcept {
+        return current_slot();
+    }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        return allocate_bytes(bytes, alignment);
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    friend class ArenaScope;
+
+    static constexpr size_t kHeaderSize = 64;
+    static_assert(sizeof(detail::PoolRegion) <= kHeaderSize, "PoolRegion must fit the block header");
+
+    static Arena*& current_slot() noexcept {
+        static thread_local Arena* arena = nullptr;
+        return arena;
+    }
+
+    static char* block_begin(detail::PoolRegion* block) noexcept {
+        return static_cast<char*>(block->base) + kHeaderSize;
+    }
+
+    static char* block_end(detail::PoolRegion* block) noexcept {
+        return static_cast<char*>(block->base) + block->bytes;
+    }
+
+    // Moves on to the next retained block if it fits, otherwise inserts a
+    // new one (sized for the request if it exceeds block_size_). Blocks
+    // start 64-byte aligned, so any alignment up to that fits at the start.
+    void* allocate_slow(size_t bytes, size_t alignment) {
+        if (alignment > kHeaderSize) {
             throw std::bad_alloc{};
         }
-        
-        blocks_.push_back(block);
-        
-        T* typed_block = static_cast<T*>(block);
-        for (size_t i = 0; i < objects_per_block_; ++i) {
-            free_list_.push_back(typed_block + i);
+
+        detail::PoolRegion* next = current_ ? current_->next : nullptr;
+        if (!next || next->bytes - kHeaderSize < bytes) {
+            next = add_block(bytes);
+        }
+
+        current_ = next;
+        cursor_ = block_begin(next);
+        limit_ = block_end(next);
+        return allocate_bytes(bytes, alignment);
+    }
+
+    detail::PoolRegion* add_block(size_t min_bytes) {
+        size_t bytes = kHeaderSize + (min_bytes > block_size_ ? min_bytes : block_size_);
+        detail::PoolRegion info;
+        void* memory = detail::allocate_pool_region(bytes, kHeaderSize, options_, info);
+        auto* block = new (memory) detail::PoolRegion(info);
+
+        if (current_) {
+            block->next = current_->next;
+            current_->next = block;
+        } else {
+            block->next = first_;
+            first_ = block;
         }
+        return block;
+    }
+
+    const size_t block_size_;
+    const MemoryPoolOptions options_;
+    detail::PoolRegion* first_ = nullptr;
+    detail::PoolRegion* current_ = nullptr;
+    char* cursor_ = nullptr;
+    char* limit_ = nullptr;
+};
+
+// Binds an arena as Arena::current() and releases everything allocated in
+// it when the scope ends. Scopes nest: an inner scope only rewinds to where
+// it started.
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena& arena) noexcept
+        : arena_(arena), marker_(arena.mark()), previous_(Arena::current_slot()) {
+        Arena::current_slot() = &arena_;
+    }
+
+    // Scope over the calling thread's arena.
+    ArenaScope() : ArenaScope(Arena::thread_local_instance()) {}
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    ~ArenaScope() {
+        arena_.rewind(marker_);
+        Arena::current_slot() = previous_;
+    }
+
+    Arena& arena() noexcept {
+        return arena_;
     }
+
+private:
+    Arena& arena_;
+    const Arena::Marker marker_;
+    Arena* const previous_;
 };
 
-template<typename T>
+namespace detail {
+
+inline constexpr int kMaxPoolThreadSlots = 64;
+
+// Small process-wide ids for threads that use LockFreeMemoryPool, recycled
+// when a thread exits. A new owner of a slot inherits whatever the previous
+// one left in each pool's magazine for that slot, so nothing leaks.
+class PoolThreadSlots {
+public:
+    static int acquire() noexcept {
+        uint64_t used = mask().load(std::memory_order_relaxed);
+        for (;;) {
+            if (~used == 0) {
+                return -1;
+            }
+            const int slot = __builtin_ctzll(~used);
+            if (mask().compare_exchange_weak(used, used | (uint64_t(1) << slot),
+                                             std::memory_order_acquire, std::memory_order_relaxed)) {
+                return slot;
+            }
+        }
+    }
+
+    static void release(int slot) noexcept {
+        mask().fetch_and(~(uint64_t(1) << slot), std::memory_order_release);
+    }
+
+private:
+    static std::atomic<uint64_t>& mask() noexcept {
+        static std::atomic<uint64_t> used{0};
+        return used;
+    }
+};
+
+struct PoolThreadSlot {
+    int id = -2;    // -2: not assigned yet, -1: all slots taken
+
+    ~PoolThreadSlot() {
+        if (id >= 0) {
+            PoolThreadSlots::release(id);
+            // Thread-locals destroyed after this one may still free into a
+            // pool; with -1 they use the depot, not a slot now reissued.
+            id = -1;
+        }
+    }
+};
+
+inline int current_pool_thread_slot() noexcept {
+    static thread_local PoolThreadSlot slot;
+    if (slot.id == -2) {
+        slot.id = PoolThreadSlots::acquire();
+    }
+    return slot.id;
+}
+
+} // namespace detail
+
+// Node pool with a per-thread magazine in front of a shared depot. Each
+// thread allocates from and frees into its own magazine; only when it runs
+// dry or overflows does it move a whole batch of BatchSize nodes to or from
+// the depot with one CAS. The depot head packs a node index with a version
+// tag, so the shared path is ABA-safe. Nodes may be freed by a different
+// thread than the one that allocated them.
+template<typename T, size_t BatchSize = 16>
 class LockFreeMemoryPool {
 public:
+    static_assert(BatchSize > 0, "BatchSize must be positive");
+
     struct alignas(64) Node {
-        std::atomic<Node*> next{nullptr};
+        Node* next = nullptr;                   // Next node in the same batch
+        std::atomic<uint32_t> batch_next{0};    // Next batch in the depot
+        uint32_t batch_size = 0;
+        uint32_t index = 0;
         alignas(T) char data[sizeof(T)];
     };
 
-    explicit LockFreeMemoryPool(size_t initial_size = 1000) {
-        for (size_t i = 0; i < initial_size; ++i) {
-            auto* node = new Node;
-            Node* expected = head_.load(std::memory_order_relaxed);
-            node->next.store(expected, std::memory_order_relaxed);
-            while (!head_.compare_exchange_weak(
-                expected, node, std::memory_order_release, std::memory_order_relaxed)) {
-                node->next.store(expected, std::memory_order_relaxed);
-            }
-        }
+    explicit LockFreeMemoryPool(size_t initial_size = 1000, const MemoryPoolOptions& options = {})
+        : magazines_(new Magazine[detail::kMaxPoolThreadSlots]), options_(options) {
+        reserve(initial_size);
     }
 
+    LockFreeMemoryPool(const LockFreeMemoryPool&) = delete;
+    LockFreeMemoryPool& operator=(const LockFreeMemoryPool&) = delete;
+
     ~LockFreeMemoryPool() {
-        while (auto* node = head_.load()) {
-            head_.store(node->next.load());
-            delete node;
+        const size_t count = chunk_count_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i) {
+            detail::release_pool_region(chunks_[i].region);
         }
     }
 
     T* allocate() {
-        Node* old_head = head_.load(std::memory_order_acquire);
-        while (old_head && !head_.compare_exchange_weak(
-            old_head, old_head->next.load(), std::memory_order_release, std::memory_order_acquire)) {
+        const int slot = detail::current_pool_thread_slot();
+        if (slot < 0) {
+            return reinterpret_cast<T*>(pop_one()->data);
         }
-        
-        if (!old_head) {
-            old_head = new Node;
+
+        Magazine& magazine = magazines_[slot];
+        if (magazine.count == 0) {
+            refill(magazine);
         }
-        
-        return reinterpret_cast<T*>(old_head->data);
+        return reinterpret_cast<T*>(magazine.nodes[--magazine.count]->data);
     }
 
     void deallocate(T* ptr) noexcept {
         if (!ptr) return;
-        
+
         Node* node = reinterpret_cast<Node*>(
             reinterpret_cast<char*>(ptr) - offsetof(Node, data));
-        
-        Node* old_head = head_.load(std::memory_order_relaxed);
-        do {
-            node->next.store(old_head, std::memory_order_relaxed);
-        } while (!head_.compare_exchange_weak(
-            old_head, node, std::memory_order_release, std::memory_order_relaxed));
+
+        const int slot = detail::current_pool_thread_slot();
+        if (slot < 0) {
+            node->next = nullptr;
+            node->batch_size = 1;
+            push_batch(node);
+            return;
+        }
+
+        Magazine& magazine = magazines_[slot];
+        if (magazine.count == kMagazineCapacity) {
+            spill(magazine);
+        }
+        magazine.nodes[magazine.count++] = node;
+    }
+
+    // Pre-populates the depot with count additional nodes.
+    void reserve(size_t count) {
+        if (count == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(grow_mutex_);
+        Node* first = add_chunk(count);
+        push_chunk(first, count);
+    }
+
+    // Number of allocate() calls that found both the calling thread's
+    // magazine and the depot empty and had to grow the pool. Stays flat
+    // while the pool is warm.
+    size_t heap_allocations() const noexcept {
+        return heap_allocations_.load(std::memory_order_relaxed);
+    }
+
+    // Total nodes owned by the pool, free or in use.
+    size_t capacity() const noexcept {
+        std::lock_guard<std::mutex> lock(grow_mutex_);
+        return total_nodes_;
+    }
+
+    // True if every chunk is bound to options.numa_node.
+    bool numa_bound() const noexcept {
+        std::lock_guard<std::mutex> lock(grow_mutex_);
+        const size_t count = chunk_count_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i) {
+            if (!chunks_[i].region.numa_bound) {
+                return false;
+            }
+        }
+        return count != 0;
     }
 
 private:
-    std::atomic<Node*> head_{nullptr};
+    static constexpr size_t kMagazineCapacity = 2 * BatchSize;
+    static constexpr uint32_t kNullIndex = ~uint32_t(0);
+    static constexpr size_t kMaxChunks = 64;
+    static constexpr size_t kMinGrowNodes = 64;
+
+    struct alignas(64) Magazine {
+        size_t count = 0;
+        Node* nodes[kMagazineCapacity];
+    };
+
+    struct Chunk {
+        Node* nodes = nullptr;
+        uint32_t first = 0;
+        detail::PoolRegion region;
+    };
+
+    static constexpr uint64_t pack(uint32_t index, uint32_t tag) noexcept {
+        return (uint64_t(tag) << 32) | index;
+    }
+
+    static constexpr uint32_t index_of(uint64_t head) noexcept {
+        return static_cast<uint32_t>(head);
+    }
+
+    static constexpr uint32_t tag_of(uint64_t head) noexcept {
+        return static_cast<uint32_t>(head >> 32);
+    }
+
+    Node* node_at(uint32_t index) const noexcept {
+        size_t lo = 0;
+        size_t hi = chunk_count_.load(std::memory_order_acquire);
+        while (hi - lo > 1) {
+            const size_t mid = (lo + hi) / 2;
+            if (chunks_[mid].first <= index) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        return &chunks_[lo].nodes[index - chunks_[lo].first];
+    }
+
+    void push_batch(Node* head) noexcept {
+        uint64_t old_head = depot_.load(std::memory_order_relaxed);
+        do {
+            head->batch_next.store(index_of(old_head), std::memory_order_relaxed);
+        } while (!depot_.compare_exchange_weak(
+            old_head, pack(head->index, tag_of(old_head) + 1),
+            std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    Node* pop_batch() noexcept {
+        uint64_t old_head = depot_.load(std::memory_order_acquire);
+        for (;;) {
+            const uint32_t index = index_of(old_head);
+            if (index == kNullIndex) {
+                return nullptr;
+            }
+            Node* head = node_at(index);
+            const uint32_t next = head->batch_next.load(std::memory_order_relaxed);
+            if (depot_.compare_exchange_weak(old_head, pack(next, tag_of(old_head) + 1),
+                                             std::memory_order_acquire, std::memory_order_acquire)) {
+                return head;
+            }
+        }
+    }
+
+    // Slow path for threads without a magazine slot.
+    Node* pop_one() {
+        Node* batch = pop_batch();
+        if (!batch) {
+            batch = grow();
+        }
+        if (Node* rest = batch->next) {
+            rest->batch_size = batch->batch_size - 1;
+            push_batch(rest);
+        }
+        return batch;
+    }
+
+    void refill(Magazine& magazine) {
+        Node* batch = pop_batch();
+        if (!batch) {
+            batch = grow();
+        }
+        for (Node* node = batch; node; node = node->next) {
+            magazine.nodes[magazine.count++] = node;
+        }
+    }
+
+    // Returns the older half of a full magazine to the depot as one batch.
+    void spill(Magazine& magazine) noexcept {
+        for (size_t i = 0; i < BatchSize; ++i) {
+            magazine.nodes[i]->next = i + 1 < BatchSize ? magazine.nodes[i + 1] : nullptr;
+        }
+        magazine.nodes[0]->batch_size = static_cast<uint32_t>(BatchSize);
+        push_batch(magazine.nodes[0]);
+
+        for (size_t i = BatchSize; i < kMagazineCapacity; ++i) {
+            magazine.nodes[i - BatchSize] = magazine.nodes[i];
+        }
+        magazine.count -= BatchSize;
+    }
+
+    // Adds a chunk of at least kMinGrowNodes nodes (doubling the pool) and
+    // returns its first batch; the rest go to the depot.
+    Node* grow() {
+        std::lock_guard<std::mutex> lock(grow_mutex_);
+        if (Node* batch = pop_batch()) {
+            return batch;   // Another thread grew the pool meanwhile
+        }
+
+        const size_t count = total_nodes_ > kMinGrowNodes ? total_nodes_ : kMinGrowNodes;
+        Node* first = add_chunk(count);
+        heap_allocations_.fetch_add(1, std::memory_order_relaxed);
+
+        const size_t head_size = count < BatchSize ? count : BatchSize;
+        link_batch(first, head_size);
+        push_chunk(first + head_size, count - head_size);
+        return first;
+    }
+
+    // Caller holds grow_mutex_.
+    Node* add_chunk(size_t count) {
+        const size_t chunk = chunk_count_.load(std::memory_order_relaxed);
+        if (chunk == kMaxChunks || total_nodes_ + count >= kNullIndex) {
+            throw std::bad_alloc{};
+        }
+
+        size_t bytes = count * sizeof(Node);
+        void* memory = detail::allocate_pool_region(bytes, alignof(Node), options_, chunks_[chunk].region);
+        Node* nodes = static_cast<Node*>(memory);
+        for (size_t i = 0; i < count; ++i) {
+            new (&nodes[i]) Node();
+            nodes[i].index = static_cast<uint32_t>(total_nodes_ + i);
+        }
+        chunks_[chunk].nodes = nodes;
+        chunks_[chunk].first = static_cast<uint32_t>(total_nodes_);
+        total_nodes_ += count;
+        chunk_count_.store(chunk + 1, std::memory_order_release);
+        return nodes;
+    }
+
+    static void link_batch(Node* first, size_t count) noexcept {
+        for (size_t i = 0; i < count; ++i) {
+            first[i].next = i + 1 < count ? &first[i + 1] : nullptr;
+        }
+        first->batch_size = static_cast<uint32_t>(count);
+    }
+
+    void push_chunk(Node* first, size_t count) noexcept {
+        while (count != 0) {
+            const size_t size = count < BatchSize ? count : BatchSize;
+            link_batch(first, size);
+            push_batch(first);
+            first += size;
+            count -= size;
+        }
+    }
+
+    alignas(64) std::atomic<uint64_t> depot_{pack(kNullIndex, 0)};
+    std::atomic<size_t> heap_allocations_{0};
+
+    alignas(64) std::unique_ptr<Magazine[]> magazines_;
+    const MemoryPoolOptions options_;
+    Chunk chunks_[kMaxChunks];
+    std::atomic<size_t> chunk_count_{0};
+    size_t total_nodes_ = 0;
+    mutable std::mutex grow_mutex_;
 };
 
 } // namespace hft::core
\ No newline at end of file
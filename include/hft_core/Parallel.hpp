@@ -0,0 +1,173 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "hft_core/InlineTask.hpp"
+#include "hft_core/ThreadPool.hpp"
+
+namespace hft::core {
+
+// Data-parallel loops over [begin, end) on a ThreadPool. The range is cut
+// into chunks of `grain` indices (0 picks a grain giving ~8 chunks per
+// thread). Chunks are split recursively: each step posts the upper half and
+// keeps the lower one, so in WorkStealing mode the halves land in the local
+// deque and idle workers steal the biggest pieces first. The calling thread
+// works too and helps run queued tasks while it waits, so the algorithms may
+// be nested inside pool tasks. The first exception thrown by `fn` is
+// rethrown on the caller once all chunks have finished.
+
+namespace detail {
+
+inline size_t parallel_grain(const ThreadPool& pool, size_t count, size_t grain) noexcept {
+    if (grain != 0) {
+        return grain;
+    }
+    const size_t target = 8 * (pool.size() + 1);
+    return count / target > 0 ? count / target : 1;
+}
+
+template<typename Body>
+class ParallelChunks {
+public:
+    ParallelChunks(ThreadPool& pool, Body& body) noexcept : pool_(pool), body_(body) {}
+
+    void run(size_t chunks) {
+        split(0, chunks);
+        while (!pending_.try_wait()) {
+            if (!pool_.run_pending_task()) {
+                std::this_thread::yield();
+            }
+        }
+        pending_.wait();
+
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    void split(size_t first, size_t last) {
+        while (last - first > 1 && pool_.size() != 0) {
+            const size_t mid = first + (last - first) / 2;
+            pending_.add();
+            pool_.post([this, mid, last] {
+                split(mid, last);
+                pending_.count_down();
+            });
+            last = mid;
+        }
+
+        for (size_t chunk = first; chunk < last; ++chunk) {
+            if (failed_.load(std::memory_order_relaxed)) {
+                return;
+            }
+            try {
+                body_(chunk);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+                failed_.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    ThreadPool& pool_;
+    Body& body_;
+    CountdownLatch pending_;
+    std::atomic<bool> failed_{false};
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+};
+
+// Calls body(chunk) for every chunk in [0, chunks).
+template<typename Body>
+void parallel_chunks(ThreadPool& pool, size_t chunks, Body&& body) {
+    if (chunks == 0) {
+        return;
+    }
+    ParallelChunks<std::remove_reference_t<Body>> state(pool, body);
+    state.run(chunks);
+}
+
+} // namespace detail
+
+// fn(i) for every i in [begin, end).
+template<typename F>
+void parallel_for(ThreadPool& pool, size_t begin, size_t end, size_t grain, F&& fn) {
+    if (end <= begin) {
+        return;
+    }
+    const size_t count = end - begin;
+    const size_t step = detail::parallel_grain(pool, count, grain);
+    detail::parallel_chunks(pool, (count + step - 1) / step, [&](size_t chunk) {
+        const size_t first = begin + chunk * step;
+        const size_t last = end - first > step ? first + step : end;
+        for (size_t i = first; i < last; ++i) {
+            fn(i);
+        }
+    });
+}
+
+template<typename F>
+void parallel_for(ThreadPool& pool, size_t begin, size_t end, F&& fn) {
+    parallel_for(pool, begin, end, 0, std::forward<F>(fn));
+}
+
+// Folds map(i) over [begin, end) with `combine`, starting every chunk from
+// `identity`. Chunk results are combined in index order, so the result is
+// deterministic for any associative `combine`.
+template<typename T, typename Map, typename Combine>
+T parallel_reduce(ThreadPool& pool, size_t begin, size_t end, size_t grain, T identity,
+                  Map&& map, Combine&& combine) {
+    if (end <= begin) {
+        return identity;
+    }
+    const size_t count = end - begin;
+    const size_t step = detail::parallel_grain(pool, count, grain);
+    const size_t chunks = (count + step - 1) / step;
+
+    std::vector<T> partials(chunks, identity);
+    detail::parallel_chunks(pool, chunks, [&](size_t chunk) {
+        const size_t first = begin + chunk * step;
+        const size_t last = end - first > step ? first + step : end;
+        T accumulator = identity;
+        for (size_t i = first; i < last; ++i) {
+            accumulator = combine(std::move(accumulator), map(i));
+        }
+        partials[chunk] = std::move(accumulator);
+    });
+
+    T result = std::move(identity);
+    for (T& partial : partials) {
+        result = combine(std::move(result), std::move(partial));
+    }
+    return result;
+}
+
+// out[i] = op(in[i]) for the random-access range [first, last).
+template<typename InputIt, typename OutputIt, typename Op>
+OutputIt parallel_transform(ThreadPool& pool, InputIt first, InputIt last, OutputIt out,
+                            size_t grain, Op&& op) {
+    const auto count = static_cast<size_t>(std::distance(first, last));
+    parallel_for(pool, 0, count, grain, [&](size_t i) {
+        out[static_cast<std::ptrdiff_t>(i)] = op(first[static_cast<std::ptrdiff_t>(i)]);
+    });
+    return out + static_cast<std::ptrdiff_t>(count);
+}
+
+template<typename InputIt, typename OutputIt, typename Op>
+OutputIt parallel_transform(ThreadPool& pool, InputIt first, InputIt last, OutputIt out, Op&& op) {
+    return parallel_transform(pool, first, last, out, 0, std::forward<Op>(op));
+}
+
+} // namespace hft::core
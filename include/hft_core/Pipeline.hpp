@@ -0,0 +1,379 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "hft_core/InlineTask.hpp"
+#include "hft_core/RingBuffer.hpp"
+#include "hft_core/ThreadPool.hpp"
+#include "hft_core/Timer.hpp"
+#include "hft_core/Topology.hpp"
+
+namespace hft::core {
+
+struct StageOptions {
+    size_t queue_capacity = 1024;               // Inbound queue from each upstream stage
+    HighPriorityThreadPool* pool = nullptr;     // Run on (and occupy) one of its workers
+    int pool_worker = -1;                       // With pool: that worker (and its core), else any
+    int cpu = -1;                               // Otherwise a dedicated thread, pinned if >= 0
+    WaitStrategy wait_strategy = WaitStrategy::Yield;
+    uint32_t spin_budget = 2048;
+    bool track_latency = true;                  // Time every call for latency_ns
+};
+
+struct StageStats {
+    std::string name;
+    uint64_t processed = 0;         // Items produced (sources) or handled
+    uint64_t filtered = 0;          // Handled items the stage chose not to forward
+    uint64_t backpressure = 0;      // Times an outbound queue was full
+    uint64_t elapsed_ns = 0;        // Since start(), frozen when the stage finishes
+    std::array<uint64_t, 64> latency_ns{};  // Per call, log2 buckets
+
+    double throughput() const noexcept {
+        return elapsed_ns ? static_cast<double>(processed) * 1e9 / static_cast<double>(elapsed_ns) : 0.0;
+    }
+
+    uint64_t latency_quantile(double q) const noexcept {
+        return detail::log2_quantile(latency_ns, q);
+    }
+};
+
+// Streaming DAG of stages over items of type T. A source produces items
+// until it returns false; every other stage gets each item its upstream
+// stages forward, may modify it in place, and returns true to forward it to
+// all of its own downstream stages (copies for fan-out). Each stage runs on
+// one thread and every edge is a bounded SPSC ring, so a slow stage pushes
+// back on its producers instead of growing a queue. Stages may only depend
+// on stages added before them, which keeps the graph acyclic.
+template<typename T>
+class Pipeline {
+public:
+    using StageId = size_t;
+    using SourceFn = std::function<bool(T&)>;
+    using StageFn = std::function<bool(T&)>;
+
+    Pipeline() = default;
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    ~Pipeline() {
+        stop();
+        wait();
+    }
+
+    StageId add_source(std::string name, SourceFn produce, const StageOptions& options = {}) {
+        return add(std::move(name), std::move(produce), {}, options, true);
+    }
+
+    StageId add_stage(std::string name, StageFn fn, const std::vector<StageId>& upstream,
+                      const StageOptions& options = {}) {
+        if (upstream.empty()) {
+            throw std::invalid_argument("pipeline stage needs at least one upstream stage");
+        }
+        return add(std::move(name), std::move(fn), upstream, options, false);
+    }
+
+    // Throws std::logic_error if pool stages need more workers than their
+    // pool has, or two of them ask for the same worker: a stage holds its
+    // worker until it finishes, so the surplus would never start.
+    void start() {
+        if (started_) {
+            throw std::logic_error("pipeline already started");
+        }
+        check_pool_stages();
+        CpuTopology::system();              // Detect here, not on each stage thread
+        started_ = true;
+        start_ns_ = Timer::nanos_since_epoch();
+        running_.add(stages_.size());
+
+        // Pinned pool stages first, so no unpinned one takes their worker.
+        for (auto& owned : stages_) {
+            Stage* stage = owned.get();
+            if (stage->options.pool && stage->options.pool_worker >= 0) {
+                stage->options.pool->post_to_worker(static_cast<size_t>(stage->options.pool_worker),
+                                                    [this, stage] { run(*stage); });
+            }
+        }
+        for (auto& owned : stages_) {
+            Stage* stage = owned.get();
+            if (stage->options.pool) {
+                if (stage->options.pool_worker < 0) {
+                    stage->options.pool->post([this, stage] { run(*stage); });
+                }
+            } else {
+                threads_.emplace_back([this, stage] {
+                    if (stage->options.cpu >= 0) {
+                        place_current_thread(stage->options.cpu, true);
+                    }
+                    run(*stage);
+                });
+            }
+        }
+    }
+
+    // Blocks until every stage has finished: all sources are exhausted and
+    // their items drained, or stop() was called.
+    void wait() {
+        if (!started_) {
+            return;
+        }
+        running_.wait();
+        for (auto& thread : threads_) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+
+    // Asks every stage to finish promptly; queued items may be discarded.
+    void stop() noexcept {
+        stop_.store(true, std::memory_order_release);
+        for (auto& stage : stages_) {
+            stage->waiter.notify();
+        }
+    }
+
+    size_t stage_count() const noexcept {
+        return stages_.size();
+    }
+
+    StageStats stats(StageId id) const {
+        const Stage& stage = *stages_.at(id);
+        StageStats stats;
+        stats.name = stage.name;
+        stats.processed = stage.processed.load(std::memory_order_relaxed);
+        stats.filtered = stage.filtered.load(std::memory_order_relaxed);
+        stats.backpressure = stage.backpressure.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < stats.latency_ns.size(); ++i) {
+            stats.latency_ns[i] = stage.latency_ns[i].load(std::memory_order_relaxed);
+        }
+        if (started_) {
+            const uint64_t finished = stage.finished_ns.load(std::memory_order_acquire);
+            stats.elapsed_ns = (finished ? finished : Timer::nanos_since_epoch()) - start_ns_;
+        }
+        return stats;
+    }
+
+private:
+    struct Stage;
+
+    struct Edge {
+        explicit Edge(size_t capacity, Stage* target) : queue(capacity), consumer(target) {}
+
+        SPSCRingBuffer<T> queue;
+        Stage* consumer;
+    };
+
+    struct Stage {
+        std::string name;
+        StageFn fn;
+        StageOptions options;
+        bool source = false;
+        std::vector<Stage*> upstream;
+        std::vector<Edge*> inbound;
+        std::vector<Edge*> outbound;
+
+        std::atomic<bool> done{false};
+        Waiter waiter;
+        std::atomic<uint64_t> processed{0};
+        std::atomic<uint64_t> filtered{0};
+        std::atomic<uint64_t> backpressure{0};
+        std::atomic<uint64_t> finished_ns{0};
+        std::array<std::atomic<uint64_t>, 64> latency_ns{};
+    };
+
+    static constexpr size_t kDrainBatch = 64;
+
+    StageId add(std::string name, StageFn fn, const std::vector<StageId>& upstream,
+                const StageOptions& options, bool source) {
+        if (started_) {
+            throw std::logic_error("cannot add stages to a running pipeline");
+        }
+
+        if (options.pool && options.pool_worker >= static_cast<int>(options.pool->size())) {
+            throw std::invalid_argument("pipeline stage pool_worker out of range");
+        }
+
+        auto stage = std::make_unique<Stage>();
+        stage->name = std::move(name);
+        stage->fn = std::move(fn);
+        stage->options = options;
+        stage->source = source;
+        stage->waiter.configure(options.wait_strategy, options.spin_budget);
+
+        for (StageId id : upstream) {
+            if (id >= stages_.size()) {
+                throw std::invalid_argument("pipeline upstream stage does not exist yet");
+            }
+            Stage* producer = stages_[id].get();
+            edges_.push_back(std::make_unique<Edge>(options.queue_capacity, stage.get()));
+            producer->outbound.push_back(edges_.back().get());
+            stage->inbound.push_back(edges_.back().get());
+            stage->upstream.push_back(producer);
+        }
+
+        stages_.push_back(std::move(stage));
+        return stages_.size() - 1;
+    }
+
+    void check_pool_stages() const {
+        struct Usage {
+            const HighPriorityThreadPool* pool;
+            size_t stages = 0;
+            std::vector<bool> pinned;
+        };
+        std::vector<Usage> usage;
+        for (const auto& stage : stages_) {
+            const HighPriorityThreadPool* pool = stage->options.pool;
+            if (!pool) {
+                continue;
+            }
+            auto it = std::find_if(usage.begin(), usage.end(), [pool](const Usage& u) { return u.pool == pool; });
+            if (it == usage.end()) {
+                usage.push_back(Usage{pool, 0, std::vector<bool>(pool->size(), false)});
+                it = usage.end() - 1;
+            }
+            if (++it->stages > pool->size()) {
+                throw std::logic_error("pipeline has more stages on a pool than the pool has workers");
+            }
+            if (stage->options.pool_worker >= 0) {
+                const auto worker = static_cast<size_t>(stage->options.pool_worker);
+                if (it->pinned[worker]) {
+                    throw std::logic_error("two pipeline stages pinned to the same pool worker");
+                }
+                it->pinned[worker] = true;
+            }
+        }
+    }
+
+    void run(Stage& stage) {
+        if (stage.source) {
+            run_source(stage);
+        } else {
+            run_stage(stage);
+        }
+        finish(stage);
+    }
+
+    void run_source(Stage& stage) {
+        while (!stop_.load(std::memory_order_acquire)) {
+            T item{};
+            const uint64_t begin = stage.options.track_latency ? Timer::nanos_since_epoch() : 0;
+            const bool produced = stage.fn(item);
+            if (stage.options.track_latency) {
+                detail::log2_record(stage.latency_ns, Timer::nanos_since_epoch() - begin);
+            }
+            if (!produced) {
+                return;
+            }
+            stage.processed.fetch_add(1, std::memory_order_relaxed);
+            emit(stage, item);
+        }
+    }
+
+    void run_stage(Stage& stage) {
+        for (;;) {
+            size_t handled = 0;
+            for (Edge* edge : stage.inbound) {
+                handled += edge->queue.consume_batch([&](T& item) { handle(stage, item); }, kDrainBatch);
+            }
+            if (handled != 0) {
+                continue;
+            }
+
+            if (stop_.load(std::memory_order_acquire)) {
+                return;
+            }
+            if (upstream_done(stage)) {
+                // Everything upstream is published; one last drain.
+                for (Edge* edge : stage.inbound) {
+                    while (edge->queue.consume_batch([&](T& item) { handle(stage, item); }, kDrainBatch) != 0) {
+                    }
+                }
+                return;
+            }
+            stage.waiter.wait([&] {
+                return stop_.load(std::memory_order_acquire) || upstream_done(stage) || has_input(stage);
+            });
+        }
+    }
+
+    void handle(Stage& stage, T& item) {
+        const uint64_t begin = stage.options.track_latency ? Timer::nanos_since_epoch() : 0;
+        const bool forward = stage.fn(item);
+        if (stage.options.track_latency) {
+            detail::log2_record(stage.latency_ns, Timer::nanos_since_epoch() - begin);
+        }
+        stage.processed.fetch_add(1, std::memory_order_relaxed);
+        if (forward) {
+            emit(stage, item);
+        } else {
+            stage.filtered.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void emit(Stage& stage, T& item) {
+        const size_t count = stage.outbound.size();
+        for (size_t i = 0; i < count; ++i) {
+            Edge* edge = stage.outbound[i];
+            bool pushed = i + 1 == count ? edge->queue.try_push(std::move(item))
+                                         : edge->queue.try_push(item);
+            while (!pushed) {
+                stage.backpressure.fetch_add(1, std::memory_order_relaxed);
+                if (stop_.load(std::memory_order_acquire)) {
+                    return;
+                }
+                std::this_thread::yield();
+                pushed = i + 1 == count ? edge->queue.try_push(std::move(item))
+                                        : edge->queue.try_push(item);
+            }
+            edge->consumer->waiter.notify();
+        }
+    }
+
+    static bool upstream_done(const Stage& stage) noexcept {
+        for (const Stage* producer : stage.upstream) {
+            if (!producer->done.load(std::memory_order_acquire)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool has_input(const Stage& stage) noexcept {
+        for (const Edge* edge : stage.inbound) {
+            if (!edge->queue.empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void finish(Stage& stage) {
+        stage.finished_ns.store(Timer::nanos_since_epoch(), std::memory_order_release);
+        stage.done.store(true, std::memory_order_release);
+        for (Edge* edge : stage.outbound) {
+            edge->consumer->waiter.notify();
+        }
+        running_.count_down();
+    }
+
+    std::vector<std::unique_ptr<Stage>> stages_;
+    std::vector<std::unique_ptr<Edge>> edges_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> stop_{false};
+    bool started_ = false;
+    uint64_t start_ns_ = 0;
+    CountdownLatch running_;
+};
+
+} // namespace hft::core
@@ -0,0 +1,610 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace hft::core {
+
+inline constexpr size_t kCacheLineSize = 64;
+
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+inline constexpr size_t round_up_pow2(size_t value) noexcept {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+enum class WaitStrategy {
+    BusySpin,   // Spin on the queue with cpu_relax(), never leave the core
+    Yield,      // Spin for the budget, then std::this_thread::yield()
+    Block       // Spin for the budget, then park on a condition variable
+};
+
+// Consumer-side idle handling shared by the lock-free queues. Producers call
+// notify() after publishing; it only takes the mutex when a consumer is
+// actually parked, so the common case costs a fence and a relaxed load.
+class Waiter {
+public:
+    explicit Waiter(WaitStrategy strategy = WaitStrategy::Block,
+                    uint32_t spin_budget = 2048) noexcept
+        : strategy_(strategy), spin_budget_(spin_budget) {}
+
+    void configure(WaitStrategy strategy, uint32_t spin_budget) noexcept {
+        strategy_ = strategy;
+        spin_budget_ = spin_budget;
+    }
+
+    WaitStrategy strategy() const noexcept {
+        return strategy_;
+    }
+
+    template<typename Predicate>
+    void wait(Predicate ready) {
+        for (uint32_t i = 0; i < spin_budget_ || strategy_ == WaitStrategy::BusySpin; ++i) {
+            if (ready()) {
+                return;
+            }
+            cpu_relax();
+        }
+
+        if (strategy_ == WaitStrategy::Yield) {
+            while (!ready()) {
+                std::this_thread::yield();
+            }
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        cv_.wait(lock, ready);
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notify() noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) != 0) {
+            { std::lock_guard<std::mutex> lock(mutex_); }
+            cv_.notify_all();
+        }
+    }
+
+private:
+    WaitStrategy strategy_;
+    uint32_t spin_budget_;
+    std::atomic<uint32_t> sleepers_{0};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+// Bounded single-producer/single-consumer queue. Elements are constructed in
+// place in preallocated slots; each side caches the other's index so the
+// shared cache lines are only touched when the cached view runs out.
+template<typename T>
+class SPSCRingBuffer {
+public:
+    explicit SPSCRingBuffer(size_t capacity)
+        : mask_(round_up_pow2(capacity < 2 ? 2 : capacity) - 1),
+          slots_(new Slot[mask_ + 1]) {}
+
+    SPSCRingBuffer(const SPSCRingBuffer&) = delete;
+    SPSCRingBuffer& operator=(const SPSCRingBuffer&) = delete;
+
+    ~SPSCRingBuffer() {
+        while (consume_one([](T&) {})) {
+        }
+    }
+
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ > mask_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_) {
+                return false;
+            }
+        }
+
+        new (slots_[tail & mask_].data) T(std::forward<Args>(args)...);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& value) {
+        return try_emplace(value);
+    }
+
+    bool try_push(T&& value) {
+        return try_emplace(std::move(value));
+    }
+
+    bool try_pop(T& out) {
+        return consume_one([&out](T& value) { out = std::move(value); });
+    }
+
+    // Invokes f on the oldest element in place, then destroys it and frees
+    // the slot. The slot is released only after f returns.
+    template<typename F>
+    bool consume_one(F&& f) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+
+        T* value = slot_ptr(head);
+        f(*value);
+        value->~T();
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumes up to max_count elements with a single release of the head
+    // index at the end. Returns the number consumed.
+    template<typename F>
+    size_t consume_batch(F&& f, size_t max_count) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (cached_tail_ - head < max_count) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+        }
+
+        size_t available = cached_tail_ - head;
+        const size_t count = available < max_count ? available : max_count;
+        for (size_t i = 0; i < count; ++i) {
+            T* value = slot_ptr(head + i);
+            f(*value);
+            value->~T();
+        }
+
+        if (count != 0) {
+            head_.store(head + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    bool empty() const noexcept {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    size_t size() const noexcept {
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    size_t capacity() const noexcept {
+        return mask_ + 1;
+    }
+
+private:
+    struct Slot {
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    T* slot_ptr(size_t index) noexcept {
+        return std::launder(reinterpret_cast<T*>(slots_[index & mask_].data));
+    }
+
+    alignas(kCacheLineSize) std::atomic<size_t> head_{0};
+    size_t cached_tail_ = 0;
+
+    alignas(kCacheLineSize) std::atomic<size_t> tail_{0};
+    size_t cached_head_ = 0;
+
+    alignas(kCacheLineSize) const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+};
+
+// Bounded multi-producer/single-consumer queue (Vyukov-style per-slot
+// sequence numbers). Producers claim a slot with one CAS on the tail and
+// publish it with a release store of the slot's sequence.
+template<typename T>
+class MPSCRingBuffer {
+public:
+    explicit MPSCRingBuffer(size_t capacity)
+        : mask_(round_up_pow2(capacity < 2 ? 2 : capacity) - 1),
+          cells_(new Cell[mask_ + 1]) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPSCRingBuffer(const MPSCRingBuffer&) = delete;
+    MPSCRingBuffer& operator=(const MPSCRingBuffer&) = delete;
+
+    ~MPSCRingBuffer() {
+        while (consume_one([](T&) {})) {
+        }
+    }
+
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+
+        // The slot is already claimed, so a throwing constructor must still
+        // publish it; the consumer skips slots that were never constructed.
+        try {
+            new (cell->data) T(std::forward<Args>(args)...);
+            cell->constructed = true;
+        } catch (...) {
+            cell->constructed = false;
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            throw;
+        }
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& value) {
+        return try_emplace(value);
+    }
+
+    bool try_push(T&& value) {
+        return try_emplace(std::move(value));
+    }
+
+    bool try_pop(T& out) {
+        return consume_one([&out](T& value) { out = std::move(value); });
+    }
+
+    // Consumer side only. See SPSCRingBuffer::consume_one.
+    template<typename F>
+    bool consume_one(F&& f) {
+        const size_t pos = head_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[pos & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+            return false;
+        }
+
+        if (cell.constructed) {
+            T* value = std::launder(reinterpret_cast<T*>(cell.data));
+            f(*value);
+            value->~T();
+        }
+        cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+        head_.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side only. See SPSCRingBuffer::consume_batch.
+    template<typename F>
+    size_t consume_batch(F&& f, size_t max_count) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        size_t count = 0;
+        for (; count < max_count; ++count) {
+            const size_t pos = head + count;
+            Cell& cell = cells_[pos & mask_];
+            if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+                break;
+            }
+            if (cell.constructed) {
+                T* value = std::launder(reinterpret_cast<T*>(cell.data));
+                f(*value);
+                value->~T();
+            }
+            cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+        }
+
+        if (count != 0) {
+            head_.store(head + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    bool empty() const noexcept {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    size_t size() const noexcept {
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const noexcept {
+        return mask_ + 1;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        bool constructed;
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    alignas(kCacheLineSize) std::atomic<size_t> head_{0};
+    alignas(kCacheLineSize) std::atomic<size_t> tail_{0};
+    alignas(kCacheLineSize) const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+};
+
+// Bounded multi-producer/multi-consumer queue: MPSCRingBuffer with the
+// head claimed by CAS as well, so any number of consumers may pop.
+template<typename T>
+class MPMCRingBuffer {
+public:
+    explicit MPMCRingBuffer(size_t capacity)
+        : mask_(round_up_pow2(capacity < 2 ? 2 : capacity) - 1),
+          cells_(new Cell[mask_ + 1]) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPMCRingBuffer(const MPMCRingBuffer&) = delete;
+    MPMCRingBuffer& operator=(const MPMCRingBuffer&) = delete;
+
+    ~MPMCRingBuffer() {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        for (size_t pos = head_.load(std::memory_order_relaxed); pos != tail; ++pos) {
+            Cell& cell = cells_[pos & mask_];
+            if (cell.constructed) {
+                std::launder(reinterpret_cast<T*>(cell.data))->~T();
+            }
+        }
+    }
+
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+
+        // See MPSCRingBuffer::try_emplace.
+        try {
+            new (cell->data) T(std::forward<Args>(args)...);
+            cell->constructed = true;
+        } catch (...) {
+            cell->constructed = false;
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            throw;
+        }
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& value) {
+        return try_emplace(value);
+    }
+
+    bool try_push(T&& value) {
+        return try_emplace(std::move(value));
+    }
+
+    // Moves the oldest element out; the slot is released before returning,
+    // so a long-running consumer does not hold up producers.
+    bool try_pop(T& out) {
+        for (;;) {
+            size_t pos = head_.load(std::memory_order_relaxed);
+            Cell* cell;
+            for (;;) {
+                cell = &cells_[pos & mask_];
+                const size_t seq = cell->sequence.load(std::memory_order_acquire);
+                const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+                if (diff == 0) {
+                    if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = head_.load(std::memory_order_relaxed);
+                }
+            }
+
+            const bool constructed = cell->constructed;
+            if (constructed) {
+                T* value = std::launder(reinterpret_cast<T*>(cell->data));
+                out = std::move(*value);
+                value->~T();
+            }
+            cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+            if (constructed) {
+                return true;
+            }
+        }
+    }
+
+    bool empty() const noexcept {
+        return head_.load(std::memory_order_acquire) >= tail_.load(std::memory_order_acquire);
+    }
+
+    size_t size() const noexcept {
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const noexcept {
+        return mask_ + 1;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        bool constructed;
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    alignas(kCacheLineSize) std::atomic<size_t> head_{0};
+    alignas(kCacheLineSize) std::atomic<size_t> tail_{0};
+    alignas(kCacheLineSize) const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+};
+
+// Chase-Lev work-stealing deque. The owning thread pushes and pops at the
+// bottom (LIFO); any other thread may steal from the top (FIFO). The array
+// doubles when full; retired arrays are kept until the deque is destroyed
+// because a thief may still be reading from one. T must be trivially
+// copyable, typically a pointer.
+template<typename T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque stores T in atomics");
+
+public:
+    explicit WorkStealingDeque(size_t capacity = 256) {
+        arrays_.push_back(std::make_unique<Array>(round_up_pow2(capacity < 2 ? 2 : capacity)));
+        array_.store(arrays_.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner only.
+    void push(T value) {
+        const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        const int64_t top = top_.load(std::memory_order_acquire);
+        Array* array = array_.load(std::memory_order_relaxed);
+        if (bottom - top > static_cast<int64_t>(array->mask)) {
+            array = grow(array, top, bottom);
+        }
+        array->put(bottom, value);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only. Takes the most recently pushed element.
+    bool pop(T& out) {
+        const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* array = array_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        out = array->get(bottom);
+        if (top == bottom) {
+            // Last element: race the thieves for it.
+            const bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                          std::memory_order_relaxed);
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread. Takes the oldest element; returns false when the deque is
+    // empty or another thread won the race for it.
+    bool steal(T& out) {
+        int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return false;
+        }
+
+        Array* array = array_.load(std::memory_order_acquire);
+        const T value = array->get(top);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return false;
+        }
+        out = value;
+        return true;
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    size_t size() const noexcept {
+        const int64_t bottom = bottom_.load(std::memory_order_acquire);
+        const int64_t top = top_.load(std::memory_order_acquire);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+
+    size_t capacity() const noexcept {
+        return array_.load(std::memory_order_acquire)->mask + 1;
+    }
+
+private:
+    struct Array {
+        explicit Array(size_t capacity)
+            : mask(capacity - 1), slots(new std::atomic<T>[capacity]) {}
+
+        T get(int64_t index) const noexcept {
+            return slots[static_cast<size_t>(index) & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t index, T value) noexcept {
+            slots[static_cast<size_t>(index) & mask].store(value, std::memory_order_relaxed);
+        }
+
+        const size_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+    Array* grow(Array* old, int64_t top, int64_t bottom) {
+        auto bigger = std::make_unique<Array>((old->mask + 1) * 2);
+        for (int64_t i = top; i < bottom; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        Array* array = bigger.get();
+        arrays_.push_back(std::move(bigger));
+        array_.store(array, std::memory_order_release);
+        return array;
+    }
+
+    alignas(kCacheLineSize) std::atomic<int64_t> top_{0};
+    alignas(kCacheLineSize) std::atomic<int64_t> bottom_{0};
+    alignas(kCacheLineSize) std::atomic<Array*> array_{nullptr};
+    std::vector<std::unique_ptr<Array>> arrays_;    // Owner only
+};
+
+} // namespace hft::core
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+#include "hft_core/MemoryPool.hpp"
+
+namespace hft::core {
+
+struct SlabAllocatorOptions {
+    size_t region_size = 64 * 1024;     // Bytes carved per refill of a size class
+    MemoryPoolOptions memory;           // Backing for the regions (huge pages, ...)
+};
+
+struct SlabClassStats {
+    size_t block_size = 0;
+    size_t capacity = 0;        // Blocks carved for this class so far
+    size_t in_use = 0;
+    size_t high_water = 0;      // Peak of in_use
+};
+
+// Power-of-two size classes from 8 B to 4 KiB, each an intrusive free list
+// over MemoryPool-style regions. Blocks are recycled within their class and
+// regions are only returned on destruction, so a container that has reached
+// its steady-state size no longer allocates. Larger or over-aligned (> 64)
+// requests go to the upstream resource.
+//
+// Not thread-safe, like MemoryPool; give each thread its own instance.
+class SlabAllocator : public std::pmr::memory_resource {
+public:
+    static constexpr size_t kMinBlockSize = 8;
+    static constexpr size_t kMaxBlockSize = 4096;
+    static constexpr size_t kMaxAlignment = 64;
+    static constexpr size_t kClassCount = 10;
+
+    explicit SlabAllocator(const SlabAllocatorOptions& options = {},
+                           std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+    SlabAllocator(const SlabAllocator&) = delete;
+    SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+    ~SlabAllocator() override;
+
+    // Index of the class serving a request, or kClassCount if it goes upstream.
+    static constexpr size_t class_index(size_t bytes, size_t alignment) noexcept {
+        const size_t size = bytes > alignment ? bytes : alignment;
+        if (size > kMaxBlockSize || alignment > kMaxAlignment) {
+            return kClassCount;
+        }
+        size_t index = 0;
+        while ((kMinBlockSize << index) < size) {
+            ++index;
+        }
+        return index;
+    }
+
+    // Carves at least `count` free blocks for requests of `bytes`.
+    void reserve(size_t bytes, size_t count);
+
+    SlabClassStats class_stats(size_t index) const noexcept {
+        return classes_[index].stats;
+    }
+
+    std::vector<SlabClassStats> stats() const;
+
+    // Requests that bypassed the size classes.
+    size_t upstream_allocations() const noexcept {
+        return upstream_allocations_;
+    }
+
+    std::pmr::memory_resource* upstream() const noexcept {
+        return upstream_;
+    }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        const size_t index = class_index(bytes, alignment);
+        if (index == kClassCount) {
+            ++upstream_allocations_;
+            return upstream_->allocate(bytes, alignment);
+        }
+
+        SizeClass& size_class = classes_[index];
+        if (!size_class.free_list) {
+            refill(index, 1);
+        }
+        FreeBlock* block = size_class.free_list;
+        size_class.free_list = block->next;
+
+        SlabClassStats& stats = size_class.stats;
+        if (++stats.in_use > stats.high_water) {
+            stats.high_water = stats.in_use;
+        }
+        return block;
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        const size_t index = class_index(bytes, alignment);
+        if (index == kClassCount) {
+            upstream_->deallocate(ptr, bytes, alignment);
+            return;
+        }
+
+        SizeClass& size_class = classes_[index];
+        auto* block = static_cast<FreeBlock*>(ptr);
+        block->next = size_class.free_list;
+        size_class.free_list = block;
+        --size_class.stats.in_use;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct SizeClass {
+        FreeBlock* free_list = nullptr;
+        SlabClassStats stats;
+    };
+
+    void refill(size_t index, size_t min_blocks);
+
+    const SlabAllocatorOptions options_;
+    std::pmr::memory_resource* const upstream_;
+    SizeClass classes_[kClassCount];
+    detail::PoolRegion* regions_ = nullptr;
+    size_t upstream_allocations_ = 0;
+};
+
+// STL Allocator over a SlabAllocator, for containers that are not pmr-aware:
+//   std::vector<Fill, SlabStlAllocator<Fill>> fills{SlabStlAllocator<Fill>(slab)};
+template<typename T>
+class SlabStlAllocator {
+public:
+    using value_type = T;
+
+    explicit SlabStlAllocator(SlabAllocator& slab) noexcept : slab_(&slab) {}
+
+    template<typename U>
+    SlabStlAllocator(const SlabStlAllocator<U>& other) noexcept : slab_(other.slab()) {}
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length{};
+        }
+        return static_cast<T*>(slab_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        slab_->deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+    SlabAllocator* slab() const noexcept {
+        return slab_;
+    }
+
+    template<typename U>
+    bool operator==(const SlabStlAllocator<U>& other) const noexcept {
+        return slab_ == other.slab();
+    }
+
+    template<typename U>
+    bool operator!=(const SlabStlAllocator<U>& other) const noexcept {
+        return slab_ != other.slab();
+    }
+
+private:
+    SlabAllocator* slab_;
+};
+
+} // namespace hft::core
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace hft::core {
+
+// Minimal non-owning view over a contiguous sequence (std::span stand-in
+// for C++17 builds).
+template<typename T>
+class Span {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using pointer = T*;
+    using reference = T&;
+    using iterator = T*;
+    using size_type = size_t;
+
+    constexpr Span() noexcept = default;
+    constexpr Span(T* data, size_t size) noexcept : data_(data), size_(size) {}
+
+    template<size_t N>
+    constexpr Span(T (&array)[N]) noexcept : data_(array), size_(N) {}
+
+    template<typename U, size_t N,
+             typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+    constexpr Span(std::array<U, N>& array) noexcept : data_(array.data()), size_(N) {}
+
+    template<typename U, size_t N,
+             typename = std::enable_if_t<std::is_convertible_v<const U(*)[], T(*)[]>>>
+    constexpr Span(const std::array<U, N>& array) noexcept : data_(array.data()), size_(N) {}
+
+    template<typename U, typename Alloc,
+             typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+    Span(std::vector<U, Alloc>& vec) noexcept : data_(vec.data()), size_(vec.size()) {}
+
+    template<typename U, typename Alloc,
+             typename = std::enable_if_t<std::is_convertible_v<const U(*)[], T(*)[]>>>
+    Span(const std::vector<U, Alloc>& vec) noexcept : data_(vec.data()), size_(vec.size()) {}
+
+    template<typename U,
+             typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+    constexpr Span(const Span<U>& other) noexcept : data_(other.data()), size_(other.size()) {}
+
+    constexpr T* data() const noexcept { return data_; }
+    constexpr size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+
+    constexpr T& operator[](size_t index) const noexcept { return data_[index]; }
+    constexpr T& front() const noexcept { return data_[0]; }
+    constexpr T& back() const noexcept { return data_[size_ - 1]; }
+
+    constexpr T* begin() const noexcept { return data_; }
+    constexpr T* end() const noexcept { return data_ + size_; }
+
+    constexpr Span subspan(size_t offset, size_t count) const noexcept {
+        return Span(data_ + offset, count);
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace hft::core
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hft::core {
+
+namespace detail {
+
+template<typename T, typename... Ts>
+struct TypeSlot;
+
+template<typename T, typename... Ts>
+struct TypeSlot<T, T, Ts...> : std::integral_constant<size_t, 0> {};
+
+template<typename T, typename U, typename... Ts>
+struct TypeSlot<T, U, Ts...> : std::integral_constant<size_t, 1 + TypeSlot<T, Ts...>::value> {};
+
+template<typename T, typename... Ts>
+inline constexpr bool contains_type_v = (std::is_same_v<T, Ts> || ...);
+
+} // namespace detail
+
+// Event bus over a closed set of event types. Each type owns a compile-time
+// slot holding an immutable array of (function pointer, context) pairs.
+// Subscribing copies the array and swaps the slot pointer; publishing is a
+// single acquire load followed by direct calls, with no locks, no RTTI and
+// no std::function. Superseded arrays stay alive until the bus is destroyed
+// so in-flight publishers never observe freed memory.
+template<typename... Events>
+class StaticEventBus {
+public:
+    template<typename EventType>
+    using HandlerFunc = void (*)(void* context, const EventType& event);
+
+    template<typename EventType>
+    struct Handler {
+        HandlerFunc<EventType> func;
+        void* context;
+    };
+
+    template<typename EventType>
+    static constexpr size_t slot_index = detail::TypeSlot<EventType, Events...>::value;
+
+    StaticEventBus() = default;
+    StaticEventBus(const StaticEventBus&) = delete;
+    StaticEventBus& operator=(const StaticEventBus&) = delete;
+
+    template<typename EventType>
+    void subscribe(HandlerFunc<EventType> func, void* context = nullptr) {
+        auto& slot = get_slot<EventType>();
+
+        std::lock_guard<std::mutex> lock(subscribe_mutex_);
+        auto next = std::make_unique<HandlerList<EventType>>(*slot.current.load(std::memory_order_relaxed));
+        next->push_back(Handler<EventType>{func, context});
+        install(slot, std::move(next));
+    }
+
+    // Binds a member function at compile time: subscribe<Tick, &Strategy::on_tick>(&strategy)
+    template<typename EventType, auto Method, typename Object>
+    void subscribe(Object* object) {
+        subscribe<EventType>(&member_thunk<EventType, Object, Method>, object);
+    }
+
+    // Binds a callable by reference. The bus does not take ownership, so the
+    // callable must outlive its subscription.
+    template<typename EventType, typename Callable,
+             typename = std::enable_if_t<std::is_invocable_v<Callable&, const EventType&>>>
+    void subscribe(Callable& callable) {
+        subscribe<EventType>(&callable_thunk<EventType, Callable>, &callable);
+    }
+
+    template<typename EventType>
+    bool unsubscribe(HandlerFunc<EventType> func, void* context = nullptr) {
+        auto& slot = get_slot<EventType>();
+
+        std::lock_guard<std::mutex> lock(subscribe_mutex_);
+        auto next = std::make_unique<HandlerList<EventType>>(*slot.current.load(std::memory_order_relaxed));
+        for (auto it = next->begin(); it != next->end(); ++it) {
+            if (it->func == func && it->context == context) {
+                next->erase(it);
+                install(slot, std::move(next));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<typename EventType, auto Method, typename Object>
+    bool unsubscribe(Object* object) {
+        return unsubscribe<EventType>(&member_thunk<EventType, Object, Method>, object);
+    }
+
+    template<typename EventType, typename Callable,
+             typename = std::enable_if_t<std::is_invocable_v<Callable&, const EventType&>>>
+    bool unsubscribe(Callable& callable) {
+        return unsubscribe<EventType>(&callable_thunk<EventType, Callable>, &callable);
+    }
+
+    template<typename EventType>
+    void unsubscribe_all() {
+        auto& slot = get_slot<EventType>();
+
+        std::lock_guard<std::mutex> lock(subscribe_mutex_);
+        install(slot, std::make_unique<HandlerList<EventType>>());
+    }
+
+    template<typename EventType>
+    void publish(const EventType& event) const {
+        const auto& handlers = *get_slot<EventType>().current.load(std::memory_order_acquire);
+        for (const auto& handler : handlers) {
+            try {
+                handler.func(handler.context, event);
+            } catch (const std::exception& e) {
+                // Log error but continue processing other handlers
+            }
+        }
+    }
+
+    template<typename EventType, typename... Args>
+    void emit(Args&&... args) const {
+        const EventType event(std::forward<Args>(args)...);
+        publish(event);
+    }
+
+    template<typename EventType>
+    size_t handler_count() const noexcept {
+        return get_slot<EventType>().current.load(std::memory_order_acquire)->size();
+    }
+
+private:
+    template<typename EventType>
+    using HandlerList = std::vector<Handler<EventType>>;
+
+    template<typename EventType>
+    struct Slot {
+        Slot() : current(retired.emplace_back(std::make_unique<HandlerList<EventType>>()).get()) {}
+
+        std::vector<std::unique_ptr<HandlerList<EventType>>> retired;
+        std::atomic<const HandlerList<EventType>*> current;
+    };
+
+    template<typename EventType>
+    Slot<EventType>& get_slot() noexcept {
+        static_assert(detail::contains_type_v<EventType, Events...>,
+                      "EventType is not registered with this StaticEventBus");
+        return std::get<slot_index<EventType>>(slots_);
+    }
+
+    template<typename EventType>
+    const Slot<EventType>& get_slot() const noexcept {
+        static_assert(detail::contains_type_v<EventType, Events...>,
+                      "EventType is not registered with this StaticEventBus");
+        return std::get<slot_index<EventType>>(slots_);
+    }
+
+    template<typename EventType>
+    static void install(Slot<EventType>& slot, std::unique_ptr<HandlerList<EventType>> next) {
+        slot.current.store(next.get(), std::memory_order_release);
+        slot.retired.push_back(std::move(next));
+    }
+
+    template<typename EventType, typename Object, auto Method>
+    static void member_thunk(void* context, const EventType& event) {
+        (static_cast<Object*>(context)->*Method)(event);
+    }
+
+    template<typename EventType, typename Callable>
+    static void callable_thunk(void* context, const EventType& event) {
+        (*static_cast<Callable*>(context))(event);
+    }
+
+    std::tuple<Slot<Events>...> slots_;
+    std::mutex subscribe_mutex_;
+};
+
+} // namespace hft::core
@@ -0,0 +1,25 @@
+#pragma once
+
+namespace hft::core {
+
+// Makes `instance` the calling thread's current T (what T::current() and
+// the macros built on it resolve to) for the binding's lifetime, then
+// restores the previous one. T provides `static T* bind_thread(T*)`.
+//
+//   Logger core_logger;
+//   ThreadBinding<Logger> bind_logger(core_logger);
+//   LOG_INFO("pinned");             // goes to core_logger
+template<typename T>
+class ThreadBinding {
+public:
+    explicit ThreadBinding(T& instance) noexcept : previous_(T::bind_thread(&instance)) {}
+    ~ThreadBinding() { T::bind_thread(previous_); }
+
+    ThreadBinding(const ThreadBinding&) = delete;
+    ThreadBinding& operator=(const ThreadBinding&) = delete;
+
+private:
+    T* previous_;
+};
+
+} // namespace hft::core
@@ -9,9 +9,17 @@
 #include <future>
 #include <functional>
 #include <stdexcept>
+#include <array>
 #include <atomic>
 #include <type_traits>
 
+#include "hft_core/InlineTask.hpp"
+#include "hft_core/MemoryPool.hpp"
+#include "hft_core/RingBuffer.hpp"
+#include "hft_core/Timer.hpp"
+#include "hft_core/Topology.hpp"
+#include "hft_core/Trace.hpp"
+
 #ifdef __linux__
 #include <sched.h>
 #include <pthread.h>
@@ -20,33 +28,107 @@
 
 namespace hft::core {
 
-class ThreadPool {
+#ifdef __linux__
+inline void set_thread_affinity(std::thread& thread, int cpu_id) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu_id, &cpuset);
+    
+    int result = pthread_setaffinity_np(
+        thread.native_handle(), sizeof(cpu_set_t), &cpuset);
+    
+    if (result != 0) {
+        throw std::runtime_error("Failed to set thread affinity");
+    }
+}
+#endif
+
+namespace detail {
+
+// FIFO in one contiguous ring. It only ever grows (by doubling), so a
+// warmed-up queue never allocates. Not thread-safe.
+template<typename T>
+class TaskQueue {
 public:
-    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency()) 
-        : stop_(false) {
-        for (size_t i = 0; i < threads; ++i) {
-            workers_.emplace_back([this] {
-                for (;;) {
-                    std::function<void()> task;
-                    
-                    {
-                        std::unique_lock<std::mutex> lock(queue_mutex_);
-                        condition_.wait(lock, [this] { 
-                            return stop_.load() || !tasks_.empty(); 
-                        });
-                        
-                        if (stop_.load() && tasks_.empty()) {
-                            return;
-                        }
-                        
-                        task = std::move(tasks_.front());
-                        tasks_.pop();
-                    }
-                    
-                    task();
-                }
-            });
+    explicit TaskQueue(size_t capacity = 1024) : slots_(round_up_pow2(capacity < 2 ? 2 : capacity)) {}
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    size_t size() const noexcept {
+        return size_;
+    }
+
+    // Sequence numbers of the next push and pop: the n-th task pushed is
+    // the n-th popped.
+    uint64_t pushed() const noexcept {
+        return popped_ + size_;
+    }
+
+    uint64_t popped() const noexcept {
+        return popped_;
+    }
+
+    void push(T&& task) {
+        if (size_ == slots_.size()) {
+            grow();
         }
+        slots_[(head_ + size_) & (slots_.size() - 1)] = std::move(task);
+        ++size_;
+    }
+
+    T pop() noexcept {
+        T task = std::move(slots_[head_]);
+        head_ = (head_ + 1) & (slots_.size() - 1);
+        --size_;
+        ++popped_;
+        return task;
+    }
+
+private:
+    void grow() {
+        std::vector<T> bigger(slots_.size() * 2);
+        for (size_t i = 0; i < size_; ++i) {
+            bigger[i] = std::move(slots_[(head_ + i) & (slots_.size() - 1)]);
+        }
+        slots_.swap(bigger);
+        head_ = 0;
+    }
+
+    std::vector<T> slots_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+    uint64_t popped_ = 0;
+};
+
+} // namespace detail
+
+enum class SchedulingMode {
+    SharedQueue,    // One mutex-guarded FIFO shared by all workers
+    WorkStealing    // Per-worker Chase-Lev deques plus a shared injector queue
+};
+
+// In WorkStealing mode a task enqueued from one of the pool's own workers
+// goes to that worker's deque, where it is popped LIFO while the cache is
+// warm; tasks from other threads go to the injector. Idle workers take from
+// the injector, then steal from a random victim before parking.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency(),
+                        SchedulingMode mode = SchedulingMode::SharedQueue)
+        : stop_(false), mode_(mode) {
+        start_workers(threads, false);
+    }
+
+    // Pins worker i to the i-th CPU selected by `placement` (wrapping around
+    // if threads exceeds the selection); threads == 0 starts one worker per
+    // selected CPU. With placement.bind_memory the workers also prefer pages
+    // from their CPU's NUMA node, so the memory they first touch stays local.
+    explicit ThreadPool(const PlacementPolicy& placement, size_t threads = 0,
+                        SchedulingMode mode = SchedulingMode::SharedQueue)
+        : stop_(false), mode_(mode), worker_cpus_(select_worker_cpus(placement, threads)) {
+        start_workers(worker_cpus_.size(), placement.bind_memory);
     }
 
     template<class F, class... Args>
@@ -60,38 +142,38 @@ public:
         );
 
         std::future<return_type> res = task->get_future();
-        
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            
-            if (stop_.load()) {
-                throw std::runtime_error("enqueue on stopped ThreadPool");
-            }
-
-            tasks_.emplace([task]() { (*task)(); });
-        }
-        
-        condition_.notify_one();
+        submit([task]() { (*task)(); });
         return res;
     }
 
+    // Fire-and-forget submission without a future: the callable is stored
+    // inline in the queue (see InlineTask), so a warmed-up pool never
+    // allocates. Join with a CountdownLatch. The task must not throw.
+    template<class F>
+    void post(F&& f) {
+        submit(Task(std::forward<F>(f)));
+    }
+
+    // Like enqueue(), but the task runs inside an ArenaScope over the worker's
+    // thread-local Arena: Arena::current() is valid for its duration and
+    // everything allocated from it is released when the task returns.
+    template<class F, class... Args>
+    auto enqueue_in_arena(F&& f, Args&&... args)
+        -> std::future<typename std::invoke_result<F, Args...>::type> {
+        auto bound = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
+        return enqueue([bound = std::move(bound)]() mutable {
+            ArenaScope scope;
+            return bound();
+        });
+    }
+
 #ifdef __linux__
     void set_thread_affinity(size_t thread_idx, int cpu_id) {
         if (thread_idx >= workers_.size()) {
             throw std::out_of_range("Thread index out of range");
         }
         
-        cpu_set_t cpuset;
-        CPU_ZERO(&cpuset);
-        CPU_SET(cpu_id, &cpuset);
-        
-        int result = pthread_setaffinity_np(
-            workers_[thread_idx].native_handle(),
-            sizeof(cpu_set_t), &cpuset);
-        
-        if (result != 0) {
-            throw std::runtime_error("Failed to set thread affinity");
-        }
+        hft::core::set_thread_affinity(workers_[thread_idx], cpu_id);
     }
 #endif
 
@@ -100,13 +182,60 @@ public:
     }
 
     size_t pending_tasks() const noexcept {
+        if (mode_ == SchedulingMode::WorkStealing) {
+            return queued_.load(std::memory_order_acquire);
+        }
         std::lock_guard<std::mutex> lock(queue_mutex_);
         return tasks_.size();
     }
 
+    SchedulingMode scheduling_mode() const noexcept {
+        return mode_;
+    }
+
+    // Runs one queued task on the calling thread, if there is one. Lets a
+    // thread that waits for work it submitted help instead of blocking,
+    // which also keeps nested waits inside workers from deadlocking.
+    bool run_pending_task() {
+        if (mode_ == SchedulingMode::WorkStealing) {
+            WorkerContext& self = current_worker();
+            const size_t index = self.pool == this ? self.index : kNotAWorker;
+            Task* task = find_task(index, self.seed);
+            if (!task) {
+                return false;
+            }
+            run_stolen(task);
+            return true;
+        }
+
+        Task task;
+        [[maybe_unused]] uint64_t task_id = 0;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            if (tasks_.empty()) {
+                return false;
+            }
+            task_id = tasks_.popped();
+            task = tasks_.pop();
+        }
+        HFT_TRACE_SCOPE(TraceProbe::TaskBegin, TraceProbe::TaskEnd, task_id);
+        task();
+        return true;
+    }
+
+    // CPU each worker was pinned to by the placement constructor; empty for
+    // unpinned pools.
+    const std::vector<int>& worker_cpus() const noexcept {
+        return worker_cpus_;
+    }
+
     ~ThreadPool() {
-        stop_.store(true);
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            stop_.store(true);
+        }
         condition_.notify_all();
+        idle_.notify();
         
         for (std::thread& worker : workers_) {
             if (worker.joinable()) {
@@ -116,55 +245,404 @@ public:
     }
 
 private:
+    using Task = InlineTask;
+
+    static constexpr size_t kNotAWorker = ~size_t(0);
+
+    struct WorkerContext {
+        const ThreadPool* pool = nullptr;
+        size_t index = 0;
+        uint64_t seed = 0x9E3779B97F4A7C15ull;  // Victim selection
+    };
+
+    static WorkerContext& current_worker() noexcept {
+        static thread_local WorkerContext context;
+        return context;
+    }
+
+    void start_workers(size_t threads, bool bind_memory) {
+        if (mode_ == SchedulingMode::WorkStealing) {
+            task_nodes_ = std::make_unique<LockFreeMemoryPool<Task>>(kInitialTaskNodes);
+            for (size_t i = 0; i < threads; ++i) {
+                deques_.push_back(std::make_unique<WorkStealingDeque<Task*>>());
+            }
+        }
+
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this, i, bind_memory] {
+                if (!worker_cpus_.empty()) {
+                    place_current_thread(worker_cpus_[i], bind_memory);
+                }
+                if (mode_ == SchedulingMode::WorkStealing) {
+                    stealing_worker_loop(i);
+                } else {
+                    worker_loop();
+                }
+            });
+        }
+    }
+
+    void submit(Task task) {
+        if (mode_ == SchedulingMode::SharedQueue) {
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex_);
+                
+                if (stop_.load()) {
+                    throw std::runtime_error("enqueue on stopped ThreadPool");
+                }
+
+                HFT_TRACE(TraceProbe::TaskEnqueue, tasks_.pushed());
+                tasks_.push(std::move(task));
+            }
+            
+            condition_.notify_one();
+            return;
+        }
+
+        if (stop_.load()) {
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+        }
+
+        Task* owned = new (task_nodes_->allocate()) Task(std::move(task));
+        HFT_TRACE(TraceProbe::TaskEnqueue, reinterpret_cast<uintptr_t>(owned));
+        // Counted before it becomes visible, so the count never underflows.
+        queued_.fetch_add(1, std::memory_order_seq_cst);
+
+        const WorkerContext& self = current_worker();
+        if (self.pool == this) {
+            deques_[self.index]->push(owned);
+        } else {
+            std::lock_guard<std::mutex> lock(injector_mutex_);
+            injector_.push(std::move(owned));
+            injector_size_.store(injector_.size(), std::memory_order_release);
+        }
+        idle_.notify();
+    }
+
+    void worker_loop() {
+        for (;;) {
+            Task task;
+            [[maybe_unused]] uint64_t task_id = 0;
+            
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex_);
+                condition_.wait(lock, [this] { 
+                    return stop_.load() || !tasks_.empty(); 
+                });
+                
+                if (stop_.load() && tasks_.empty()) {
+                    return;
+                }
+                
+                task_id = tasks_.popped();
+                task = tasks_.pop();
+            }
+            
+            HFT_TRACE_SCOPE(TraceProbe::TaskBegin, TraceProbe::TaskEnd, task_id);
+            task();
+        }
+    }
+
+    void stealing_worker_loop(size_t index) {
+        current_worker() = WorkerContext{this, index, (index + 1) * 0x9E3779B97F4A7C15ull};
+        uint64_t& seed = current_worker().seed;
+
+        for (;;) {
+            if (Task* task = find_task(index, seed)) {
+                run_stolen(task);
+                continue;
+            }
+
+            if (queued_.load(std::memory_order_seq_cst) != 0) {
+                // Queued but not yet visible, or a lost steal race.
+                std::this_thread::yield();
+                continue;
+            }
+            if (stop_.load()) {
+                return;
+            }
+            idle_.wait([this] {
+                return stop_.load() || queued_.load(std::memory_order_seq_cst) != 0;
+            });
+        }
+    }
+
+    void run_stolen(Task* task) {
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        {
+            HFT_TRACE_SCOPE(TraceProbe::TaskBegin, TraceProbe::TaskEnd, reinterpret_cast<uintptr_t>(task));
+            (*task)();
+        }
+        task->~Task();
+        task_nodes_->deallocate(task);
+    }
+
+    // index is the calling worker's own deque, or kNotAWorker.
+    Task* find_task(size_t index, uint64_t& seed) {
+        Task* task = nullptr;
+        if (index != kNotAWorker && deques_[index]->pop(task)) {
+            return task;
+        }
+
+        if (injector_size_.load(std::memory_order_acquire) != 0) {
+            std::lock_guard<std::mutex> lock(injector_mutex_);
+            if (!injector_.empty()) {
+                task = injector_.pop();
+                injector_size_.store(injector_.size(), std::memory_order_release);
+                return task;
+            }
+        }
+
+        const size_t count = deques_.size();
+        if (count > (index != kNotAWorker ? 1 : 0)) {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            const size_t first = static_cast<size_t>(seed % count);
+            for (size_t i = 0; i < count; ++i) {
+                const size_t victim = (first + i) % count;
+                if (victim != index && deques_[victim]->steal(task)) {
+                    return task;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    static constexpr size_t kInitialTaskNodes = 1024;
+
     std::vector<std::thread> workers_;
-    std::queue<std::function<void()>> tasks_;
+    detail::TaskQueue<Task> tasks_;
     
     mutable std::mutex queue_mutex_;
     std::condition_variable condition_;
     std::atomic<bool> stop_;
+    const SchedulingMode mode_;
+    std::vector<int> worker_cpus_;
+
+    // WorkStealing mode
+    std::unique_ptr<LockFreeMemoryPool<Task>> task_nodes_;
+    std::vector<std::unique_ptr<WorkStealingDeque<Task*>>> deques_;
+    std::mutex injector_mutex_;
+    detail::TaskQueue<Task*> injector_;
+    std::atomic<size_t> injector_size_{0};
+    std::atomic<size_t> queued_{0};
+    Waiter idle_;
+};
+
+// Lanes of HighPriorityThreadPool, served in strict priority order: a worker
+// only takes from a lane when every higher one is empty.
+enum class TaskPriority : uint8_t {
+    Critical = 0,   // e.g. order cancels
+    High,
+    Normal,
+    Low             // e.g. analytics refresh
+};
+
+inline constexpr size_t kTaskPriorityLevels = 4;
+
+// What a worker does with a task dequeued after its deadline.
+enum class ExpiredTaskPolicy {
+    Run,    // Run it anyway
+    Flag,   // Run it; HighPriorityThreadPool::current_task_expired() is true
+    Drop    // Destroy it unrun (an enqueue() future reports broken_promise)
+};
+
+struct HighPriorityPoolOptions {
+    size_t queue_capacity = 4096;       // Per lane
+    WaitStrategy wait_strategy = WaitStrategy::Block;
+    uint32_t spin_budget = 2048;
+    // SCHED_FIFO workers. A BusySpin or Yield worker at real-time priority
+    // never gives its core back, so give each one a dedicated core.
+    bool realtime = true;
+    ExpiredTaskPolicy expired_policy = ExpiredTaskPolicy::Run;
+    bool track_latency = true;          // Timestamp tasks for queue_delay histograms
 };
 
+namespace detail {
+
+// Upper bound of the log2 bucket (bucket i: [2^(i-1), 2^i), bucket 0: zero)
+// holding quantile q (0..1) of the samples.
+inline uint64_t log2_quantile(const std::array<uint64_t, 64>& histogram, double q) noexcept {
+    uint64_t total = 0;
+    for (uint64_t count : histogram) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0;
+    }
+    const uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < histogram.size(); ++i) {
+        seen += histogram[i];
+        if (seen >= rank) {
+            return i == 0 ? 0 : (i >= 63 ? ~uint64_t(0) : (uint64_t(1) << i) - 1);
+        }
+    }
+    return ~uint64_t(0);
+}
+
+inline void log2_record(std::array<std::atomic<uint64_t>, 64>& histogram, uint64_t value) noexcept {
+    const size_t index = value == 0 ? 0 : 64 - static_cast<size_t>(__builtin_clzll(value));
+    histogram[index < histogram.size() ? index : histogram.size() - 1]
+        .fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace detail
+
+// Snapshot of one lane. Histogram bucket i counts values in [2^(i-1), 2^i),
+// bucket 0 counts zeros.
+struct TaskLaneStats {
+    static constexpr size_t kBuckets = 64;
+
+    uint64_t submitted = 0;
+    uint64_t executed = 0;              // Dequeued and started
+    uint64_t expired = 0;               // Dequeued past their deadline
+    uint64_t dropped = 0;               // Expired and discarded under Drop
+    std::array<uint64_t, kBuckets> queue_depth{};       // Lane depth seen at submit
+    std::array<uint64_t, kBuckets> queue_delay_ns{};    // Submit to dequeue
+
+    // Upper bound of the bucket holding quantile q (0..1) of the samples.
+    static uint64_t quantile(const std::array<uint64_t, kBuckets>& histogram, double q) noexcept {
+        return detail::log2_quantile(histogram, q);
+    }
+};
+
+// Workers run SCHED_FIFO and are pinned per `placement`. The default placement
+// uses one SMT thread per physical core before doubling up on siblings.
+// Each priority lane is a lock-free MPMC ring; idle workers wait per
+// options.wait_strategy, so with BusySpin a pinned worker picks a task up
+// without any futex wake. Deadlines are Timer::nanos_since_epoch() values;
+// 0 means none.
 class HighPriorityThreadPool {
 public:
-    explicit HighPriorityThreadPool(size_t threads = 2) : stop_(false) {
-        for (size_t i = 0; i < threads; ++i) {
-            workers_.emplace_back([this, i] {
-                set_thread_priority();
-                set_thread_affinity(i);
-                worker_loop();
+    explicit HighPriorityThreadPool(size_t threads = 2, const PlacementPolicy& placement = {},
+                                    const HighPriorityPoolOptions& options = {})
+        : stop_(false), worker_cpus_(select_worker_cpus(placement, threads)),
+          expired_policy_(options.expired_policy), track_latency_(options.track_latency) {
+        for (auto& lane : lanes_) {
+            lane = std::make_unique<Lane>(options.queue_capacity);
+        }
+        for (size_t i = 0; i < worker_cpus_.size(); ++i) {
+            inboxes_.push_back(std::make_unique<MPMCRingBuffer<QueuedTask>>(kWorkerInboxCapacity));
+        }
+        waiter_.configure(options.wait_strategy, options.spin_budget);
+        for (size_t i = 0; i < worker_cpus_.size(); ++i) {
+            workers_.emplace_back([this, i, bind = placement.bind_memory, realtime = options.realtime] {
+                if (realtime) {
+                    set_thread_priority();
+                }
+                place_current_thread(worker_cpus_[i], bind);
+                worker_loop(i);
             });
         }
     }
 
+    size_t size() const noexcept {
+        return workers_.size();
+    }
+
+    const std::vector<int>& worker_cpus() const noexcept {
+        return worker_cpus_;
+    }
+
     template<class F, class... Args>
     auto enqueue_high_priority(F&& f, Args&&... args) 
         -> std::future<typename std::invoke_result<F, Args...>::type> {
-        
-        using return_type = typename std::invoke_result<F, Args...>::type;
+        return enqueue(TaskPriority::High, 0, std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    }
 
-        auto task = std::make_shared<std::packaged_task<return_type()>>(
-            std::bind(std::forward<F>(f), std::forward<Args>(args)...)
-        );
+    template<class F>
+    auto enqueue(TaskPriority priority, uint64_t deadline_ns, F&& f)
+        -> std::future<typename std::invoke_result<F>::type> {
+        using return_type = typename std::invoke_result<F>::type;
 
+        auto task = std::make_shared<std::packaged_task<return_type()>>(std::forward<F>(f));
         std::future<return_type> res = task->get_future();
-        
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            
-            if (stop_.load()) {
-                throw std::runtime_error("enqueue on stopped ThreadPool");
-            }
+        post(priority, [task]() { (*task)(); }, deadline_ns);
+        return res;
+    }
 
-            high_priority_tasks_.emplace([task]() { (*task)(); });
+    // Allocation-free fire-and-forget submission; see ThreadPool::post().
+    // Spins (yielding) while the lane is full.
+    template<class F>
+    void post(F&& f) {
+        post(TaskPriority::High, std::forward<F>(f));
+    }
+
+    template<class F>
+    void post(TaskPriority priority, F&& f, uint64_t deadline_ns = 0) {
+        QueuedTask task{InlineTask(std::forward<F>(f)), 0, deadline_ns};
+        while (!try_submit(priority, task)) {
+            std::this_thread::yield();
         }
-        
-        condition_.notify_one();
-        return res;
+    }
+
+    // Runs f on worker `worker` (pinned to worker_cpus()[worker]), which
+    // takes it before anything queued in the lanes. No deadline or lane
+    // stats. Throws std::out_of_range for a bad index.
+    template<class F>
+    void post_to_worker(size_t worker, F&& f) {
+        if (worker >= inboxes_.size()) {
+            throw std::out_of_range("HighPriorityThreadPool worker index");
+        }
+        if (stop_.load()) {
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+        }
+        QueuedTask task{InlineTask(std::forward<F>(f)), 0, 0};
+        while (!inboxes_[worker]->try_push(std::move(task))) {
+            std::this_thread::yield();
+        }
+        waiter_.notify();
+    }
+
+    // Like post(), but returns false instead of waiting when the lane is full.
+    template<class F>
+    bool try_post(F&& f) {
+        return try_post(TaskPriority::High, std::forward<F>(f));
+    }
+
+    template<class F>
+    bool try_post(TaskPriority priority, F&& f, uint64_t deadline_ns = 0) {
+        QueuedTask task{InlineTask(std::forward<F>(f)), 0, deadline_ns};
+        return try_submit(priority, task);
+    }
+
+    size_t pending_tasks() const noexcept {
+        size_t pending = 0;
+        for (const auto& lane : lanes_) {
+            pending += lane->tasks.size();
+        }
+        return pending;
+    }
+
+    size_t pending_tasks(TaskPriority priority) const noexcept {
+        return lane(priority).tasks.size();
+    }
+
+    TaskLaneStats lane_stats(TaskPriority priority) const noexcept {
+        const Lane& source = lane(priority);
+        TaskLaneStats stats;
+        stats.submitted = source.submitted.load(std::memory_order_relaxed);
+        stats.executed = source.executed.load(std::memory_order_relaxed);
+        stats.expired = source.expired.load(std::memory_order_relaxed);
+        stats.dropped = source.dropped.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < TaskLaneStats::kBuckets; ++i) {
+            stats.queue_depth[i] = source.queue_depth[i].load(std::memory_order_relaxed);
+            stats.queue_delay_ns[i] = source.queue_delay_ns[i].load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    // Inside a task run under ExpiredTaskPolicy::Flag: whether it was
+    // dequeued after its deadline.
+    static bool current_task_expired() noexcept {
+        return current_expired();
     }
 
     ~HighPriorityThreadPool() {
         stop_.store(true);
-        condition_.notify_all();
+        waiter_.notify();
         
         for (std::thread& worker : workers_) {
             if (worker.joinable()) {
@@ -174,26 +652,128 @@ public:
     }
 
 private:
-    void worker_loop() {
+    struct QueuedTask {
+        InlineTask task;
+        uint64_t enqueued_ns = 0;
+        uint64_t deadline_ns = 0;
+#ifdef HFT_ENABLE_TRACING
+        uint64_t trace_id = 0;
+#endif
+    };
+
+    static constexpr size_t kWorkerInboxCapacity = 64;
+
+    struct alignas(kCacheLineSize) Lane {
+        explicit Lane(size_t capacity) : tasks(capacity) {}
+
+        MPMCRingBuffer<QueuedTask> tasks;
+        std::atomic<uint64_t> submitted{0};
+        std::atomic<uint64_t> executed{0};
+        std::atomic<uint64_t> expired{0};
+        std::atomic<uint64_t> dropped{0};
+        std::array<std::atomic<uint64_t>, TaskLaneStats::kBuckets> queue_depth{};
+        std::array<std::atomic<uint64_t>, TaskLaneStats::kBuckets> queue_delay_ns{};
+    };
+
+    static bool& current_expired() noexcept {
+        static thread_local bool expired = false;
+        return expired;
+    }
+
+    Lane& lane(TaskPriority priority) noexcept {
+        return *lanes_[static_cast<size_t>(priority)];
+    }
+
+    const Lane& lane(TaskPriority priority) const noexcept {
+        return *lanes_[static_cast<size_t>(priority)];
+    }
+
+    bool try_submit(TaskPriority priority, QueuedTask& task) {
+        if (stop_.load()) {
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+        }
+        if (track_latency_ || task.deadline_ns != 0) {
+            task.enqueued_ns = Timer::nanos_since_epoch();
+        }
+#ifdef HFT_ENABLE_TRACING
+        task.trace_id = next_trace_id_.fetch_add(1, std::memory_order_relaxed);
+        HFT_TRACE(TraceProbe::TaskEnqueue, task.trace_id);
+#endif
+
+        Lane& target = lane(priority);
+        if (!target.tasks.try_push(std::move(task))) {
+            return false;
+        }
+        target.submitted.fetch_add(1, std::memory_order_relaxed);
+        detail::log2_record(target.queue_depth, target.tasks.size());
+        waiter_.notify();
+        return true;
+    }
+
+    bool any_pending() const noexcept {
+        for (const auto& lane : lanes_) {
+            if (!lane->tasks.empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void worker_loop(size_t index) {
+        MPMCRingBuffer<QueuedTask>& inbox = *inboxes_[index];
+        QueuedTask task;
         for (;;) {
-            std::function<void()> task;
-            
-            {
-                std::unique_lock<std::mutex> lock(queue_mutex_);
-                condition_.wait(lock, [this] { 
-                    return stop_.load() || !high_priority_tasks_.empty(); 
-                });
-                
-                if (stop_.load() && high_priority_tasks_.empty()) {
-                    return;
+            if (inbox.try_pop(task)) {
+                task.task();
+                task.task.reset();
+                continue;
+            }
+
+            Lane* source = nullptr;
+            for (auto& lane : lanes_) {
+                if (lane->tasks.try_pop(task)) {
+                    source = lane.get();
+                    break;
                 }
-                
-                task = std::move(high_priority_tasks_.front());
-                high_priority_tasks_.pop();
             }
-            
-            task();
+
+            if (source) {
+                run(*source, task);
+                task.task.reset();
+                continue;
+            }
+            if (stop_.load()) {
+                return;
+            }
+            waiter_.wait([this, &inbox] { return stop_.load() || any_pending() || !inbox.empty(); });
+        }
+    }
+
+    void run(Lane& source, QueuedTask& task) {
+        bool expired = false;
+        if (task.enqueued_ns != 0) {
+            const uint64_t now = Timer::nanos_since_epoch();
+            if (track_latency_) {
+                detail::log2_record(source.queue_delay_ns, now > task.enqueued_ns ? now - task.enqueued_ns : 0);
+            }
+            expired = task.deadline_ns != 0 && now > task.deadline_ns;
+        }
+
+        if (expired) {
+            source.expired.fetch_add(1, std::memory_order_relaxed);
+            if (expired_policy_ == ExpiredTaskPolicy::Drop) {
+                source.dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
         }
+
+        source.executed.fetch_add(1, std::memory_order_relaxed);
+        current_expired() = expired && expired_policy_ == ExpiredTaskPolicy::Flag;
+        {
+            HFT_TRACE_SCOPE(TraceProbe::TaskBegin, TraceProbe::TaskEnd, task.trace_id);
+            task.task();
+        }
+        current_expired() = false;
     }
 
     void set_thread_priority() {
@@ -208,22 +788,17 @@ private:
 #endif
     }
 
-    void set_thread_affinity(size_t thread_idx) {
-#ifdef __linux__
-        cpu_set_t cpuset;
-        CPU_ZERO(&cpuset);
-        CPU_SET(thread_idx % std::thread::hardware_concurrency(), &cpuset);
-        
-        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
-#endif
-    }
-
     std::vector<std::thread> workers_;
-    std::queue<std::function<void()>> high_priority_tasks_;
-    
-    mutable std::mutex queue_mutex_;
-    std::condition_variable condition_;
     std::atomic<bool> stop_;
+    std::vector<int> worker_cpus_;
+    const ExpiredTaskPolicy expired_policy_;
+    const bool track_latency_;
+    std::array<std::unique_ptr<Lane>, kTaskPriorityLevels> lanes_;
+    std::vector<std::unique_ptr<MPMCRingBuffer<QueuedTask>>> inboxes_;    // One per worker
+    Waiter waiter_;
+#ifdef HFT_ENABLE_TRACING
+    std::atomic<uint64_t> next_trace_id_{0};
+#endif
 };
 
 } // namespace hft::core
\ No newline at end of file
@@ -1,10 +1,55 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 
+#include "hft_core/Histogram.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <x86intrin.h>
+#endif
+
 namespace hft::core {
 
+enum class TscSource {
+    Cpuid,          // CPUID leaf 0x15 crystal ratio
+    Calibrated,     // Measured against CLOCK_MONOTONIC_RAW
+    Clock           // No TSC on this platform; rdtsc() returns clock nanoseconds
+};
+
+struct TscCalibration {
+    uint64_t frequency_hz = 0;
+    uint64_t mult = 0;              // ns = (ticks * mult) >> shift
+    uint32_t shift = 0;
+    bool invariant = false;         // CPUID reports an invariant (constant, non-stop) TSC
+    TscSource source = TscSource::Calibrated;
+};
+
+namespace detail {
+
+// Calibrated once during static initialization of Timer.cpp (or on first use
+// if that has not happened yet); the hot path only loads these fields.
+struct TscClockState {
+    std::atomic<uint64_t> mult{0};
+    std::atomic<uint32_t> shift{0};
+
+    // Seqlock-protected (tsc, epoch ns) anchor for tsc_to_epoch_ns().
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<uint64_t> anchor_tsc{0};
+    std::atomic<uint64_t> anchor_epoch_ns{0};
+    std::atomic<uint64_t> reanchor_ticks{0};
+    std::atomic<bool> reanchoring{false};
+};
+
+extern TscClockState tsc_clock;
+
+// Slow paths, in Timer.cpp.
+uint64_t ensure_tsc_calibrated() noexcept;
+void reanchor_tsc_clock(uint64_t tsc) noexcept;
+
+} // namespace detail
+
 class Timer {
 public:
     using clock_type = std::chrono::high_resolution_clock;
@@ -23,6 +68,29 @@ public:
 #endif
     }
 
+    // rdtscp waits for earlier instructions to complete before reading.
+    static inline uint64_t rdtscp() noexcept {
+#if defined(__x86_64__) || defined(_M_X64)
+        unsigned aux;
+        return __rdtscp(&aux);
+#else
+        return rdtsc();
+#endif
+    }
+
+    // lfence; rdtsc: also keeps later instructions from starting early, so
+    // the read cannot drift into the measured region.
+    static inline uint64_t rdtsc_ordered() noexcept {
+#if defined(__x86_64__) || defined(_M_X64)
+        _mm_lfence();
+        const uint64_t tsc = __rdtsc();
+        _mm_lfence();
+        return tsc;
+#else
+        return rdtsc();
+#endif
+    }
+
     static inline time_point now() noexcept {
         return clock_type::now();
     }
@@ -37,27 +105,93 @@ public:
             now().time_since_epoch()).count();
     }
 
+    // Fixed-point tick to ns conversion: one multiply and shift.
+    static inline uint64_t ticks_to_nanos(uint64_t ticks) noexcept {
+        uint64_t mult = detail::tsc_clock.mult.load(std::memory_order_relaxed);
+        if (__builtin_expect(mult == 0, 0)) {
+            mult = detail::ensure_tsc_calibrated();
+        }
+        const uint32_t shift = detail::tsc_clock.shift.load(std::memory_order_relaxed);
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(ticks) * mult) >> shift);
+    }
+
     static inline double tsc_to_nanos(uint64_t tsc_start, uint64_t tsc_end) noexcept {
-        static const double tsc_freq = get_tsc_frequency();
-        return (tsc_end - tsc_start) / tsc_freq;
+        return static_cast<double>(ticks_to_nanos(tsc_end - tsc_start));
     }
 
-private:
-    static double get_tsc_frequency() noexcept;
+    // Wall-clock ns since the epoch for a TSC reading, without a syscall.
+    // The anchor is re-taken from the system clock once it is older than a
+    // second (by whichever caller notices first), so drift stays bounded.
+    static inline uint64_t tsc_to_epoch_ns(uint64_t tsc) noexcept {
+        auto& clock = detail::tsc_clock;
+        if (__builtin_expect(clock.mult.load(std::memory_order_relaxed) == 0, 0)) {
+            detail::ensure_tsc_calibrated();
+        }
+
+        uint32_t sequence;
+        uint64_t anchor_tsc;
+        uint64_t anchor_ns;
+        do {
+            sequence = clock.sequence.load(std::memory_order_acquire);
+            anchor_tsc = clock.anchor_tsc.load(std::memory_order_relaxed);
+            anchor_ns = clock.anchor_epoch_ns.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((sequence & 1) != 0 || clock.sequence.load(std::memory_order_relaxed) != sequence);
+
+        if (tsc < anchor_tsc) {
+            return anchor_ns - ticks_to_nanos(anchor_tsc - tsc);
+        }
+        const uint64_t elapsed = tsc - anchor_tsc;
+        if (__builtin_expect(elapsed > clock.reanchor_ticks.load(std::memory_order_relaxed), 0)) {
+            detail::reanchor_tsc_clock(tsc);
+        }
+        return anchor_ns + ticks_to_nanos(elapsed);
+    }
+
+    static inline uint64_t epoch_ns() noexcept {
+        return tsc_to_epoch_ns(rdtsc());
+    }
+
+    // Re-takes the epoch anchor now and refines the frequency over the time
+    // since calibration.
+    static void reanchor() noexcept;
+
+    static TscCalibration tsc_calibration() noexcept;
+
+    static uint64_t tsc_frequency() noexcept {
+        return tsc_calibration().frequency_hz;
+    }
 };
 
+// Measures its own lifetime; writes the nanoseconds to a variable or records
+// them into a histogram on destruction.
 class ScopedTimer {
 public:
     explicit ScopedTimer(uint64_t& duration_ns) 
-        : duration_ref_(duration_ns), start_tsc_(Timer::rdtsc()) {}
+        : duration_ref_(&duration_ns), start_tsc_(Timer::rdtsc()) {}
+
+    explicit ScopedTimer(Histogram& histogram)
+        : histogram_(&histogram), start_tsc_(Timer::rdtsc()) {}
+
+    explicit ScopedTimer(ConcurrentHistogram& histogram)
+        : ScopedTimer(histogram.local()) {}
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
 
     ~ScopedTimer() {
-        duration_ref_ = static_cast<uint64_t>(
+        const auto elapsed = static_cast<uint64_t>(
             Timer::tsc_to_nanos(start_tsc_, Timer::rdtsc()));
+        if (histogram_) {
+            histogram_->record(elapsed);
+        } else {
+            *duration_ref_ = elapsed;
+        }
     }
 
 private:
-    uint64_t& duration_ref_;
+    uint64_t* duration_ref_ = nullptr;
+    Histogram* histogram_ = nullptr;
     uint64_t start_tsc_;
 };
 
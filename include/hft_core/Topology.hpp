@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace hft::core {
+
+struct CpuInfo {
+    int cpu = 0;
+    int socket = 0;
+    int core = 0;           // Physical core id, unique within its socket
+    int numa_node = 0;
+    bool primary = true;    // Lowest-numbered SMT sibling of its core
+};
+
+// Which CPUs a pool's workers are pinned to, e.g. "one per physical core on
+// node 1": PlacementPolicy{1, true}.
+struct PlacementPolicy {
+    int numa_node = -1;                 // -1: any node
+    bool skip_smt_siblings = false;     // At most one CPU per physical core
+    bool bind_memory = true;            // Prefer node-local memory on pinned threads
+};
+
+// CPU and NUMA layout read from sysfs. On systems without sysfs every CPU
+// reported by the OS is its own core on socket 0 / node 0.
+class CpuTopology {
+public:
+    // Topology of this machine, detected once.
+    static const CpuTopology& system();
+
+    // Parses <sysfs_root>/cpu and <sysfs_root>/node.
+    static CpuTopology detect(const std::string& sysfs_root = "/sys/devices/system");
+
+    const std::vector<CpuInfo>& cpus() const noexcept {
+        return cpus_;
+    }
+
+    // Counted once by detect(), so these are cheap enough for thread startup.
+    size_t socket_count() const noexcept {
+        return socket_count_;
+    }
+    size_t numa_node_count() const noexcept {
+        return numa_node_count_;
+    }
+    size_t physical_core_count() const noexcept {
+        return physical_core_count_;
+    }
+
+    // Node of `cpu`, or -1 if unknown.
+    int numa_node_of(int cpu) const noexcept;
+
+    // CPUs matching the policy. Primary SMT threads come first, ordered by
+    // node, socket and core, so taking a prefix spreads across cores.
+    std::vector<int> select(const PlacementPolicy& policy) const;
+
+private:
+    void count_groups();
+
+    std::vector<CpuInfo> cpus_;
+    size_t socket_count_ = 0;
+    size_t numa_node_count_ = 0;
+    size_t physical_core_count_ = 0;
+};
+
+// Parses a sysfs CPU list such as "0-3,8,10-11".
+std::vector<int> parse_cpu_list(const std::string& list);
+
+// NUMA node the calling thread is running on (0 when unknown).
+int current_numa_node() noexcept;
+
+// CPUs for `threads` workers under `placement`: the selection repeated or
+// truncated to length `threads`, or the whole selection when threads == 0.
+// Throws std::invalid_argument when the policy matches no CPU.
+std::vector<int> select_worker_cpus(const PlacementPolicy& placement, size_t threads);
+
+// Pins the calling thread to `cpu` and, with bind_memory, prefers that CPU's
+// NUMA node for its allocations. Failures are ignored: the thread keeps
+// running unpinned. Does not allocate once CpuTopology::system() has been
+// detected, so spawners should call that (or select_worker_cpus()) first.
+void place_current_thread(int cpu, bool bind_memory) noexcept;
+
+// Pins the calling thread to one CPU. Returns false if not supported or
+// refused.
+bool pin_current_thread(int cpu) noexcept;
+
+// Makes the calling thread's future page allocations prefer `node`
+// (set_mempolicy MPOL_PREFERRED). Returns false if unsupported.
+bool prefer_numa_node(int node) noexcept;
+
+// Binds the pages of [addr, addr + bytes) to `node` (mbind MPOL_BIND) before
+// they are first touched. Returns false if unsupported.
+bool bind_memory_to_node(void* addr, size_t bytes, int node) noexcept;
+
+} // namespace hft::core
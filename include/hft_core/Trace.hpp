@@ -0,0 +1,214 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "hft_core/RingBuffer.hpp"
+#include "hft_core/Timer.hpp"
+
+namespace hft::core {
+
+// Probe ids recorded by the library. Applications use ids from User up.
+enum class TraceProbe : uint32_t {
+    EventPublish = 1,       // payload: event trace id
+    EventHandlerBegin,      // payload: event trace id
+    EventHandlerEnd,
+    TaskEnqueue,            // payload: task id
+    TaskBegin,
+    TaskEnd,
+    LogEnqueue,             // payload: record bytes
+    User = 256
+};
+
+// Name of a library probe, or nullptr for application ids.
+const char* trace_probe_name(uint32_t probe) noexcept;
+
+struct TraceRecord {
+    uint64_t tsc;
+    uint64_t payload;
+    uint32_t probe;
+    uint32_t reserved;
+};
+
+struct TraceOptions {
+    std::string name;                   // POSIX shm name; default "/hft_trace.<pid>"
+    size_t max_threads = 64;            // Rings in the segment, one per tracing thread
+    size_t ring_capacity = 1 << 16;     // Slots per ring, rounded up to a power of two;
+                                        // the newest ring_capacity - 1 records are readable
+};
+
+namespace detail {
+
+inline constexpr uint64_t kTraceMagic = 0x31454341525448ull;    // "HTRACE1"
+inline constexpr uint32_t kTraceVersion = 1;
+
+// Segment layout: header, then max_threads rings of ring_stride bytes, each
+// a TraceRingHeader followed by ring_capacity records. Readers in another
+// process map the same object; the per-ring head only ever grows, so a
+// record is intact if it is still within ring_capacity of the head after
+// it has been copied.
+struct TraceSegmentHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t ring_count;
+    uint64_t ring_capacity;
+    uint64_t ring_stride;
+    uint64_t tsc_frequency_hz;
+    uint64_t anchor_tsc;                // Paired with anchor_epoch_ns at creation
+    uint64_t anchor_epoch_ns;
+    int32_t pid;
+    std::atomic<uint32_t> rings_claimed;
+    std::atomic<uint64_t> threads_dropped;  // Threads that found no free ring
+};
+
+struct alignas(kCacheLineSize) TraceRingHeader {
+    std::atomic<uint64_t> head;         // Records ever written
+    uint32_t tid;
+    char thread_name[16];
+};
+
+// Per-thread view of its ring. Trivially constructible, so the thread_local
+// costs no guard on the hot path.
+struct TraceThreadSlot {
+    uint64_t generation;                // Tracer session the ring belongs to
+    TraceRingHeader* ring;
+    TraceRecord* records;
+    uint64_t mask;
+    uint64_t head;
+};
+
+// Bumped by every Tracer start/stop; 0 while tracing is off.
+inline std::atomic<uint64_t> trace_generation{0};
+inline thread_local TraceThreadSlot trace_slot{};
+
+// Claims a ring from the current session (or none) and caches it in slot.
+void attach_trace_ring(TraceThreadSlot& slot) noexcept;
+
+} // namespace detail
+
+// Records one probe into the calling thread's ring: a TSC read and two
+// stores, plus a one-off ring claim per thread and session. Does nothing
+// unless Tracer::start() is active.
+inline void trace_point(uint32_t probe, uint64_t payload) noexcept {
+    detail::TraceThreadSlot& slot = detail::trace_slot;
+    const uint64_t generation = detail::trace_generation.load(std::memory_order_acquire);
+    if (slot.generation != generation) {
+        detail::attach_trace_ring(slot);
+    }
+    if (!slot.ring) {
+        return;
+    }
+
+    slot.records[slot.head & slot.mask] = TraceRecord{Timer::rdtsc(), payload, probe, 0};
+    slot.ring->head.store(++slot.head, std::memory_order_release);
+}
+
+// Records `begin` now and `end` when the scope exits, exceptions included.
+class TraceScope {
+public:
+    TraceScope(TraceProbe begin, TraceProbe end, uint64_t payload) noexcept
+        : end_(static_cast<uint32_t>(end)), payload_(payload) {
+        trace_point(static_cast<uint32_t>(begin), payload);
+    }
+
+    ~TraceScope() {
+        trace_point(end_, payload_);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    uint32_t end_;
+    uint64_t payload_;
+};
+
+// Owns the shared-memory segment the probes write to.
+class Tracer {
+public:
+    static Tracer& instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    // Creates and maps the segment; threads attach on their next probe.
+    // Throws std::system_error if the segment cannot be created.
+    void start(const TraceOptions& options = {});
+
+    // Detaches all threads. The segment stays mapped (racing probes may
+    // still write to it) and, unless unlink is set, readable by name.
+    void stop(bool unlink = false);
+
+    bool active() const noexcept {
+        return detail::trace_generation.load(std::memory_order_acquire) != 0;
+    }
+
+    std::string segment_name() const;
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+private:
+    friend void detail::attach_trace_ring(detail::TraceThreadSlot& slot) noexcept;
+
+    Tracer() = default;
+
+    mutable std::mutex mutex_;
+    std::string name_;
+    detail::TraceSegmentHeader* segment_ = nullptr;
+    uint64_t sessions_ = 0;
+};
+
+// Reader side: a consistent copy of every ring in a segment.
+struct TraceThread {
+    uint32_t tid = 0;
+    std::string name;
+    uint64_t lost = 0;                  // Overwritten before they were read
+    std::vector<TraceRecord> records;   // Oldest first
+};
+
+struct TraceCapture {
+    int32_t pid = 0;
+    uint64_t tsc_frequency_hz = 0;
+    uint64_t anchor_tsc = 0;
+    uint64_t anchor_epoch_ns = 0;
+    uint64_t threads_dropped = 0;
+    std::vector<TraceThread> threads;
+
+    // Wall-clock time of a record, via the segment's own anchor.
+    uint64_t to_epoch_ns(uint64_t tsc) const noexcept;
+};
+
+// `segment` is a shm name ("/hft_trace.1234") or a path to a copy of one.
+// Throws std::runtime_error if it cannot be opened or is not a trace.
+TraceCapture read_trace(const std::string& segment);
+
+// Chrome trace event / Perfetto JSON: handler and task slices, instant
+// events for the rest, and flow arrows from publish/enqueue to handling.
+void write_chrome_trace(const TraceCapture& capture, std::ostream& out);
+
+// One line per event or task id, its probes in time order across threads.
+void write_trace_timelines(const TraceCapture& capture, std::ostream& out);
+
+} // namespace hft::core
+
+// Compiled out entirely (arguments are not evaluated) unless the build
+// defines HFT_ENABLE_TRACING.
+#define HFT_TRACE_CONCAT_(a, b) a##b
+#define HFT_TRACE_CONCAT(a, b) HFT_TRACE_CONCAT_(a, b)
+
+#ifdef HFT_ENABLE_TRACING
+#define HFT_TRACE(probe, payload) \
+    ::hft::core::trace_point(static_cast<uint32_t>(probe), static_cast<uint64_t>(payload))
+#define HFT_TRACE_SCOPE(begin, end, payload) \
+    ::hft::core::TraceScope HFT_TRACE_CONCAT(hft_trace_scope_, __LINE__)( \
+        begin, end, static_cast<uint64_t>(payload))
+#else
+#define HFT_TRACE(probe, payload) ((void)0)
+#define HFT_TRACE_SCOPE(begin, end, payload) ((void)0)
+#endif
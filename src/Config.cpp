@@ -1,5 +1,318 @@
 #include "hft_core/Config.hpp"
 
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+
 namespace hft::core {
 
-} // namespace hft::core
\ No newline at end of file
+namespace {
+
+constexpr std::string_view kWhitespace = " \t\r\n";
+
+std::string_view trim(std::string_view text) noexcept {
+    const size_t start = text.find_first_not_of(kWhitespace);
+    if (start == std::string_view::npos) {
+        return {};
+    }
+    const size_t end = text.find_last_not_of(kWhitespace);
+    return text.substr(start, end - start + 1);
+}
+
+bool quoted(std::string_view text) noexcept {
+    return text.size() >= 2 && text.front() == '"' && text.back() == '"';
+}
+
+// from_chars does not take a leading '+'.
+std::string_view strip_plus(std::string_view text) noexcept {
+    if (text.size() > 1 && text.front() == '+' && text[1] != '-') {
+        text.remove_prefix(1);
+    }
+    return text;
+}
+
+template<typename T>
+bool parse_number(std::string_view text, T& value) noexcept {
+    const char* end = text.data() + text.size();
+    const auto result = std::from_chars(text.data(), end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+// Integer as int if it fits, else int64_t, else uint64_t.
+std::optional<ConfigValue> parse_integer(std::string_view text) noexcept {
+    int64_t signed_value;
+    if (parse_number(text, signed_value)) {
+        if (detail::integer_fits<int>(signed_value)) {
+            return ConfigValue(static_cast<int>(signed_value));
+        }
+        return ConfigValue(signed_value);
+    }
+    uint64_t unsigned_value;
+    if (text.front() != '-' && parse_number(text, unsigned_value)) {
+        return ConfigValue(unsigned_value);
+    }
+    return std::nullopt;
+}
+
+std::optional<std::chrono::nanoseconds> parse_duration(std::string_view text) noexcept {
+    const size_t unit_start = text.find_last_of("0123456789.") + 1;
+    if (unit_start == 0 || unit_start == text.size()) {
+        return std::nullopt;
+    }
+
+    const std::string_view unit = text.substr(unit_start);
+    int64_t scale;
+    if (unit == "ns") scale = 1;
+    else if (unit == "us") scale = 1000;
+    else if (unit == "ms") scale = 1000000;
+    else if (unit == "s") scale = 1000000000;
+    else if (unit == "min") scale = 60ll * 1000000000;
+    else if (unit == "h") scale = 3600ll * 1000000000;
+    else return std::nullopt;
+
+    const std::string_view number = text.substr(0, unit_start);
+    int64_t count;
+    if (parse_number(number, count)) {
+        int64_t ns;
+        if (__builtin_mul_overflow(count, scale, &ns)) {
+            return std::nullopt;
+        }
+        return std::chrono::nanoseconds(ns);
+    }
+    double fractional;
+    if (parse_number(number, fractional)) {
+        const double ns = std::round(fractional * static_cast<double>(scale));
+        if (std::isfinite(ns) && std::fabs(ns) < 9.2e18) {
+            return std::chrono::nanoseconds(static_cast<int64_t>(ns));
+        }
+    }
+    return std::nullopt;
+}
+
+// Splits on commas outside double quotes.
+std::vector<std::string_view> split_list(std::string_view body) {
+    std::vector<std::string_view> items;
+    if (trim(body).empty()) {
+        return items;
+    }
+    bool in_quotes = false;
+    size_t start = 0;
+    for (size_t i = 0; i <= body.size(); ++i) {
+        if (i == body.size() || (body[i] == ',' && !in_quotes)) {
+            items.push_back(trim(body.substr(start, i - start)));
+            start = i + 1;
+        } else if (body[i] == '"') {
+            in_quotes = !in_quotes;
+        }
+    }
+    return items;
+}
+
+ConfigValue parse_list(std::string_view body) {
+    const std::vector<std::string_view> items = split_list(body);
+
+    std::vector<int64_t> integers;
+    integers.reserve(items.size());
+    bool all_integers = true;
+    bool all_numbers = true;
+    for (std::string_view item : items) {
+        int64_t value;
+        if (!quoted(item) && parse_number(strip_plus(item), value)) {
+            integers.push_back(value);
+            continue;
+        }
+        all_integers = false;
+        double ignored;
+        if (quoted(item) || !parse_number(strip_plus(item), ignored)) {
+            all_numbers = false;
+            break;
+        }
+    }
+    if (all_integers) {
+        return integers;
+    }
+
+    if (all_numbers) {
+        std::vector<double> numbers;
+        numbers.reserve(items.size());
+        for (std::string_view item : items) {
+            double value = 0;
+            parse_number(strip_plus(item), value);
+            numbers.push_back(value);
+        }
+        return numbers;
+    }
+
+    std::vector<std::string> strings;
+    strings.reserve(items.size());
+    for (std::string_view item : items) {
+        if (quoted(item)) {
+            item = item.substr(1, item.size() - 2);
+        }
+        strings.emplace_back(item);
+    }
+    return strings;
+}
+
+template<typename T>
+void append_number(std::string& out, T value) {
+    char buffer[32];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+// Shortest round-trip form, kept recognisably floating point.
+void append_double(std::string& out, double value) {
+    const size_t start = out.size();
+    append_number(out, value);
+    if (out.find_first_of(".eEn", start) == std::string::npos) {
+        out += ".0";
+    }
+}
+
+bool read_file(const std::string& filename, std::string& buffer) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    const std::streamoff size = file.tellg();
+    if (size < 0) {
+        return false;
+    }
+    buffer.resize(static_cast<size_t>(size));
+    file.seekg(0, std::ios::beg);
+    file.read(buffer.data(), size);
+    buffer.resize(static_cast<size_t>(file.gcount()));
+    return true;
+}
+
+} // namespace
+
+bool Config::parse_file(const std::string& filename, ConfigValues& values) {
+    std::string buffer;
+    if (!read_file(filename, buffer)) {
+        return false;
+    }
+
+    const std::string_view text(buffer);
+    values.reserve(values.size() + static_cast<size_t>(std::count(text.begin(), text.end(), '\n')) + 1);
+
+    size_t position = 0;
+    while (position < text.size()) {
+        size_t end = text.find('\n', position);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        const std::string_view line = trim(text.substr(position, end - position));
+        position = end + 1;
+
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+
+        const size_t pos = line.find('=');
+        if (pos == std::string_view::npos) {
+            continue;
+        }
+
+        values.insert_or_assign(std::string(trim(line.substr(0, pos))), parse_value(trim(line.substr(pos + 1))));
+    }
+
+    return true;
+}
+
+ConfigValue Config::parse_value(std::string_view text) {
+    text = trim(text);
+    if (quoted(text)) {
+        return std::string(text.substr(1, text.size() - 2));
+    }
+    if (text.empty()) {
+        return std::string();
+    }
+
+    if (text == "true" || text == "TRUE") {
+        return true;
+    }
+    if (text == "false" || text == "FALSE") {
+        return false;
+    }
+
+    if (text.size() >= 2 && text.front() == '[' && text.back() == ']') {
+        return parse_list(text.substr(1, text.size() - 2));
+    }
+
+    const std::string_view number = strip_plus(text);
+    if (auto integer = parse_integer(number)) {
+        return *integer;
+    }
+    if (auto duration = parse_duration(number)) {
+        return *duration;
+    }
+    double double_val;
+    if (parse_number(number, double_val)) {
+        return double_val;
+    }
+
+    return std::string(text);
+}
+
+std::string Config::format_value(const ConfigValue& value) {
+    std::string out;
+    std::visit([&out](const auto& v) {
+        using V = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<V, std::string>) {
+            out += '"';
+            out += v;
+            out += '"';
+        } else if constexpr (std::is_same_v<V, bool>) {
+            out += v ? "true" : "false";
+        } else if constexpr (std::is_same_v<V, double>) {
+            append_double(out, v);
+        } else if constexpr (std::is_same_v<V, std::chrono::nanoseconds>) {
+            append_number(out, static_cast<int64_t>(v.count()));
+            out += "ns";
+        } else if constexpr (detail::is_config_list_v<V>) {
+            out += '[';
+            for (size_t i = 0; i < v.size(); ++i) {
+                if (i != 0) {
+                    out += ", ";
+                }
+                if constexpr (std::is_same_v<V, std::vector<std::string>>) {
+                    out += '"';
+                    out += v[i];
+                    out += '"';
+                } else if constexpr (std::is_same_v<V, std::vector<double>>) {
+                    append_double(out, v[i]);
+                } else {
+                    append_number(out, v[i]);
+                }
+            }
+            out += ']';
+        } else {
+            append_number(out, v);
+        }
+    }, value);
+    return out;
+}
+
+bool Config::save_to_file(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    for (const auto& [key, value] : snapshot().values()) {
+        line.assign(key);
+        line += '=';
+        line += format_value(value);
+        line += '\n';
+        file << line;
+    }
+
+    return true;
+}
+
+} // namespace hft::core
@@ -0,0 +1,175 @@
+#include "hft_core/ConfigWatcher.hpp"
+
+#include <cerrno>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace hft::core {
+
+ConfigWatcher::ConfigWatcher(std::string filename, ConfigWatcherOptions options,
+                             Config& config, EventBus& bus)
+    : filename_(std::move(filename)), options_(options), config_(config), bus_(bus) {}
+
+ConfigWatcher::~ConfigWatcher() {
+    stop();
+}
+
+std::vector<ConfigChange> ConfigWatcher::reload() {
+    std::lock_guard<std::mutex> lock(reload_mutex_);
+
+    ConfigValues values;
+    if (!Config::parse_file(filename_, values)) {
+        failures_.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+
+    std::vector<std::string> removed;
+    if (options_.remove_missing) {
+        for (const auto& key : file_keys_) {
+            if (values.find(key) == values.end()) {
+                removed.push_back(key);
+            }
+        }
+    }
+
+    std::vector<ConfigChange> changes = config_.apply(values, removed);
+    file_keys_.clear();
+    file_keys_.reserve(values.size());
+    for (const auto& entry : values) {
+        file_keys_.push_back(entry.first);
+    }
+    reloads_.fetch_add(1, std::memory_order_relaxed);
+
+    if (options_.publish_events) {
+        for (const auto& change : changes) {
+            bus_.publish(ConfigChanged(change));
+        }
+    }
+    return changes;
+}
+
+void ConfigWatcher::start() {
+    if (running_.exchange(true, std::memory_order_acq_rel)) {
+        throw std::logic_error("ConfigWatcher already running");
+    }
+
+#ifdef __linux__
+    const std::filesystem::path path(filename_);
+    const std::string directory = path.has_parent_path() ? path.parent_path().string() : ".";
+
+    inotify_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    wake_fd_ = inotify_fd_ < 0 ? -1 : ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (inotify_fd_ < 0 || wake_fd_ < 0 ||
+        ::inotify_add_watch(inotify_fd_, directory.c_str(),
+                            IN_CLOSE_WRITE | IN_MOVED_TO | IN_MODIFY) < 0) {
+        const int error = errno;
+        if (inotify_fd_ >= 0) ::close(inotify_fd_);
+        if (wake_fd_ >= 0) ::close(wake_fd_);
+        inotify_fd_ = wake_fd_ = -1;
+        running_.store(false, std::memory_order_release);
+        throw std::system_error(error, std::generic_category(), "ConfigWatcher: cannot watch " + directory);
+    }
+#endif
+
+    reload();
+    thread_ = std::thread([this] { run(); });
+}
+
+void ConfigWatcher::stop() {
+    if (!running_.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+
+#ifdef __linux__
+    const uint64_t one = 1;
+    [[maybe_unused]] const ssize_t written = ::write(wake_fd_, &one, sizeof(one));
+#endif
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex_);
+    }
+    stop_cv_.notify_all();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+#ifdef __linux__
+    ::close(inotify_fd_);
+    ::close(wake_fd_);
+    inotify_fd_ = wake_fd_ = -1;
+#endif
+}
+
+#ifdef __linux__
+
+void ConfigWatcher::run() {
+    const std::string name = std::filesystem::path(filename_).filename().string();
+    alignas(inotify_event) char buffer[4096];
+    bool pending = false;
+
+    while (running_.load(std::memory_order_acquire)) {
+        pollfd fds[2] = {{inotify_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+        const int timeout = pending ? static_cast<int>(options_.settle.count()) : -1;
+        const int ready = ::poll(fds, 2, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            break;
+        }
+
+        if (ready == 0) {
+            // Writes have settled.
+            pending = false;
+            reload();
+            continue;
+        }
+
+        ssize_t length;
+        while ((length = ::read(inotify_fd_, buffer, sizeof(buffer))) > 0) {
+            for (ssize_t offset = 0; offset < length;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                if (event->len != 0 && name == event->name) {
+                    pending = true;
+                }
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+            }
+        }
+    }
+}
+
+#else
+
+void ConfigWatcher::run() {
+    std::error_code error;
+    auto last = std::filesystem::last_write_time(filename_, error);
+
+    std::unique_lock<std::mutex> lock(stop_mutex_);
+    while (running_.load(std::memory_order_acquire)) {
+        stop_cv_.wait_for(lock, options_.poll_interval);
+        if (!running_.load(std::memory_order_acquire)) {
+            break;
+        }
+
+        const auto current = std::filesystem::last_write_time(filename_, error);
+        if (!error && current != last) {
+            last = current;
+            lock.unlock();
+            reload();
+            lock.lock();
+        }
+    }
+}
+
+#endif
+
+} // namespace hft::core
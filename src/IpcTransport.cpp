@@ -0,0 +1,299 @@
+#include "hft_core/IpcTransport.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace hft::core {
+
+namespace detail {
+
+inline constexpr uint64_t kIpcMagic = 0x31435049544648ull;     // "HFTIPC1"
+inline constexpr uint32_t kIpcVersion = 1;
+
+// Segment layout: header, then capacity slots of `stride` bytes, each an
+// IpcSlotHeader with the event bytes at kIpcPayloadOffset.
+struct IpcSegmentHeader {
+    uint64_t magic;
+    uint32_t version;
+    int32_t pid;
+    uint64_t capacity;
+    uint64_t stride;
+    uint64_t max_event_size;
+    alignas(kCacheLineSize) std::atomic<uint64_t> head;     // Events claimed by the writer
+    alignas(kCacheLineSize) std::atomic<uint32_t> wake;     // Futex word for blocked readers
+    std::atomic<uint32_t> sleepers;
+};
+
+struct IpcSlotHeader {
+    std::atomic<uint64_t> sequence;     // n + 1 once event n is complete; kIpcBusy set while writing
+    uint64_t type_id;
+    uint32_t size;
+    uint32_t reserved;
+};
+
+} // namespace detail
+
+namespace {
+
+using detail::IpcSegmentHeader;
+using detail::IpcSlotHeader;
+
+constexpr uint64_t kBusy = uint64_t(1) << 63;
+constexpr size_t kPayloadOffset = 32;
+
+static_assert(sizeof(IpcSlotHeader) <= kPayloadOffset, "slot header overlaps the payload");
+
+constexpr size_t align_line(size_t bytes) noexcept {
+    return (bytes + kCacheLineSize - 1) & ~(kCacheLineSize - 1);
+}
+
+constexpr size_t kSlotsOffset = align_line(sizeof(IpcSegmentHeader));
+
+#ifdef __linux__
+void futex_wait(std::atomic<uint32_t>& word, uint32_t expected, long timeout_ns) noexcept {
+    timespec timeout{0, timeout_ns};
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+void futex_wake_all(std::atomic<uint32_t>& word) noexcept {
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+#endif
+
+} // namespace
+
+namespace detail {
+
+IpcWriter::IpcWriter(const std::string& name, const IpcOptions& options)
+    : name_(name), unlink_(options.unlink_on_close) {
+#ifdef __linux__
+    const size_t capacity = round_up_pow2(std::max<size_t>(2, options.capacity));
+    max_event_size_ = std::max<size_t>(1, options.max_event_size);
+    stride_ = align_line(kPayloadOffset + max_event_size_);
+    mask_ = capacity - 1;
+    const size_t size = kSlotsOffset + capacity * stride_;
+
+    // A fresh object, so readers still mapping an old one are not corrupted.
+    ::shm_unlink(name.c_str());
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+    }
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        const int error = errno;
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        throw std::system_error(error, std::generic_category(), "ftruncate " + name);
+    }
+    void* memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const int error = errno;
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        throw std::system_error(error, std::generic_category(), "mmap " + name);
+    }
+
+    mapping_ = memory;
+    mapping_size_ = size;
+    header_ = new (memory) IpcSegmentHeader{};
+    header_->version = kIpcVersion;
+    header_->pid = static_cast<int32_t>(::getpid());
+    header_->capacity = capacity;
+    header_->stride = stride_;
+    header_->max_event_size = max_event_size_;
+    slots_ = static_cast<char*>(memory) + kSlotsOffset;
+    for (size_t i = 0; i < capacity; ++i) {
+        new (slots_ + i * stride_) IpcSlotHeader{};
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic = kIpcMagic;
+#else
+    (void)options;
+    throw std::system_error(std::make_error_code(std::errc::function_not_supported), "IPC transport");
+#endif
+}
+
+IpcWriter::~IpcWriter() {
+#ifdef __linux__
+    if (mapping_) {
+        ::munmap(mapping_, mapping_size_);
+        if (unlink_) {
+            ::shm_unlink(name_.c_str());
+        }
+    }
+#endif
+}
+
+void IpcWriter::write(uint64_t type_id, const void* data, size_t size) {
+    if (size > max_event_size_) {
+        throw std::length_error("IPC event of " + std::to_string(size) + " bytes exceeds max_event_size");
+    }
+
+    const uint64_t n = header_->head.fetch_add(1, std::memory_order_relaxed);
+    auto* slot = reinterpret_cast<IpcSlotHeader*>(slots_ + (n & mask_) * stride_);
+
+    slot->sequence.store((n + 1) | kBusy, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->type_id = type_id;
+    slot->size = static_cast<uint32_t>(size);
+    std::memcpy(reinterpret_cast<char*>(slot) + kPayloadOffset, data, size);
+    slot->sequence.store(n + 1, std::memory_order_release);
+
+#ifdef __linux__
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (header_->sleepers.load(std::memory_order_relaxed) != 0) {
+        header_->wake.fetch_add(1, std::memory_order_release);
+        futex_wake_all(header_->wake);
+    }
+#endif
+}
+
+uint64_t IpcWriter::published() const noexcept {
+    return header_ ? header_->head.load(std::memory_order_relaxed) : 0;
+}
+
+IpcReader::IpcReader(const std::string& name) {
+#ifdef __linux__
+    const int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= kSlotsOffset) {
+        mapping_size_ = static_cast<size_t>(info.st_size);
+        void* memory = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        mapping_ = memory == MAP_FAILED ? nullptr : memory;
+    }
+    ::close(fd);
+
+    header_ = static_cast<IpcSegmentHeader*>(mapping_);
+    if (!header_ || header_->magic != kIpcMagic || header_->version != kIpcVersion ||
+        header_->capacity == 0 || (header_->capacity & (header_->capacity - 1)) != 0 ||
+        header_->stride < kPayloadOffset + header_->max_event_size ||
+        kSlotsOffset + header_->capacity * header_->stride > mapping_size_) {
+        if (mapping_) {
+            ::munmap(mapping_, mapping_size_);
+            mapping_ = nullptr;
+        }
+        throw std::runtime_error("not an IPC segment: " + name);
+    }
+
+    slots_ = static_cast<const char*>(mapping_) + kSlotsOffset;
+    stride_ = header_->stride;
+    mask_ = header_->capacity - 1;
+    max_event_size_ = header_->max_event_size;
+    buffer_ = std::make_unique<std::max_align_t[]>(
+        (max_event_size_ + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t));
+    cursor_ = header_->head.load(std::memory_order_acquire);
+#else
+    (void)name;
+    throw std::system_error(std::make_error_code(std::errc::function_not_supported), "IPC transport");
+#endif
+}
+
+IpcReader::~IpcReader() {
+#ifdef __linux__
+    if (mapping_) {
+        ::munmap(mapping_, mapping_size_);
+    }
+#endif
+}
+
+size_t IpcReader::poll(Sink sink, void* context, size_t max_events) {
+    size_t delivered = 0;
+    while (delivered < max_events) {
+        const auto* slot = reinterpret_cast<const IpcSlotHeader*>(slots_ + (cursor_ & mask_) * stride_);
+        const uint64_t expected = cursor_ + 1;
+        const uint64_t before = slot->sequence.load(std::memory_order_acquire);
+        const uint64_t sequence = before & ~kBusy;
+        if (sequence < expected || before == (expected | kBusy)) {
+            break;                      // Not written yet
+        }
+
+        bool intact = sequence == expected;
+        size_t size = 0;
+        uint64_t type_id = 0;
+        if (intact) {
+            type_id = slot->type_id;
+            size = slot->size;
+            intact = size <= max_event_size_;
+        }
+        if (intact) {
+            std::memcpy(buffer_.get(), reinterpret_cast<const char*>(slot) + kPayloadOffset, size);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            intact = slot->sequence.load(std::memory_order_relaxed) == before;
+        }
+
+        if (!intact) {
+            // Lapped by the writer: skip to the oldest slot it has not yet
+            // reused.
+            const uint64_t head = header_->head.load(std::memory_order_acquire);
+            const uint64_t oldest = head > mask_ + 1 ? head - (mask_ + 1) : 0;
+            const uint64_t resume = std::max(oldest, cursor_ + 1);
+            lost_.store(lost_.load(std::memory_order_relaxed) + (resume - cursor_), std::memory_order_relaxed);
+            cursor_ = resume;
+            continue;
+        }
+
+        ++cursor_;
+        ++delivered;
+        received_.store(received_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        sink(context, type_id, buffer_.get(), size);
+    }
+    return delivered;
+}
+
+bool IpcReader::ready() const noexcept {
+    return header_->head.load(std::memory_order_acquire) > cursor_;
+}
+
+void IpcReader::wait(WaitStrategy strategy, uint32_t spin_budget) {
+    for (uint32_t i = 0; i < spin_budget; ++i) {
+        if (ready()) {
+            return;
+        }
+        cpu_relax();
+    }
+
+    if (strategy == WaitStrategy::BusySpin) {
+        return;
+    }
+    if (strategy == WaitStrategy::Yield) {
+        std::this_thread::yield();
+        return;
+    }
+
+#ifdef __linux__
+    // Bounded, so the owner can notice a stop request.
+    const uint32_t wake = header_->wake.load(std::memory_order_acquire);
+    header_->sleepers.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!ready()) {
+        futex_wait(header_->wake, wake, 10000000);
+    }
+    header_->sleepers.fetch_sub(1, std::memory_order_relaxed);
+#else
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+#endif
+}
+
+} // namespace detail
+
+} // namespace hft::core
@@ -0,0 +1,286 @@
+#include "hft_core/Journal.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include "hft_core/Timer.hpp"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hft::core {
+
+namespace {
+
+constexpr uint64_t kJournalMagic = 0x314e524a544648ull;    // "HFTJRN1"
+constexpr uint32_t kJournalVersion = 1;
+constexpr size_t kReadAheadBytes = size_t(32) << 20;
+
+struct JournalFileHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t chunk_size;
+    uint64_t created_ns;
+    uint64_t padding[4];
+};
+
+struct JournalRecordHeader {
+    uint32_t size;
+    uint32_t flags;
+    uint64_t timestamp;
+    uint64_t type_id;
+};
+
+static_assert(sizeof(JournalFileHeader) == 64, "journal header layout");
+static_assert(sizeof(JournalRecordHeader) == 24, "journal record layout");
+
+constexpr size_t align8(size_t bytes) noexcept {
+    return (bytes + 7) & ~size_t(7);
+}
+
+#ifdef __linux__
+size_t page_size() noexcept {
+    const long size = ::sysconf(_SC_PAGESIZE);
+    return size > 0 ? static_cast<size_t>(size) : 4096;
+}
+#endif
+
+} // namespace
+
+JournalWriter::JournalWriter(const std::string& path, const JournalOptions& options)
+    : path_(path), options_(options) {
+#ifdef __linux__
+    const size_t page = page_size();
+    chunk_size_ = std::max(page, (options.chunk_size + page - 1) / page * page);
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        throw std::system_error(errno, std::generic_category(), "open " + path);
+    }
+    try {
+        chunk_ = map_chunk(0);
+    } catch (...) {
+        ::close(fd_);
+        throw;
+    }
+
+    JournalFileHeader header{};
+    header.version = kJournalVersion;
+    header.chunk_size = chunk_size_;
+    header.created_ns = Timer::nanos_since_epoch();
+    header.magic = kJournalMagic;
+    std::memcpy(chunk_, &header, sizeof(header));
+    position_ = sizeof(header);
+#else
+    (void)options;
+    throw std::system_error(std::make_error_code(std::errc::function_not_supported), "event journal");
+#endif
+}
+
+JournalWriter::~JournalWriter() {
+#ifdef __linux__
+    if (fd_ < 0) {
+        return;
+    }
+    const uint64_t length = chunk_offset_ + position_;
+    if (options_.sync_on_close && chunk_) {
+        ::msync(chunk_, chunk_size_, MS_SYNC);
+    }
+    unmap_chunk();
+    // Drop the zero tail of the last chunk.
+    if (::ftruncate(fd_, static_cast<off_t>(length)) == 0 && options_.sync_on_close) {
+        ::fsync(fd_);
+    }
+    ::close(fd_);
+#endif
+}
+
+char* JournalWriter::map_chunk(uint64_t offset) {
+#ifdef __linux__
+    // Reserve the blocks up front: a sparse chunk written through the
+    // mapping would raise SIGBUS on a full disk instead of failing here.
+    if (const int error = ::posix_fallocate(fd_, static_cast<off_t>(offset), static_cast<off_t>(chunk_size_))) {
+        throw std::system_error(error, std::generic_category(), "posix_fallocate " + path_);
+    }
+    void* memory = ::mmap(nullptr, chunk_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, static_cast<off_t>(offset));
+    if (memory == MAP_FAILED) {
+        throw std::system_error(errno, std::generic_category(), "mmap " + path_);
+    }
+    return static_cast<char*>(memory);
+#else
+    (void)offset;
+    return nullptr;
+#endif
+}
+
+void JournalWriter::unmap_chunk() noexcept {
+#ifdef __linux__
+    if (chunk_) {
+        ::munmap(chunk_, chunk_size_);
+        chunk_ = nullptr;
+    }
+#endif
+}
+
+void JournalWriter::append(uint64_t type_id, uint64_t timestamp, const void* data, size_t size, size_t count) {
+    const size_t total = align8(sizeof(JournalRecordHeader) + size);
+    if (total > chunk_size_ - sizeof(JournalFileHeader)) {
+        throw std::length_error("journal record larger than a chunk");
+    }
+
+    const char* bytes = static_cast<const char*>(data);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < count; ++i, bytes += size) {
+        if (position_ + total > chunk_size_) {
+            // Map first: if that throws, the current chunk stays usable.
+            const uint64_t next = chunk_offset_ + chunk_size_;
+            char* mapped = map_chunk(next);
+            unmap_chunk();
+            chunk_ = mapped;
+            chunk_offset_ = next;
+            position_ = 0;
+        }
+
+        // Everything but the size first: a record only exists once its size
+        // is non-zero, so a crash mid-append leaves no half-written record.
+        JournalRecordHeader header{0, 0, timestamp, type_id};
+        char* out = chunk_ + position_;
+        std::memcpy(out, &header, sizeof(header));
+        std::memcpy(out + sizeof(header), bytes, size);
+        __atomic_store_n(reinterpret_cast<uint32_t*>(out), static_cast<uint32_t>(size), __ATOMIC_RELEASE);
+        position_ += total;
+        ++records_;
+    }
+}
+
+void JournalWriter::flush() {
+#ifdef __linux__
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (chunk_) {
+        const size_t page = page_size();
+        ::msync(chunk_, std::min(chunk_size_, (position_ + page - 1) / page * page), MS_ASYNC);
+    }
+#endif
+}
+
+uint64_t JournalWriter::records() const noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_;
+}
+
+uint64_t JournalWriter::bytes() const noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return chunk_offset_ + position_;
+}
+
+JournalReader::JournalReader(const std::string& path) {
+#ifdef __linux__
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "open " + path);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "fstat " + path);
+    }
+    if (static_cast<size_t>(st.st_size) < sizeof(JournalFileHeader)) {
+        ::close(fd);
+        throw std::runtime_error("not an event journal: " + path);
+    }
+
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* memory = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    const int error = errno;
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        throw std::system_error(error, std::generic_category(), "mmap " + path);
+    }
+
+    JournalFileHeader header;
+    std::memcpy(&header, memory, sizeof(header));
+    if (header.magic != kJournalMagic || header.version != kJournalVersion || header.chunk_size == 0) {
+        ::munmap(memory, size);
+        throw std::runtime_error("not an event journal: " + path);
+    }
+
+    ::madvise(memory, size, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(memory);
+    size_ = size;
+    chunk_size_ = header.chunk_size;
+    rewind();
+#else
+    (void)path;
+    throw std::system_error(std::make_error_code(std::errc::function_not_supported), "event journal");
+#endif
+}
+
+JournalReader::~JournalReader() {
+#ifdef __linux__
+    if (data_) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+}
+
+void JournalReader::rewind() noexcept {
+    position_ = sizeof(JournalFileHeader);
+    advised_ = 0;
+    read_ahead(position_);
+}
+
+void JournalReader::read_ahead(size_t position) noexcept {
+#ifdef __linux__
+    // Keep one window queued ahead of the cursor.
+    if (position + kReadAheadBytes <= advised_ || advised_ >= size_) {
+        return;
+    }
+    const size_t length = std::min(kReadAheadBytes, size_ - advised_);
+    ::madvise(const_cast<char*>(data_) + advised_, length, MADV_WILLNEED);
+    advised_ += length;
+#else
+    (void)position;
+#endif
+}
+
+bool JournalReader::next(JournalRecord& record) noexcept {
+    while (position_ < size_) {
+        const size_t chunk_end = std::min(size_, (position_ / chunk_size_ + 1) * chunk_size_);
+        if (position_ + sizeof(JournalRecordHeader) > chunk_end) {
+            position_ = chunk_end;
+            continue;
+        }
+
+        JournalRecordHeader header;
+        header.size = __atomic_load_n(reinterpret_cast<const uint32_t*>(data_ + position_), __ATOMIC_ACQUIRE);
+        if (header.size != 0) {
+            std::memcpy(&header, data_ + position_, sizeof(header));
+        }
+        const size_t total = align8(sizeof(header) + header.size);
+        if (header.size == 0 || position_ + total > chunk_end) {
+            // Unused chunk tail, or a record cut short by a crash.
+            position_ = chunk_end;
+            continue;
+        }
+
+        record.timestamp = header.timestamp;
+        record.type_id = header.type_id;
+        record.data = data_ + position_ + sizeof(header);
+        record.size = header.size;
+        position_ += total;
+        read_ahead(position_);
+        return true;
+    }
+    return false;
+}
+
+} // namespace hft::core
@@ -1,5 +1,1184 @@
 #include "hft_core/Logger.hpp"
 
+#include <algorithm>
+#include <charconv>
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace hft::core {
 
-} // namespace hft::core
\ No newline at end of file
+namespace detail {
+
+const LogSite kRuntimeLogSite{
+    LogLevel::INFO, "", 0, "{}",
+    log_arg_types<int64_t, int64_t, std::string, std::string>, 4};
+
+// Batching writer owned by the background thread. Output goes either through
+// write() or, with LogSinkOptions::memory_mapped, by memcpy into pre-faulted
+// windows of the file. A helper thread maps the next window and the next
+// rotation segment ahead of time and runs fdatasync(), so the drain loop
+// never waits on the disk.
+class LogFileSink {
+public:
+    LogFileSink(int fd, bool owns_fd, const LogSinkOptions& options)
+        : LogFileSink(std::string(), fd, owns_fd, options) {}
+
+    LogFileSink(std::string filename, int fd, bool owns_fd, const LogSinkOptions& options)
+        : filename_(std::move(filename)), owns_fd_(owns_fd), options_(options),
+          opened_at_(std::chrono::steady_clock::now()) {
+        buffer_.reserve(options_.buffer_size + 4096);
+        segment_.fd = fd;
+
+        const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        window_size_ = (std::max(options_.mmap_window_size, page) + page - 1) / page * page;
+
+        mapped_ = options_.memory_mapped && owns_fd_;
+        if (mapped_) {
+            struct stat st {};
+            segment_bytes_ = ::fstat(fd, &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+            const size_t offset = segment_bytes_ / page * page;
+            if (!map_current(offset, segment_bytes_ - offset)) {
+                fall_back_to_write();
+            }
+        }
+
+        if (owns_fd_ && (options_.fsync || mapped_)) {
+            helper_ = std::thread(&LogFileSink::helper_loop, this);
+            request_preparation();
+        }
+    }
+
+    LogFileSink(const LogFileSink&) = delete;
+    LogFileSink& operator=(const LogFileSink&) = delete;
+
+    ~LogFileSink() {
+        write_out();
+        if (helper_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(helper_mutex_);
+                stop_ = true;
+            }
+            helper_cv_.notify_one();
+            helper_.join();
+        }
+        discard(prepared_window_);
+        if (prepared_segment_.base) {
+            discard(prepared_segment_);
+            ::unlink(segment_name(prepared_segment_.segment).c_str());
+        }
+        close_segment();
+    }
+
+    // Opens for appending (text) or truncates (binary). Returns nullptr when
+    // the file cannot be opened.
+    static std::unique_ptr<LogFileSink> open(const std::string& filename, bool truncate,
+                                             const LogSinkOptions& options) {
+        const int fd = open_file(filename, truncate, options.memory_mapped);
+        if (fd < 0) {
+            return nullptr;
+        }
+        return std::make_unique<LogFileSink>(filename, fd, true, options);
+    }
+
+    std::string& buffer() noexcept {
+        return buffer_;
+    }
+
+    // Called after appending to buffer(); starts the flush_interval clock
+    // for the oldest unwritten line.
+    void appended(std::chrono::steady_clock::time_point now) noexcept {
+        if (!pending_) {
+            pending_ = true;
+            pending_since_ = now;
+        }
+    }
+
+    bool should_write(std::chrono::steady_clock::time_point now) const noexcept {
+        return pending_ && (buffer_.size() >= options_.buffer_size ||
+                            now - pending_since_ >= options_.flush_interval);
+    }
+
+    bool should_rotate(std::chrono::steady_clock::time_point now) const noexcept {
+        if (!owns_fd_ || filename_.empty()) {
+            return false;
+        }
+        const size_t bytes = segment_bytes_ + buffer_.size();
+        return (options_.rotate_size != 0 && bytes >= options_.rotate_size) ||
+               (options_.rotate_interval.count() != 0 && now - opened_at_ >= options_.rotate_interval);
+    }
+
+    // Writes out pending data and continues in filename.N+1. Segments are
+    // numbered from the base file name, which is segment 0.
+    void rotate() {
+        write_out();
+        close_segment();
+
+        const size_t next = segment_.index + 1;
+        opened_at_ = std::chrono::steady_clock::now();
+        segment_bytes_ = 0;
+
+        Window prepared;
+        if (mapped_ && take(prepared_segment_, prepared, next, 0)) {
+            segment_.fd = prepared.fd;
+            segment_.index = next;
+            window_ = prepared;
+            window_used_ = 0;
+        } else {
+            segment_.fd = open_file(segment_name(next), true, mapped_);
+            segment_.index = next;
+            if (segment_.fd < 0) {
+                return;     // Keep draining; output is lost until the next rotation
+            }
+            if (mapped_ && !map_current(0, 0)) {
+                fall_back_to_write();
+            }
+        }
+        request_preparation();
+    }
+
+    void write_out() noexcept {
+        if (!buffer_.empty() && segment_.fd >= 0) {
+            if (mapped_) {
+                copy_to_mapping(buffer_.data(), buffer_.size());
+            } else {
+                write_fd(buffer_.data(), buffer_.size());
+            }
+            segment_bytes_ += buffer_.size();
+            dirty_.store(true, std::memory_order_release);
+        }
+        buffer_.clear();
+        pending_ = false;
+    }
+
+private:
+    struct Segment {
+        int fd = -1;
+        size_t index = 0;
+    };
+
+    struct Window {
+        int fd = -1;
+        size_t segment = 0;
+        size_t offset = 0;
+        char* base = nullptr;
+    };
+
+    static int open_file(const std::string& filename, bool truncate, bool mapped) {
+        // Mapped files are written in place, so they are never O_APPEND.
+        int flags = O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0);
+        flags |= mapped ? O_RDWR : (O_WRONLY | (truncate ? 0 : O_APPEND));
+        return ::open(filename.c_str(), flags, 0644);
+    }
+
+    std::string segment_name(size_t index) const {
+        return index == 0 ? filename_ : filename_ + "." + std::to_string(index);
+    }
+
+    // Extends the file to cover [offset, offset + window_size_) and maps it
+    // with every page faulted in.
+    char* map_window(int fd, size_t offset) const noexcept {
+        const auto end = static_cast<off_t>(offset + window_size_);
+#ifdef __linux__
+        if (::posix_fallocate(fd, static_cast<off_t>(offset), static_cast<off_t>(window_size_)) != 0)
+#endif
+        {
+            struct stat st {};
+            if (::fstat(fd, &st) != 0 || (st.st_size < end && ::ftruncate(fd, end) != 0)) {
+                return nullptr;
+            }
+        }
+
+        int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+        flags |= MAP_POPULATE;
+#endif
+        void* base = ::mmap(nullptr, window_size_, PROT_READ | PROT_WRITE, flags, fd,
+                            static_cast<off_t>(offset));
+        if (base == MAP_FAILED) {
+            return nullptr;
+        }
+#ifndef MAP_POPULATE
+        const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        for (size_t i = 0; i < window_size_; i += page) {
+            static_cast<volatile char*>(base)[i] = 0;
+        }
+#endif
+        return static_cast<char*>(base);
+    }
+
+    bool map_current(size_t offset, size_t used) noexcept {
+        window_.fd = segment_.fd;
+        window_.segment = segment_.index;
+        window_.offset = offset;
+        window_.base = map_window(segment_.fd, offset);
+        window_used_ = used;
+        return window_.base != nullptr;
+    }
+
+    void unmap(Window& window) noexcept {
+        if (window.base) {
+            ::munmap(window.base, window_size_);
+            window.base = nullptr;
+        }
+    }
+
+    void discard(Window& window) noexcept {
+        unmap(window);
+        if (window.fd >= 0 && window.fd != segment_.fd) {
+            ::close(window.fd);
+        }
+        window.fd = -1;
+    }
+
+    // Moves a window prepared by the helper into `out` if it is the one we
+    // need next; anything else is stale and dropped.
+    bool take(Window& slot, Window& out, size_t segment, size_t offset) noexcept {
+        std::lock_guard<std::mutex> lock(helper_mutex_);
+        if (!slot.base) {
+            return false;
+        }
+        if (slot.segment != segment || slot.offset != offset) {
+            discard(slot);
+            return false;
+        }
+        out = slot;
+        slot = Window{};
+        return true;
+    }
+
+    void copy_to_mapping(const char* data, size_t size) noexcept {
+        while (size != 0) {
+            if (window_used_ == window_size_ && !advance_window()) {
+                fall_back_to_write();
+                write_fd(data, size);
+                return;
+            }
+            const size_t n = std::min(size, window_size_ - window_used_);
+            std::memcpy(window_.base + window_used_, data, n);
+            window_used_ += n;
+            data += n;
+            size -= n;
+        }
+    }
+
+    bool advance_window() noexcept {
+        const size_t offset = window_.offset + window_size_;
+        unmap(window_);
+
+        Window prepared;
+        if (take(prepared_window_, prepared, segment_.index, offset)) {
+            prepared.fd = segment_.fd;
+            window_ = prepared;
+            window_used_ = 0;
+        } else if (!map_current(offset, 0)) {
+            return false;
+        }
+        request_preparation();
+        return true;
+    }
+
+    // Switches a mapped segment to plain write() at its logical end, e.g.
+    // when the file system refuses to map or extend it.
+    void fall_back_to_write() noexcept {
+        unmap(window_);
+        mapped_ = false;
+        if (segment_.fd >= 0) {
+            std::unique_lock<std::mutex> lock(helper_mutex_);
+            stop_preparing(lock);
+            if (prepared_segment_.base) {
+                // rotate() will create that segment itself now
+                discard(prepared_segment_);
+                ::unlink(segment_name(prepared_segment_.segment).c_str());
+            }
+            ::ftruncate(segment_.fd, static_cast<off_t>(segment_bytes_));
+            ::lseek(segment_.fd, 0, SEEK_END);
+        }
+    }
+
+    void close_segment() noexcept {
+        unmap(window_);
+        if (segment_.fd < 0) {
+            return;
+        }
+        // Under the lock so the helper never dup()s a closed descriptor.
+        std::unique_lock<std::mutex> lock(helper_mutex_);
+        stop_preparing(lock);
+        sync_fd_ = -1;
+        if (mapped_) {
+            // Drop the preallocated tail beyond what was actually written.
+            ::ftruncate(segment_.fd, static_cast<off_t>(segment_bytes_));
+        }
+        if (owns_fd_) {
+            ::close(segment_.fd);
+        }
+        segment_.fd = -1;
+    }
+
+    // Waits out a preparation in flight and cancels further ones for the
+    // current segment, so the helper neither extends it after we truncate
+    // it nor creates (O_TRUNC) the next segment after we opened it.
+    void stop_preparing(std::unique_lock<std::mutex>& lock) noexcept {
+        prepared_cv_.wait(lock, [this] { return !preparing_; });
+        discard(prepared_window_);
+        want_window_.fd = -1;
+    }
+
+    void write_fd(const char* data, size_t remaining) noexcept {
+        while (remaining != 0) {
+            const ssize_t written = ::write(segment_.fd, data, remaining);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;     // Nowhere to report it; drop the batch
+            }
+            data += written;
+            remaining -= static_cast<size_t>(written);
+        }
+    }
+
+    // Tells the helper which window and segment come next.
+    void request_preparation() {
+        if (!helper_.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(helper_mutex_);
+            sync_fd_ = segment_.fd;
+            if (mapped_) {
+                want_window_ = Window{segment_.fd, segment_.index, window_.offset + window_size_, nullptr};
+                want_segment_ = (options_.rotate_size != 0 || options_.rotate_interval.count() != 0) &&
+                                !filename_.empty();
+                prepare_requested_ = true;
+            }
+        }
+        helper_cv_.notify_one();
+    }
+
+    void helper_loop() {
+        const auto idle = options_.fsync ? options_.fsync_interval : std::chrono::milliseconds(1000);
+        std::unique_lock<std::mutex> lock(helper_mutex_);
+        while (!stop_) {
+            helper_cv_.wait_for(lock, idle, [this] { return stop_ || prepare_requested_; });
+            if (stop_) {
+                break;
+            }
+
+            if (prepare_requested_) {
+                prepare_requested_ = false;
+                prepare(lock);
+            }
+
+            if (options_.fsync && sync_fd_ >= 0 && dirty_.exchange(false, std::memory_order_acq_rel)) {
+                // dup() so the worker can close the segment while we sync.
+                const int fd = ::dup(sync_fd_);
+                lock.unlock();
+                if (fd >= 0) {
+#ifdef __linux__
+                    ::fdatasync(fd);
+#else
+                    ::fsync(fd);
+#endif
+                    ::close(fd);
+                }
+                lock.lock();
+            }
+        }
+    }
+
+    // Maps the requested next window and creates the next segment with its
+    // first window, all without holding the lock.
+    void prepare(std::unique_lock<std::mutex>& lock) {
+        const Window want = want_window_;
+        if (want.fd < 0) {
+            return;     // Segment closed since the request
+        }
+        preparing_ = true;
+        if (!prepared_window_.base) {
+            const int fd = ::dup(want.fd);
+            lock.unlock();
+            char* base = fd >= 0 ? map_window(fd, want.offset) : nullptr;
+            if (fd >= 0) {
+                ::close(fd);    // The mapping keeps the file referenced
+            }
+            lock.lock();
+            if (base) {
+                prepared_window_ = Window{-1, want.segment, want.offset, base};
+            }
+        }
+
+        if (want_segment_ && (!prepared_segment_.base || prepared_segment_.segment != want.segment + 1)) {
+            if (prepared_segment_.base) {
+                discard(prepared_segment_);
+            }
+            const size_t index = want.segment + 1;
+            lock.unlock();
+            const int fd = open_file(segment_name(index), true, true);
+            char* base = fd >= 0 ? map_window(fd, 0) : nullptr;
+            if (fd >= 0 && !base) {
+                ::close(fd);
+            }
+            lock.lock();
+            if (base) {
+                prepared_segment_ = Window{fd, index, 0, base};
+            }
+        }
+        preparing_ = false;
+        prepared_cv_.notify_all();
+    }
+
+    const std::string filename_;
+    const bool owns_fd_;
+    const LogSinkOptions options_;
+    size_t window_size_ = 0;
+    bool mapped_ = false;
+
+    std::string buffer_;
+    bool pending_ = false;
+    std::chrono::steady_clock::time_point pending_since_;
+
+    Segment segment_;
+    size_t segment_bytes_ = 0;
+    std::chrono::steady_clock::time_point opened_at_;
+    Window window_;
+    size_t window_used_ = 0;
+
+    std::atomic<bool> dirty_{false};
+    std::thread helper_;
+    std::mutex helper_mutex_;
+    std::condition_variable helper_cv_;
+    bool stop_ = false;
+    bool prepare_requested_ = false;
+    bool preparing_ = false;                // Helper is mapping without the lock
+    std::condition_variable prepared_cv_;
+    bool want_segment_ = false;
+    int sync_fd_ = -1;
+    Window want_window_;
+    Window prepared_window_;
+    Window prepared_segment_;
+};
+
+} // namespace detail
+
+namespace {
+
+constexpr char kBinaryMagic[8] = {'H', 'F', 'T', 'L', 'O', 'G', '\0', '\1'};
+
+enum BinaryEntry : uint8_t {
+    kSiteEntry = 1,
+    kThreadEntry = 2,
+    kAnchorEntry = 3,
+    kRecordEntry = 4
+};
+
+constexpr uint32_t kRuntimeSiteId = 0;
+
+const char* level_to_string(LogLevel level) {
+    switch (level) {
+        case LogLevel::TRACE: return "TRACE";
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO:  return "INFO";
+        case LogLevel::WARN:  return "WARN";
+        case LogLevel::ERROR: return "ERROR";
+        case LogLevel::FATAL: return "FATAL";
+        default: return "UNKNOWN";
+    }
+}
+
+// Maps raw TSC readings from the producers onto wall-clock time with the
+// calibrated Timer clock. The (tsc, wall, ns per tick) anchor is refreshed
+// by the background thread and written to binary logs for the decoder.
+class ClockAnchor {
+public:
+    ClockAnchor() {
+        take(Timer::rdtsc());
+    }
+
+    void refresh() {
+        const uint64_t tsc = Timer::rdtsc();
+        if (Timer::ticks_to_nanos(tsc - latest_tsc_) < 1000000) {
+            return;
+        }
+        take(tsc);
+    }
+
+    uint64_t to_wall_ns(uint64_t tsc) const {
+        return Timer::tsc_to_epoch_ns(tsc);
+    }
+
+    uint64_t latest_tsc() const { return latest_tsc_; }
+    uint64_t latest_wall() const { return latest_wall_; }
+    double ns_per_tick() const { return ns_per_tick_; }
+
+private:
+    void take(uint64_t tsc) {
+        latest_tsc_ = tsc;
+        latest_wall_ = Timer::tsc_to_epoch_ns(tsc);
+        ns_per_tick_ = 1e9 / static_cast<double>(Timer::tsc_frequency());
+    }
+
+    uint64_t latest_tsc_ = 0;
+    uint64_t latest_wall_ = 0;
+    double ns_per_tick_ = 1.0;
+};
+
+template<typename T>
+T read_scalar(const char*& in) {
+    T value;
+    std::memcpy(&value, in, sizeof(T));
+    in += sizeof(uint64_t);
+    return value;
+}
+
+std::string_view read_string(const char*& in) {
+    uint32_t length;
+    std::memcpy(&length, in, sizeof(length));
+    std::string_view str(in + sizeof(length), length);
+    in += detail::align8(sizeof(length) + length);
+    return str;
+}
+
+template<typename T>
+void append_number(std::string& out, T value) {
+    char buffer[64];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void append_arg(std::string& out, LogArgType type, const char*& in) {
+    switch (type) {
+        case LogArgType::Bool:
+            out += read_scalar<uint64_t>(in) ? "true" : "false";
+            break;
+        case LogArgType::Char:
+            out += static_cast<char>(read_scalar<int64_t>(in));
+            break;
+        case LogArgType::Int64:
+            append_number(out, read_scalar<int64_t>(in));
+            break;
+        case LogArgType::UInt64:
+            append_number(out, read_scalar<uint64_t>(in));
+            break;
+        case LogArgType::Double:
+            append_number(out, read_scalar<double>(in));
+            break;
+        case LogArgType::Pointer: {
+            out += "0x";
+            char buffer[32];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), read_scalar<uint64_t>(in), 16);
+            out.append(buffer, result.ptr);
+            break;
+        }
+        case LogArgType::String:
+            out += read_string(in);
+            break;
+    }
+}
+
+// Expands "{}" placeholders in order; "{{" and "}}" are literal braces.
+void format_message(std::string& out, const char* format, const LogArgType* types,
+                    uint32_t arg_count, const char* payload) {
+    uint32_t next_arg = 0;
+    for (const char* p = format; *p; ++p) {
+        if (p[0] == '{' && p[1] == '}') {
+            if (next_arg < arg_count) {
+                append_arg(out, types[next_arg++], payload);
+            } else {
+                out += "{}";
+            }
+            ++p;
+        } else if ((p[0] == '{' && p[1] == '{') || (p[0] == '}' && p[1] == '}')) {
+            out += *p++;
+        } else {
+            out += *p;
+        }
+    }
+}
+
+// "%Y-%m-%d %H:%M:%S " for the current second, so localtime_r() and
+// strftime() run once per second instead of once per line.
+class TimestampCache {
+public:
+    void append(std::string& out, uint64_t wall_ns) {
+        const auto seconds = static_cast<std::time_t>(wall_ns / 1000000000ULL);
+        if (seconds != cached_second_) {
+            std::tm tm{};
+            localtime_r(&seconds, &tm);
+            length_ = std::strftime(prefix_, sizeof(prefix_), "%Y-%m-%d %H:%M:%S ", &tm);
+            cached_second_ = seconds;
+        }
+        out.append(prefix_, length_);
+    }
+
+private:
+    std::time_t cached_second_ = -1;
+    char prefix_[32];
+    size_t length_ = 0;
+};
+
+void append_log_line(std::string& out, TimestampCache& timestamps, LogLevel level, uint64_t wall_ns,
+                     const std::string& thread_label, std::string_view file, int line,
+                     const char* format, const LogArgType* types, uint32_t arg_count,
+                     const char* payload) {
+    timestamps.append(out, wall_ns);
+    out += '[';
+    out += level_to_string(level);
+    out += "] [";
+    out += thread_label;
+    out += "] ";
+    format_message(out, format, types, arg_count, payload);
+    out += " (";
+    out += file;
+    out += ':';
+    append_number(out, line);
+    out += ")\n";
+}
+
+// Formats one staged record. Runtime records carry their own level, line,
+// file and message in the payload.
+void append_record(std::string& out, TimestampCache& timestamps, const LogSite& site,
+                   uint64_t wall_ns, const std::string& thread_label, const char* payload) {
+    if (&site == &detail::kRuntimeLogSite) {
+        const char* in = payload;
+        auto level = static_cast<LogLevel>(read_scalar<int64_t>(in));
+        auto line = static_cast<int>(read_scalar<int64_t>(in));
+        std::string_view file = read_string(in);
+        append_log_line(out, timestamps, level, wall_ns, thread_label, file, line,
+                        "{}", &site.arg_types[3], 1, in);
+        return;
+    }
+
+    append_log_line(out, timestamps, site.level, wall_ns, thread_label, site.file, site.line,
+                    site.format, site.arg_types, site.arg_count, payload);
+}
+
+// Whether every argument lies within [payload, end); checked before any of
+// them is read, so a truncated or corrupt file cannot send the decoder out
+// of bounds.
+bool payload_fits(const LogArgType* types, uint32_t arg_count, const char* payload, const char* end) {
+    size_t remaining = static_cast<size_t>(end - payload);
+    const char* in = payload;
+    for (uint32_t i = 0; i < arg_count; ++i) {
+        size_t size = sizeof(uint64_t);
+        if (types[i] == LogArgType::String) {
+            uint32_t length;
+            if (remaining < sizeof(length)) {
+                return false;
+            }
+            std::memcpy(&length, in, sizeof(length));
+            size = detail::align8(sizeof(length) + static_cast<size_t>(length));
+        }
+        if (size > remaining) {
+            return false;
+        }
+        in += size;
+        remaining -= size;
+    }
+    return true;
+}
+
+template<typename T>
+void put(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void put_string(std::string& out, std::string_view str) {
+    put(out, static_cast<uint32_t>(str.size()));
+    out.append(str.data(), str.size());
+}
+
+// Incremental writer for LogFormat::Binary. Site and thread definitions are
+// emitted the first time they are referenced, so the file is self-describing.
+class BinaryEncoder {
+public:
+    void append_header(std::string& out) {
+        out.append(kBinaryMagic, sizeof(kBinaryMagic));
+        sites_.clear();
+        threads_.clear();
+    }
+
+    void append_anchor(std::string& out, const ClockAnchor& anchor) {
+        put(out, kAnchorEntry);
+        put(out, anchor.latest_tsc());
+        put(out, anchor.latest_wall());
+        put(out, anchor.ns_per_tick());
+    }
+
+    void append_record(std::string& out, const detail::RecordHeader& record,
+                       const detail::StagingBuffer& buffer) {
+        const LogSite& site = *record.site;
+        const uint32_t site_id = site_id_for(out, site);
+        const uint32_t thread_id = thread_id_for(out, buffer);
+        const char* payload = reinterpret_cast<const char*>(&record) + sizeof(detail::RecordHeader);
+
+        put(out, kRecordEntry);
+        put(out, site_id);
+        put(out, thread_id);
+        put(out, record.tsc);
+        const auto length = static_cast<uint32_t>(record.size - sizeof(detail::RecordHeader));
+        put(out, length);
+        out.append(payload, length);
+    }
+
+private:
+    uint32_t site_id_for(std::string& out, const LogSite& site) {
+        if (&site == &detail::kRuntimeLogSite) {
+            return kRuntimeSiteId;
+        }
+        auto [it, inserted] = sites_.try_emplace(&site, static_cast<uint32_t>(sites_.size() + 1));
+        if (inserted) {
+            put(out, kSiteEntry);
+            put(out, it->second);
+            put(out, static_cast<uint8_t>(site.level));
+            put(out, static_cast<int32_t>(site.line));
+            put(out, site.arg_count);
+            out.append(reinterpret_cast<const char*>(site.arg_types), site.arg_count);
+            put_string(out, site.file);
+            put_string(out, site.format);
+        }
+        return it->second;
+    }
+
+    uint32_t thread_id_for(std::string& out, const detail::StagingBuffer& buffer) {
+        auto [it, inserted] = threads_.try_emplace(&buffer, static_cast<uint32_t>(threads_.size()));
+        if (inserted) {
+            put(out, kThreadEntry);
+            put(out, it->second);
+            put_string(out, buffer.thread_label);
+        }
+        return it->second;
+    }
+
+    std::unordered_map<const LogSite*, uint32_t> sites_;
+    std::unordered_map<const detail::StagingBuffer*, uint32_t> threads_;
+};
+
+// The calling thread's staging buffers, one per Logger it has logged to;
+// marks them retired when the thread exits.
+struct ThreadBufferOwner {
+    std::vector<std::pair<uint64_t, std::shared_ptr<detail::StagingBuffer>>> buffers;
+
+    ~ThreadBufferOwner() {
+        for (const auto& entry : buffers) {
+            entry.second->retired.store(true, std::memory_order_release);
+        }
+    }
+
+    detail::StagingBuffer* find(uint64_t logger_id) const noexcept {
+        for (const auto& [id, buffer] : buffers) {
+            if (id == logger_id) {
+                return buffer.get();
+            }
+        }
+        return nullptr;
+    }
+};
+
+ThreadBufferOwner& thread_buffers() {
+    static thread_local ThreadBufferOwner owner;
+    return owner;
+}
+
+uint64_t next_logger_id() noexcept {
+    static std::atomic<uint64_t> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+Logger::Logger() : id_(next_logger_id()), min_level_(LogLevel::INFO), stop_requested_(false) {
+    start_background_thread();
+}
+
+Logger::~Logger() {
+    stop();
+    // Lets threads that outlive this logger drop their buffers for it.
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    for (const auto& buffer : buffers_) {
+        buffer->retired.store(true, std::memory_order_release);
+    }
+}
+
+void Logger::set_output_file(const std::string& filename, LogFormat format) {
+    flush();
+
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    sink_.reset();
+    output_file_ = filename;
+    output_format_ = format;
+    sink_ = detail::LogFileSink::open(filename, format == LogFormat::Binary, sink_options_);
+    binary_header_pending_ = format == LogFormat::Binary;
+}
+
+void Logger::set_sink_options(const LogSinkOptions& options) {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    sink_options_ = options;
+}
+
+LogSinkOptions Logger::sink_options() const {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    return sink_options_;
+}
+
+detail::StagingBuffer* Logger::register_thread() noexcept {
+    try {
+        ThreadBufferOwner& owner = thread_buffers();
+        if (detail::StagingBuffer* existing = owner.find(id_)) {
+            cached_buffer() = ThreadBufferCache{id_, existing};
+            return existing;
+        }
+        auto& owned = owner.buffers;
+        owned.erase(std::remove_if(owned.begin(), owned.end(), [](const auto& entry) {
+            return entry.second->retired.load(std::memory_order_acquire);
+        }), owned.end());
+
+        auto buffer = std::make_shared<detail::StagingBuffer>(
+            thread_buffer_size_.load(std::memory_order_relaxed),
+            backpressure_.load(std::memory_order_relaxed));
+        std::ostringstream label;
+        label << std::this_thread::get_id();
+        buffer->thread_label = label.str();
+
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex_);
+            buffers_.push_back(buffer);
+            registry_version_.fetch_add(1, std::memory_order_release);
+        }
+        owned.emplace_back(id_, buffer);
+        cached_buffer() = ThreadBufferCache{id_, buffer.get()};
+        return buffer.get();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void Logger::flush() {
+    if (!background_thread_.joinable()) {
+        return;
+    }
+
+    std::vector<std::pair<std::shared_ptr<detail::StagingBuffer>, size_t>> targets;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        targets.reserve(buffers_.size());
+        for (const auto& buffer : buffers_) {
+            targets.emplace_back(buffer, buffer->tail_position());
+        }
+    }
+
+    auto drained = [&targets] {
+        for (const auto& [buffer, tail] : targets) {
+            if (buffer->head_position() < tail) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    wake_requested_ = true;
+    wake_cv_.notify_one();
+    flush_cv_.wait(lock, [&] { return drained() || !background_thread_.joinable(); });
+
+    // Records are consumed before their batch is written; two more passes
+    // guarantee one that saw flush_requested_ has written it out.
+    const uint64_t target = completed_passes_.load(std::memory_order_acquire) + 2;
+    flush_requested_.store(true, std::memory_order_release);
+    wake_requested_ = true;
+    wake_cv_.notify_one();
+    flush_cv_.wait(lock, [this, target] {
+        return completed_passes_.load(std::memory_order_acquire) >= target ||
+               !background_thread_.joinable();
+    });
+}
+
+void Logger::wake_worker() noexcept {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_requested_ = true;
+    }
+    wake_cv_.notify_one();
+}
+
+LogThreadStats Logger::make_stats(const detail::StagingBuffer& buffer) {
+    LogThreadStats stats;
+    stats.thread_label = buffer.thread_label;
+    stats.enqueued = buffer.enqueued.load(std::memory_order_relaxed);
+    stats.dropped = buffer.dropped.load(std::memory_order_relaxed);
+    stats.overwritten = buffer.overwritten.load(std::memory_order_relaxed);
+    stats.blocked = buffer.blocked.load(std::memory_order_relaxed);
+    stats.pending_bytes = buffer.pending_bytes();
+    return stats;
+}
+
+std::vector<LogThreadStats> Logger::thread_stats() const {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    std::vector<LogThreadStats> stats;
+    stats.reserve(buffers_.size());
+    for (const auto& buffer : buffers_) {
+        stats.push_back(make_stats(*buffer));
+    }
+    return stats;
+}
+
+LogThreadStats Logger::current_thread_stats() const {
+    const detail::StagingBuffer* buffer = thread_buffers().find(id_);
+    return buffer ? make_stats(*buffer) : LogThreadStats{};
+}
+
+void Logger::start_background_thread() {
+    stop_requested_.store(false, std::memory_order_release);
+    background_thread_ = std::thread(&Logger::background_worker, this);
+}
+
+void Logger::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stop_requested_.store(true, std::memory_order_release);
+    }
+    wake_cv_.notify_one();
+
+    if (background_thread_.joinable()) {
+        background_thread_.join();
+    }
+    flush_cv_.notify_all();
+}
+
+void Logger::background_worker() {
+    constexpr auto kIdleInterval = std::chrono::milliseconds(1);
+    constexpr size_t kDrainQuantum = 64;
+    constexpr size_t kMaxPassRecords = 16384;
+
+    std::vector<std::shared_ptr<detail::StagingBuffer>> buffers;
+    uint64_t seen_version = ~uint64_t(0);
+    ClockAnchor clock;
+    BinaryEncoder encoder;
+    TimestampCache timestamps;
+    detail::LogFileSink console(STDOUT_FILENO, false, LogSinkOptions{});
+
+    for (;;) {
+        const bool stopping = stop_requested_.load(std::memory_order_acquire);
+
+        const uint64_t version = registry_version_.load(std::memory_order_acquire);
+        if (version != seen_version) {
+            std::lock_guard<std::mutex> lock(registry_mutex_);
+            buffers = buffers_;
+            seen_version = registry_version_.load(std::memory_order_relaxed);
+        }
+
+        clock.refresh();
+        const auto now = std::chrono::steady_clock::now();
+        size_t drained = 0;
+        {
+            std::lock_guard<std::mutex> lock(config_mutex_);
+            if (sink_ && sink_->should_rotate(now)) {
+                sink_->rotate();
+                binary_header_pending_ = output_format_ == LogFormat::Binary;
+            }
+            detail::LogFileSink& sink = sink_ ? *sink_ : console;
+            const bool binary = output_format_ == LogFormat::Binary && sink_;
+            const size_t batch_limit = sink_options_.buffer_size;
+            std::string& out = sink.buffer();
+
+            if (binary && binary_header_pending_) {
+                encoder.append_header(out);
+                binary_header_pending_ = false;
+                sink.appended(now);
+            }
+            const size_t mark = out.size();
+            if (binary) {
+                encoder.append_anchor(out, clock);
+            }
+
+            auto write_record = [&](const detail::RecordHeader& record, const detail::StagingBuffer& buffer) {
+                if (binary) {
+                    encoder.append_record(out, record, buffer);
+                } else {
+                    append_record(out, timestamps, *record.site, clock.to_wall_ns(record.tsc),
+                                  buffer.thread_label,
+                                  reinterpret_cast<const char*>(&record) + sizeof(detail::RecordHeader));
+                }
+            };
+
+            // Round-robin so one noisy thread cannot starve the others; the
+            // pass ends once every buffer is empty or kMaxPassRecords is hit.
+            size_t round_drained;
+            do {
+                round_drained = 0;
+                for (auto& buffer : buffers) {
+                    for (size_t i = 0; i < kDrainQuantum; ++i) {
+                        auto consume = [&](const detail::RecordHeader& record) { write_record(record, *buffer); };
+                        if (!buffer->consume(consume)) {
+                            break;
+                        }
+                        ++round_drained;
+                    }
+                    if (out.size() >= batch_limit) {
+                        sink.appended(now);
+                        sink.write_out();
+                    }
+                }
+                drained += round_drained;
+            } while (round_drained != 0 && drained < kMaxPassRecords);
+
+            if (drained == 0) {
+                out.resize(mark);   // No records; drop the clock anchor
+            } else {
+                sink.appended(now);
+            }
+
+            const bool flush_requested = flush_requested_.exchange(false, std::memory_order_acq_rel);
+            if (flush_requested || stopping || sink.should_write(now)) {
+                sink.write_out();
+            }
+        }
+
+        // Drop buffers whose threads have exited once they are empty.
+        bool pruned = false;
+        for (const auto& buffer : buffers) {
+            if (buffer->retired.load(std::memory_order_acquire) && buffer->empty()) {
+                pruned = true;
+                break;
+            }
+        }
+        if (pruned) {
+            std::lock_guard<std::mutex> lock(registry_mutex_);
+            auto retired = [](const std::shared_ptr<detail::StagingBuffer>& buffer) {
+                return buffer->retired.load(std::memory_order_acquire) && buffer->empty();
+            };
+            buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(), retired), buffers_.end());
+            registry_version_.fetch_add(1, std::memory_order_release);
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            completed_passes_.fetch_add(1, std::memory_order_release);
+            flush_cv_.notify_all();
+
+            if (stopping && drained == 0) {
+                break;
+            }
+            if (drained == 0 && !wake_requested_) {
+                wake_cv_.wait_for(lock, kIdleInterval, [this] {
+                    return wake_requested_ || stop_requested_.load(std::memory_order_acquire);
+                });
+            }
+            wake_requested_ = false;
+        }
+    }
+}
+
+bool decode_binary_log(std::istream& in, std::ostream& out) {
+    char magic[sizeof(kBinaryMagic)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kBinaryMagic, sizeof(magic)) != 0) {
+        return false;
+    }
+
+    struct DecodedSite {
+        LogLevel level;
+        int line;
+        std::vector<LogArgType> types;
+        std::string file;
+        std::string format;
+    };
+
+    auto get = [&in](auto& value) {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    };
+    auto get_string = [&in, &get](std::string& str) {
+        uint32_t length;
+        if (!get(length)) return false;
+        str.resize(length);
+        return static_cast<bool>(in.read(str.data(), length));
+    };
+
+    std::unordered_map<uint32_t, DecodedSite> sites;
+    std::unordered_map<uint32_t, std::string> threads;
+    uint64_t anchor_tsc = 0;
+    uint64_t anchor_wall = 0;
+    double ns_per_tick = 1.0;
+    std::string payload;
+    std::string line;
+    TimestampCache timestamps;
+
+    uint8_t entry;
+    while (get(entry)) {
+        switch (entry) {
+            case kSiteEntry: {
+                uint32_t id;
+                uint8_t level;
+                int32_t site_line;
+                uint32_t arg_count;
+                DecodedSite site;
+                if (!get(id) || !get(level) || !get(site_line) || !get(arg_count)) return false;
+                site.types.resize(arg_count);
+                if (!in.read(reinterpret_cast<char*>(site.types.data()), arg_count)) return false;
+                if (!get_string(site.file) || !get_string(site.format)) return false;
+                site.level = static_cast<LogLevel>(level);
+                site.line = site_line;
+                sites[id] = std::move(site);
+                break;
+            }
+            case kThreadEntry: {
+                uint32_t id;
+                std::string label;
+                if (!get(id) || !get_string(label)) return false;
+                threads[id] = std::move(label);
+                break;
+            }
+            case kAnchorEntry:
+                if (!get(anchor_tsc) || !get(anchor_wall) || !get(ns_per_tick)) return false;
+                break;
+            case kRecordEntry: {
+                uint32_t site_id;
+                uint32_t thread_id;
+                uint64_t tsc;
+                uint32_t length;
+                if (!get(site_id) || !get(thread_id) || !get(tsc) || !get(length)) return false;
+                payload.resize(length);
+                if (!in.read(payload.data(), length)) return false;
+
+                const double delta = (static_cast<double>(tsc) - static_cast<double>(anchor_tsc)) * ns_per_tick;
+                const auto wall_ns = static_cast<uint64_t>(static_cast<double>(anchor_wall) + delta);
+                const std::string& thread_label = threads[thread_id];
+
+                line.clear();
+                const char* payload_end = payload.data() + length;
+                if (site_id == kRuntimeSiteId) {
+                    const LogSite& site = detail::kRuntimeLogSite;
+                    if (!payload_fits(site.arg_types, site.arg_count, payload.data(), payload_end)) {
+                        return false;
+                    }
+                    append_record(line, timestamps, site, wall_ns, thread_label, payload.data());
+                } else {
+                    auto it = sites.find(site_id);
+                    if (it == sites.end()) return false;
+                    const DecodedSite& site = it->second;
+                    if (!payload_fits(site.types.data(), static_cast<uint32_t>(site.types.size()),
+                                      payload.data(), payload_end)) {
+                        return false;
+                    }
+                    append_log_line(line, timestamps, site.level, wall_ns, thread_label, site.file, site.line,
+                                    site.format.c_str(), site.types.data(),
+                                    static_cast<uint32_t>(site.types.size()), payload.data());
+                }
+                out << line;
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+
+    return in.eof();
+}
+
+} // namespace hft::core
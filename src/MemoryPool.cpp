@@ -1,5 +1,143 @@
 #include "hft_core/MemoryPool.hpp"
+#include "hft_core/Topology.hpp"
 
-namespace hft::core {
+#include <cstring>
 
-} // namespace hft::core
\ No newline at end of file
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define HFT_POOL_HAS_MMAP 1
+#endif
+
+namespace hft::core::detail {
+
+namespace {
+
+size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+size_t page_size() {
+#ifdef HFT_POOL_HAS_MMAP
+    static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+#else
+    return 4096;
+#endif
+}
+
+void touch_pages(void* base, size_t bytes, size_t stride) {
+    auto* bytes_ptr = static_cast<volatile char*>(base);
+    for (size_t offset = 0; offset < bytes; offset += stride) {
+        bytes_ptr[offset] = 0;
+    }
+}
+
+#ifdef HFT_POOL_HAS_MMAP
+// Maps `bytes` (a multiple of kHugePageSize) aligned to a huge page so THP
+// can back it even when no MAP_HUGETLB pages are reserved.
+void* map_huge_region(size_t bytes, bool& explicit_huge) {
+#ifdef MAP_HUGETLB
+    void* base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (base != MAP_FAILED) {
+        explicit_huge = true;
+        return base;
+    }
+#endif
+    explicit_huge = false;
+
+    const size_t span = bytes + kHugePageSize;
+    void* raw = ::mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    const auto start = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t aligned = (start + kHugePageSize - 1) & ~(uintptr_t(kHugePageSize) - 1);
+    if (aligned > start) {
+        ::munmap(raw, aligned - start);
+    }
+    const uintptr_t end = start + span;
+    if (end > aligned + bytes) {
+        ::munmap(reinterpret_cast<void*>(aligned + bytes), end - (aligned + bytes));
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+#endif
+
+} // namespace
+
+void* allocate_pool_region(size_t& bytes, size_t alignment, const MemoryPoolOptions& options,
+                           PoolRegion& region) {
+    void* base = nullptr;
+    bool explicit_huge = false;
+
+#ifdef HFT_POOL_HAS_MMAP
+    if (options.huge_pages) {
+        bytes = round_up(bytes, kHugePageSize);
+        base = map_huge_region(bytes, explicit_huge);
+        if (!base) {
+            throw std::bad_alloc{};
+        }
+        region.mapped = true;
+        region.huge_pages = explicit_huge;
+#ifdef MADV_HUGEPAGE
+        if (!explicit_huge) {
+            region.huge_pages = ::madvise(base, bytes, MADV_HUGEPAGE) == 0;
+        }
+#endif
+    }
+
+    // mbind() works on whole pages, so node-bound regions are mapped too.
+    if (!base && options.numa_node >= 0 && alignment <= page_size()) {
+        bytes = round_up(bytes, page_size());
+        base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            throw std::bad_alloc{};
+        }
+        region.mapped = true;
+    }
+
+    // Bind before the first touch so the pages are faulted in on the node.
+    if (region.mapped && options.numa_node >= 0) {
+        region.numa_bound = bind_memory_to_node(base, bytes, options.numa_node);
+    }
+#endif
+
+    if (!base) {
+        bytes = round_up(bytes, alignment);
+        base = std::aligned_alloc(alignment, bytes);
+        if (!base) {
+            throw std::bad_alloc{};
+        }
+    }
+
+    if (options.prefault) {
+        touch_pages(base, bytes, explicit_huge ? kHugePageSize : page_size());
+    }
+
+#ifdef HFT_POOL_HAS_MMAP
+    if (options.lock_memory) {
+        region.locked = ::mlock(base, bytes) == 0;
+    }
+#endif
+
+    region.base = base;
+    region.bytes = bytes;
+    return base;
+}
+
+void release_pool_region(const PoolRegion& region) noexcept {
+#ifdef HFT_POOL_HAS_MMAP
+    if (region.locked) {
+        ::munlock(region.base, region.bytes);
+    }
+    if (region.mapped) {
+        ::munmap(region.base, region.bytes);
+        return;
+    }
+#endif
+    std::free(region.base);
+}
+
+} // namespace hft::core::detail
@@ -0,0 +1,82 @@
+#include "hft_core/SlabAllocator.hpp"
+
+namespace hft::core {
+
+namespace {
+
+constexpr size_t kRegionHeaderSize =
+    (sizeof(detail::PoolRegion) + SlabAllocator::kMaxAlignment - 1) /
+    SlabAllocator::kMaxAlignment * SlabAllocator::kMaxAlignment;
+
+} // namespace
+
+SlabAllocator::SlabAllocator(const SlabAllocatorOptions& options, std::pmr::memory_resource* upstream)
+    : options_(options), upstream_(upstream) {
+    for (size_t i = 0; i < kClassCount; ++i) {
+        classes_[i].stats.block_size = kMinBlockSize << i;
+    }
+}
+
+SlabAllocator::~SlabAllocator() {
+    while (regions_) {
+        detail::PoolRegion* region = regions_;
+        regions_ = region->next;
+        const detail::PoolRegion copy = *region;
+        region->~PoolRegion();
+        detail::release_pool_region(copy);
+    }
+}
+
+void SlabAllocator::reserve(size_t bytes, size_t count) {
+    const size_t index = class_index(bytes, 1);
+    if (index == kClassCount || count == 0) {
+        return;
+    }
+
+    size_t free_blocks = 0;
+    for (FreeBlock* block = classes_[index].free_list; block; block = block->next) {
+        ++free_blocks;
+    }
+    if (free_blocks < count) {
+        refill(index, count - free_blocks);
+    }
+}
+
+// Same layout as MemoryPool: a PoolRegion header, then blocks linked in
+// address order onto the front of the class's free list.
+void SlabAllocator::refill(size_t index, size_t min_blocks) {
+    SizeClass& size_class = classes_[index];
+    const size_t block_size = size_class.stats.block_size;
+
+    size_t bytes = kRegionHeaderSize + block_size * min_blocks;
+    if (bytes < options_.region_size) {
+        bytes = options_.region_size;
+    }
+
+    detail::PoolRegion info;
+    void* memory = detail::allocate_pool_region(bytes, kMaxAlignment, options_.memory, info);
+    auto* region = new (memory) detail::PoolRegion(info);
+    region->next = regions_;
+    regions_ = region;
+
+    char* blocks = static_cast<char*>(memory) + kRegionHeaderSize;
+    const size_t count = (bytes - kRegionHeaderSize) / block_size;
+    for (size_t i = 0; i + 1 < count; ++i) {
+        reinterpret_cast<FreeBlock*>(blocks + i * block_size)->next =
+            reinterpret_cast<FreeBlock*>(blocks + (i + 1) * block_size);
+    }
+    reinterpret_cast<FreeBlock*>(blocks + (count - 1) * block_size)->next = size_class.free_list;
+    size_class.free_list = reinterpret_cast<FreeBlock*>(blocks);
+    size_class.stats.capacity += count;
+}
+
+std::vector<SlabClassStats> SlabAllocator::stats() const {
+    std::vector<SlabClassStats> result;
+    result.reserve(kClassCount);
+    for (const auto& size_class : classes_) {
+        result.push_back(size_class.stats);
+    }
+    return result;
+}
+
+} // namespace hft::core
@@ -1,38 +1,225 @@
 #include "hft_core/Timer.hpp"
-#include <fstream>
+
+#include <algorithm>
+#include <mutex>
 #include <thread>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <cpuid.h>
+#endif
 
 namespace hft::core {
 
-double Timer::get_tsc_frequency() noexcept {
-    // Try to read from /proc/cpuinfo first (Linux)
-    std::ifstream cpuinfo("/proc/cpuinfo");
-    if (cpuinfo.is_open()) {
-        std::string line;
-        while (std::getline(cpuinfo, line)) {
-            if (line.find("cpu MHz") != std::string::npos) {
-                size_t pos = line.find(':');
-                if (pos != std::string::npos) {
-                    double mhz = std::stod(line.substr(pos + 1));
-                    return mhz * 1e6; // Convert MHz to Hz
+namespace detail {
+
+TscClockState tsc_clock;
+
+namespace {
+
+constexpr uint32_t kShift = 32;
+constexpr uint64_t kReanchorNs = 1000000000;     // Re-anchor the epoch clock every second
+constexpr int kCalibrationRounds = 3;
+constexpr auto kCalibrationWindow = std::chrono::milliseconds(10);
+
+struct CalibrationState {
+    std::once_flag once;
+    std::mutex mutex;
+    TscCalibration calibration;
+    uint64_t base_tsc = 0;          // First (tsc, raw ns) pair, for refining the frequency
+    uint64_t base_raw_ns = 0;
+};
+
+CalibrationState& state() {
+    static CalibrationState instance;
+    return instance;
+}
+
+uint64_t clock_ns(clockid_t clock) noexcept {
+    timespec ts;
+    ::clock_gettime(clock, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+uint64_t raw_clock_ns() noexcept {
+#ifdef CLOCK_MONOTONIC_RAW
+    return clock_ns(CLOCK_MONOTONIC_RAW);
+#else
+    return clock_ns(CLOCK_MONOTONIC);
+#endif
+}
+
+// (tsc, clock) pair from the tightest of a few bracketed reads.
+template<typename Clock>
+void sample(Clock clock, uint64_t& tsc, uint64_t& ns) noexcept {
+    tsc = 0;
+    ns = 0;
+    uint64_t best = ~uint64_t(0);
+    for (int i = 0; i < 5; ++i) {
+        const uint64_t before = Timer::rdtsc_ordered();
+        const uint64_t now = clock();
+        const uint64_t after = Timer::rdtsc_ordered();
+        if (after - before < best) {
+            best = after - before;
+            tsc = before + (after - before) / 2;
+            ns = now;
+        }
+    }
+}
+
+bool cpuid_invariant_tsc() noexcept {
+#if defined(__x86_64__) || defined(_M_X64)
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007) {
+        return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+// TSC rate from CPUID leaf 0x15 (crystal clock times the TSC/crystal ratio).
+// Many CPUs and hypervisors leave the crystal frequency at 0; leaf 0x16 only
+// gives a rounded base MHz, so those fall back to measuring.
+uint64_t cpuid_tsc_frequency() noexcept {
+#if defined(__x86_64__) || defined(_M_X64)
+    unsigned eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0, nullptr) < 0x15) {
+        return 0;
+    }
+    __cpuid(0x15, eax, ebx, ecx, edx);
+    if (eax == 0 || ebx == 0 || ecx == 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(ecx) * ebx / eax;
+#else
+    return 0;
+#endif
+}
+
+uint64_t measure_tsc_frequency() {
+    uint64_t rates[kCalibrationRounds];
+    for (int round = 0; round < kCalibrationRounds; ++round) {
+        uint64_t tsc0, ns0, tsc1, ns1;
+        sample(raw_clock_ns, tsc0, ns0);
+        std::this_thread::sleep_for(kCalibrationWindow);
+        sample(raw_clock_ns, tsc1, ns1);
+        rates[round] = ns1 > ns0
+            ? static_cast<uint64_t>(static_cast<unsigned __int128>(tsc1 - tsc0) * 1000000000ull / (ns1 - ns0))
+            : 0;
+    }
+    std::sort(rates, rates + kCalibrationRounds);
+    return rates[kCalibrationRounds / 2];
+}
+
+void publish_frequency(uint64_t frequency_hz) noexcept {
+    const uint64_t mult = static_cast<uint64_t>((static_cast<unsigned __int128>(1000000000ull) << kShift) /
+                                                frequency_hz);
+    tsc_clock.shift.store(kShift, std::memory_order_relaxed);
+    tsc_clock.reanchor_ticks.store(static_cast<uint64_t>(
+        static_cast<unsigned __int128>(kReanchorNs) * frequency_hz / 1000000000ull), std::memory_order_relaxed);
+    tsc_clock.mult.store(mult, std::memory_order_release);
+}
+
+void store_anchor(uint64_t tsc, uint64_t epoch_ns) noexcept {
+    const uint32_t sequence = tsc_clock.sequence.load(std::memory_order_relaxed);
+    tsc_clock.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    tsc_clock.anchor_tsc.store(tsc, std::memory_order_relaxed);
+    tsc_clock.anchor_epoch_ns.store(epoch_ns, std::memory_order_relaxed);
+    tsc_clock.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void calibrate() {
+    CalibrationState& s = state();
+    TscCalibration calibration;
+    calibration.invariant = cpuid_invariant_tsc();
+
+#if defined(__x86_64__) || defined(_M_X64)
+    calibration.frequency_hz = cpuid_tsc_frequency();
+    calibration.source = TscSource::Cpuid;
+    if (calibration.frequency_hz == 0) {
+        calibration.frequency_hz = measure_tsc_frequency();
+        calibration.source = TscSource::Calibrated;
+    }
+#else
+    calibration.frequency_hz = 1000000000ull;
+    calibration.source = TscSource::Clock;
+#endif
+    if (calibration.frequency_hz == 0) {
+        calibration.frequency_hz = 1000000000ull;
+    }
+
+    sample(raw_clock_ns, s.base_tsc, s.base_raw_ns);
+    uint64_t tsc, epoch_ns;
+    sample([] { return clock_ns(CLOCK_REALTIME); }, tsc, epoch_ns);
+    store_anchor(tsc, epoch_ns);
+
+    publish_frequency(calibration.frequency_hz);
+    calibration.mult = tsc_clock.mult.load(std::memory_order_relaxed);
+    calibration.shift = kShift;
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.calibration = calibration;
+}
+
+// Calibrate while the process starts instead of on the first timed call.
+[[maybe_unused]] const uint64_t startup_calibration = ensure_tsc_calibrated();
+
+} // namespace
+
+uint64_t ensure_tsc_calibrated() noexcept {
+    std::call_once(state().once, calibrate);
+    return tsc_clock.mult.load(std::memory_order_acquire);
+}
+
+void reanchor_tsc_clock(uint64_t /*tsc*/) noexcept {
+    if (tsc_clock.reanchoring.exchange(true, std::memory_order_acquire)) {
+        return;     // Another thread is on it
+    }
+
+    CalibrationState& s = state();
+    uint64_t tsc, epoch_ns;
+    sample([] { return clock_ns(CLOCK_REALTIME); }, tsc, epoch_ns);
+
+    {
+        // A measured rate is refined over the whole time since startup,
+        // which averages out the error of the short initial windows.
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (s.calibration.source == TscSource::Calibrated) {
+            uint64_t raw_tsc, raw_ns;
+            sample(raw_clock_ns, raw_tsc, raw_ns);
+            if (raw_ns - s.base_raw_ns >= kReanchorNs && raw_tsc > s.base_tsc) {
+                const auto frequency = static_cast<uint64_t>(
+                    static_cast<unsigned __int128>(raw_tsc - s.base_tsc) * 1000000000ull /
+                    (raw_ns - s.base_raw_ns));
+                if (frequency != 0) {
+                    publish_frequency(frequency);
+                    s.calibration.frequency_hz = frequency;
+                    s.calibration.mult = tsc_clock.mult.load(std::memory_order_relaxed);
                 }
             }
         }
     }
 
-    // Fallback: calibrate TSC frequency
-    auto start_time = std::chrono::high_resolution_clock::now();
-    uint64_t start_tsc = rdtsc();
-    
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    
-    auto end_time = std::chrono::high_resolution_clock::now();
-    uint64_t end_tsc = rdtsc();
-    
-    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        end_time - start_time).count();
-    
-    return static_cast<double>(end_tsc - start_tsc) / duration;
+    store_anchor(tsc, epoch_ns);
+    tsc_clock.reanchoring.store(false, std::memory_order_release);
+}
+
+} // namespace detail
+
+void Timer::reanchor() noexcept {
+    detail::ensure_tsc_calibrated();
+    detail::reanchor_tsc_clock(rdtsc());
+}
+
+TscCalibration Timer::tsc_calibration() noexcept {
+    detail::ensure_tsc_calibrated();
+    auto& s = detail::state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.calibration;
 }
 
-} // namespace hft::core
\ No newline at end of file
+} // namespace hft::core
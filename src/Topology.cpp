@@ -0,0 +1,265 @@
+#include "hft_core/Topology.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace hft::core {
+
+namespace {
+
+bool read_line(const std::string& path, std::string& line) {
+    std::ifstream file(path);
+    return static_cast<bool>(std::getline(file, line));
+}
+
+int read_int(const std::string& path, int fallback) {
+    std::string line;
+    if (!read_line(path, line)) {
+        return fallback;
+    }
+    try {
+        return std::stoi(line);
+    } catch (...) {
+        return fallback;
+    }
+}
+
+#ifdef __linux__
+constexpr int kMpolPreferred = 1;
+constexpr int kMpolBind = 2;
+constexpr unsigned long kMaxNodes = 1024;
+#endif
+
+} // namespace
+
+std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    size_t pos = 0;
+    while (pos < list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        const std::string range = list.substr(pos, end - pos);
+        pos = end + 1;
+
+        try {
+            const size_t dash = range.find('-');
+            if (dash == std::string::npos) {
+                if (range.find_first_of("0123456789") != std::string::npos) {
+                    cpus.push_back(std::stoi(range));
+                }
+                continue;
+            }
+            const int first = std::stoi(range.substr(0, dash));
+            const int last = std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (...) {
+            // Skip malformed entries
+        }
+    }
+    return cpus;
+}
+
+const CpuTopology& CpuTopology::system() {
+    static const CpuTopology topology = detect();
+    return topology;
+}
+
+CpuTopology CpuTopology::detect(const std::string& sysfs_root) {
+    CpuTopology topology;
+
+    std::string line;
+    std::vector<int> online;
+    if (read_line(sysfs_root + "/cpu/online", line)) {
+        online = parse_cpu_list(line);
+    }
+    if (online.empty()) {
+        const unsigned count = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned cpu = 0; cpu < count; ++cpu) {
+            topology.cpus_.push_back(CpuInfo{static_cast<int>(cpu), 0, static_cast<int>(cpu), 0, true});
+        }
+        topology.count_groups();
+        return topology;
+    }
+
+    for (int cpu : online) {
+        const std::string dir = sysfs_root + "/cpu/cpu" + std::to_string(cpu) + "/topology/";
+        CpuInfo info;
+        info.cpu = cpu;
+        info.socket = std::max(0, read_int(dir + "physical_package_id", 0));
+        info.core = read_int(dir + "core_id", cpu);
+        if (read_line(dir + "thread_siblings_list", line)) {
+            const std::vector<int> siblings = parse_cpu_list(line);
+            info.primary = siblings.empty() || *std::min_element(siblings.begin(), siblings.end()) == cpu;
+        }
+        topology.cpus_.push_back(info);
+    }
+
+    if (read_line(sysfs_root + "/node/online", line)) {
+        for (int node : parse_cpu_list(line)) {
+            std::string cpulist;
+            if (!read_line(sysfs_root + "/node/node" + std::to_string(node) + "/cpulist", cpulist)) {
+                continue;
+            }
+            for (int cpu : parse_cpu_list(cpulist)) {
+                for (auto& info : topology.cpus_) {
+                    if (info.cpu == cpu) {
+                        info.numa_node = node;
+                    }
+                }
+            }
+        }
+    }
+    topology.count_groups();
+    return topology;
+}
+
+void CpuTopology::count_groups() {
+    std::set<int> sockets;
+    std::set<int> nodes;
+    std::set<std::pair<int, int>> cores;
+    for (const auto& info : cpus_) {
+        sockets.insert(info.socket);
+        nodes.insert(info.numa_node);
+        cores.emplace(info.socket, info.core);
+    }
+    socket_count_ = sockets.size();
+    numa_node_count_ = nodes.size();
+    physical_core_count_ = cores.size();
+}
+
+int CpuTopology::numa_node_of(int cpu) const noexcept {
+    for (const auto& info : cpus_) {
+        if (info.cpu == cpu) {
+            return info.numa_node;
+        }
+    }
+    return -1;
+}
+
+std::vector<int> CpuTopology::select(const PlacementPolicy& policy) const {
+    std::vector<CpuInfo> chosen;
+    for (const auto& info : cpus_) {
+        if (policy.numa_node >= 0 && info.numa_node != policy.numa_node) {
+            continue;
+        }
+        if (policy.skip_smt_siblings && !info.primary) {
+            continue;
+        }
+        chosen.push_back(info);
+    }
+
+    std::stable_sort(chosen.begin(), chosen.end(), [](const CpuInfo& a, const CpuInfo& b) {
+        if (a.primary != b.primary) return a.primary;
+        if (a.numa_node != b.numa_node) return a.numa_node < b.numa_node;
+        if (a.socket != b.socket) return a.socket < b.socket;
+        if (a.core != b.core) return a.core < b.core;
+        return a.cpu < b.cpu;
+    });
+
+    std::vector<int> result;
+    result.reserve(chosen.size());
+    for (const auto& info : chosen) {
+        result.push_back(info.cpu);
+    }
+    return result;
+}
+
+std::vector<int> select_worker_cpus(const PlacementPolicy& placement, size_t threads) {
+    const std::vector<int> selected = CpuTopology::system().select(placement);
+    if (selected.empty()) {
+        throw std::invalid_argument("placement policy matches no CPU");
+    }
+    if (threads == 0) {
+        return selected;
+    }
+
+    std::vector<int> cpus;
+    cpus.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        cpus.push_back(selected[i % selected.size()]);
+    }
+    return cpus;
+}
+
+void place_current_thread(int cpu, bool bind_memory) noexcept {
+    pin_current_thread(cpu);
+    if (bind_memory) {
+        const CpuTopology& topology = CpuTopology::system();
+        const int node = topology.numa_node_of(cpu);
+        if (node >= 0 && topology.numa_node_count() > 1) {
+            prefer_numa_node(node);
+        }
+    }
+}
+
+int current_numa_node() noexcept {
+#ifdef __linux__
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return static_cast<int>(node);
+    }
+#endif
+    return 0;
+}
+
+bool pin_current_thread(int cpu) noexcept {
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+bool prefer_numa_node(int node) noexcept {
+#ifdef __linux__
+    if (node < 0 || static_cast<unsigned long>(node) >= kMaxNodes) {
+        return false;
+    }
+    unsigned long mask[kMaxNodes / (8 * sizeof(unsigned long))] = {};
+    mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+    return ::syscall(SYS_set_mempolicy, kMpolPreferred, mask, kMaxNodes) == 0;
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+bool bind_memory_to_node(void* addr, size_t bytes, int node) noexcept {
+#ifdef __linux__
+    if (node < 0 || static_cast<unsigned long>(node) >= kMaxNodes) {
+        return false;
+    }
+    unsigned long mask[kMaxNodes / (8 * sizeof(unsigned long))] = {};
+    mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+    return ::syscall(SYS_mbind, addr, bytes, kMpolBind, mask, kMaxNodes, 0) == 0;
+#else
+    (void)addr;
+    (void)bytes;
+    (void)node;
+    return false;
+#endif
+}
+
+} // namespace hft::core
@@ -0,0 +1,444 @@
+#include "hft_core/Trace.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace hft::core {
+
+namespace {
+
+using detail::TraceRingHeader;
+using detail::TraceSegmentHeader;
+
+constexpr size_t align_line(size_t bytes) noexcept {
+    return (bytes + kCacheLineSize - 1) & ~(kCacheLineSize - 1);
+}
+
+constexpr size_t kRingsOffset = align_line(sizeof(TraceSegmentHeader));
+
+size_t ring_stride(size_t capacity) noexcept {
+    return align_line(sizeof(TraceRingHeader) + capacity * sizeof(TraceRecord));
+}
+
+const TraceRingHeader* ring_at(const TraceSegmentHeader* header, size_t index) noexcept {
+    return reinterpret_cast<const TraceRingHeader*>(
+        reinterpret_cast<const char*>(header) + kRingsOffset + index * header->ring_stride);
+}
+
+TraceRingHeader* ring_at(TraceSegmentHeader* header, size_t index) noexcept {
+    return const_cast<TraceRingHeader*>(ring_at(static_cast<const TraceSegmentHeader*>(header), index));
+}
+
+const TraceRecord* records_of(const TraceRingHeader* ring) noexcept {
+    return reinterpret_cast<const TraceRecord*>(ring + 1);
+}
+
+// Which traced operation a probe belongs to, for stitching timelines.
+enum class TraceKind { None, Event, Task };
+
+TraceKind span_of(uint32_t probe) noexcept {
+    switch (static_cast<TraceProbe>(probe)) {
+        case TraceProbe::EventPublish:
+        case TraceProbe::EventHandlerBegin:
+        case TraceProbe::EventHandlerEnd:
+            return TraceKind::Event;
+        case TraceProbe::TaskEnqueue:
+        case TraceProbe::TaskBegin:
+        case TraceProbe::TaskEnd:
+            return TraceKind::Task;
+        default:
+            return TraceKind::None;
+    }
+}
+
+bool starts_span(uint32_t probe) noexcept {
+    return probe == static_cast<uint32_t>(TraceProbe::EventPublish) ||
+           probe == static_cast<uint32_t>(TraceProbe::TaskEnqueue);
+}
+
+std::string probe_label(uint32_t probe) {
+    const char* name = trace_probe_name(probe);
+    return name ? name : "probe_" + std::to_string(probe);
+}
+
+// Flow ids are strings so 64-bit payloads survive JSON number parsing.
+std::string flow_id(TraceKind span, uint64_t id) {
+    return (span == TraceKind::Event ? "e" : "t") + std::to_string(id);
+}
+
+std::string json_escape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+struct Mapping {
+    ~Mapping() {
+#ifdef __linux__
+        if (data) {
+            ::munmap(data, size);
+        }
+#endif
+    }
+
+    void* data = nullptr;
+    size_t size = 0;
+};
+
+} // namespace
+
+const char* trace_probe_name(uint32_t probe) noexcept {
+    switch (static_cast<TraceProbe>(probe)) {
+        case TraceProbe::EventPublish:      return "publish";
+        case TraceProbe::EventHandlerBegin: return "handler_begin";
+        case TraceProbe::EventHandlerEnd:   return "handler_end";
+        case TraceProbe::TaskEnqueue:       return "task_enqueue";
+        case TraceProbe::TaskBegin:         return "task_begin";
+        case TraceProbe::TaskEnd:           return "task_end";
+        case TraceProbe::LogEnqueue:        return "log_enqueue";
+        default:                            return nullptr;
+    }
+}
+
+namespace detail {
+
+void attach_trace_ring(TraceThreadSlot& slot) noexcept {
+    Tracer& tracer = Tracer::instance();
+    std::lock_guard<std::mutex> lock(tracer.mutex_);
+
+    slot = TraceThreadSlot{};
+    slot.generation = trace_generation.load(std::memory_order_acquire);
+    TraceSegmentHeader* header = tracer.segment_;
+    if (slot.generation == 0 || !header) {
+        return;
+    }
+
+    const uint32_t index = header->rings_claimed.load(std::memory_order_relaxed);
+    if (index >= header->ring_count) {
+        header->threads_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    TraceRingHeader* ring = ring_at(header, index);
+#ifdef __linux__
+    ring->tid = static_cast<uint32_t>(::syscall(SYS_gettid));
+    ::pthread_getname_np(::pthread_self(), ring->thread_name, sizeof(ring->thread_name));
+#endif
+    header->rings_claimed.store(index + 1, std::memory_order_release);
+
+    slot.ring = ring;
+    slot.records = reinterpret_cast<TraceRecord*>(ring + 1);
+    slot.mask = header->ring_capacity - 1;
+    slot.head = ring->head.load(std::memory_order_relaxed);
+}
+
+} // namespace detail
+
+void Tracer::start(const TraceOptions& options) {
+#ifdef __linux__
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (detail::trace_generation.load(std::memory_order_relaxed) != 0) {
+        throw std::logic_error("tracer already started");
+    }
+
+    const std::string name = options.name.empty()
+        ? "/hft_trace." + std::to_string(::getpid()) : options.name;
+    const size_t rings = std::max<size_t>(1, options.max_threads);
+    const size_t capacity = round_up_pow2(std::max<size_t>(2, options.ring_capacity));
+    const size_t stride = ring_stride(capacity);
+    const size_t size = kRingsOffset + rings * stride;
+
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+    }
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        const int error = errno;
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        throw std::system_error(error, std::generic_category(), "ftruncate " + name);
+    }
+    void* memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const int error = errno;
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        throw std::system_error(error, std::generic_category(), "mmap " + name);
+    }
+
+    auto* header = new (memory) TraceSegmentHeader{};
+    header->version = detail::kTraceVersion;
+    header->ring_count = static_cast<uint32_t>(rings);
+    header->ring_capacity = capacity;
+    header->ring_stride = stride;
+    header->tsc_frequency_hz = Timer::tsc_frequency();
+    header->anchor_tsc = Timer::rdtsc();
+    header->anchor_epoch_ns = Timer::tsc_to_epoch_ns(header->anchor_tsc);
+    header->pid = static_cast<int32_t>(::getpid());
+    for (size_t i = 0; i < rings; ++i) {
+        new (ring_at(header, i)) TraceRingHeader{};
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = detail::kTraceMagic;
+
+    name_ = name;
+    segment_ = header;
+    detail::trace_generation.store(++sessions_, std::memory_order_release);
+#else
+    (void)options;
+    throw std::system_error(std::make_error_code(std::errc::function_not_supported), "tracing");
+#endif
+}
+
+void Tracer::stop(bool unlink) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    detail::trace_generation.store(0, std::memory_order_release);
+    ++sessions_;
+    segment_ = nullptr;
+#ifdef __linux__
+    if (unlink && !name_.empty()) {
+        ::shm_unlink(name_.c_str());
+    }
+#else
+    (void)unlink;
+#endif
+}
+
+std::string Tracer::segment_name() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return name_;
+}
+
+uint64_t TraceCapture::to_epoch_ns(uint64_t tsc) const noexcept {
+    if (tsc_frequency_hz == 0) {
+        return anchor_epoch_ns;
+    }
+    const auto delta = static_cast<__int128>(tsc) - static_cast<__int128>(anchor_tsc);
+    return static_cast<uint64_t>(static_cast<__int128>(anchor_epoch_ns) +
+                                 delta * 1000000000 / static_cast<__int128>(tsc_frequency_hz));
+}
+
+TraceCapture read_trace(const std::string& segment) {
+#ifdef __linux__
+    const bool shm_name = segment.size() > 1 && segment[0] == '/' &&
+                          segment.find('/', 1) == std::string::npos;
+    const int fd = shm_name ? ::shm_open(segment.c_str(), O_RDONLY, 0)
+                            : ::open(segment.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open trace segment " + segment + ": " + std::strerror(errno));
+    }
+
+    struct stat info {};
+    Mapping mapping;
+    if (::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(TraceSegmentHeader)) {
+        mapping.size = static_cast<size_t>(info.st_size);
+        mapping.data = ::mmap(nullptr, mapping.size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping.data == MAP_FAILED) {
+            mapping.data = nullptr;
+        }
+    }
+    ::close(fd);
+
+    const auto* header = static_cast<const TraceSegmentHeader*>(mapping.data);
+    if (!header || header->magic != detail::kTraceMagic || header->version != detail::kTraceVersion ||
+        header->ring_capacity == 0 || (header->ring_capacity & (header->ring_capacity - 1)) != 0 ||
+        header->ring_stride < ring_stride(header->ring_capacity) ||
+        kRingsOffset + header->ring_count * header->ring_stride > mapping.size) {
+        throw std::runtime_error("not a trace segment: " + segment);
+    }
+
+    TraceCapture capture;
+    capture.pid = header->pid;
+    capture.tsc_frequency_hz = header->tsc_frequency_hz;
+    capture.anchor_tsc = header->anchor_tsc;
+    capture.anchor_epoch_ns = header->anchor_epoch_ns;
+    capture.threads_dropped = header->threads_dropped.load(std::memory_order_relaxed);
+
+    const uint64_t capacity = header->ring_capacity;
+    const uint32_t rings = std::min(header->rings_claimed.load(std::memory_order_acquire),
+                                    header->ring_count);
+    for (uint32_t i = 0; i < rings; ++i) {
+        const TraceRingHeader* ring = ring_at(header, i);
+        const TraceRecord* records = records_of(ring);
+
+        TraceThread thread;
+        thread.tid = ring->tid;
+        thread.name.assign(ring->thread_name, strnlen(ring->thread_name, sizeof(ring->thread_name)));
+
+        // The slot after the head may be mid-write, so at most capacity - 1
+        // records are readable.
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t first = head >= capacity ? head - capacity + 1 : 0;
+        thread.records.reserve(static_cast<size_t>(head - first));
+        for (uint64_t index = first; index < head; ++index) {
+            thread.records.push_back(records[index & (capacity - 1)]);
+        }
+
+        // Drop whatever the writer may have overwritten while we copied;
+        // the slot of `now` itself could be mid-write.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t now = ring->head.load(std::memory_order_relaxed);
+        const uint64_t valid = now >= capacity ? now - capacity + 1 : 0;
+        if (valid > first) {
+            const uint64_t stale = std::min(valid, head) - first;
+            thread.records.erase(thread.records.begin(),
+                                 thread.records.begin() + static_cast<std::ptrdiff_t>(stale));
+            first += stale;
+        }
+        thread.lost = first;
+        capture.threads.push_back(std::move(thread));
+    }
+    return capture;
+#else
+    throw std::runtime_error("cannot open trace segment " + segment + ": unsupported platform");
+#endif
+}
+
+void write_chrome_trace(const TraceCapture& capture, std::ostream& out) {
+    uint64_t base = ~uint64_t(0);
+    for (const auto& thread : capture.threads) {
+        if (!thread.records.empty()) {
+            base = std::min(base, thread.records.front().tsc);
+        }
+    }
+    const double ns_per_tick = capture.tsc_frequency_hz
+        ? 1e9 / static_cast<double>(capture.tsc_frequency_hz) : 1.0;
+    auto micros = [&](uint64_t tsc) {
+        return static_cast<double>(tsc - base) * ns_per_tick / 1000.0;
+    };
+
+    const std::string pid = std::to_string(capture.pid);
+    bool first = true;
+    auto event = [&](const std::string& body) {
+        out << (first ? "\n" : ",\n") << "{" << body << "}";
+        first = false;
+    };
+
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    out.setf(std::ios::fixed);
+    out.precision(3);
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for (const auto& thread : capture.threads) {
+        const std::string tid = std::to_string(thread.tid);
+        const std::string where = "\"pid\":" + pid + ",\"tid\":" + tid;
+        event("\"name\":\"thread_name\",\"ph\":\"M\"," + where + ",\"args\":{\"name\":\"" +
+              json_escape(thread.name.empty() ? "thread " + tid : thread.name) + "\"}");
+
+        for (const TraceRecord& record : thread.records) {
+            std::ostringstream ts;
+            ts.setf(std::ios::fixed);
+            ts.precision(3);
+            ts << micros(record.tsc);
+            const std::string at = where + ",\"ts\":" + ts.str();
+            const std::string payload = std::to_string(record.payload);
+            const TraceKind span = span_of(record.probe);
+            const char* category = span == TraceKind::Event ? "event" : span == TraceKind::Task ? "task" : "probe";
+
+            switch (static_cast<TraceProbe>(record.probe)) {
+                case TraceProbe::EventHandlerBegin:
+                case TraceProbe::TaskBegin:
+                    event(std::string("\"name\":\"") + (span == TraceKind::Event ? "handler" : "task") +
+                          "\",\"cat\":\"" + category + "\",\"ph\":\"B\"," + at +
+                          ",\"args\":{\"id\":\"" + payload + "\"}");
+                    event(std::string("\"name\":\"") + category + "\",\"cat\":\"" + category +
+                          "\",\"ph\":\"f\",\"bp\":\"e\",\"id\":\"" + flow_id(span, record.payload) +
+                          "\"," + at);
+                    break;
+                case TraceProbe::EventHandlerEnd:
+                case TraceProbe::TaskEnd:
+                    event("\"ph\":\"E\"," + at);
+                    break;
+                default:
+                    event("\"name\":\"" + json_escape(probe_label(record.probe)) + "\",\"cat\":\"" +
+                          category + "\",\"ph\":\"X\",\"dur\":0," + at +
+                          ",\"args\":{\"payload\":\"" + payload + "\"}");
+                    if (starts_span(record.probe)) {
+                        event(std::string("\"name\":\"") + category + "\",\"cat\":\"" + category +
+                              "\",\"ph\":\"s\",\"id\":\"" + flow_id(span, record.payload) + "\"," + at);
+                    }
+                    break;
+            }
+        }
+    }
+    out << "\n]}\n";
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void write_trace_timelines(const TraceCapture& capture, std::ostream& out) {
+    struct Point {
+        uint64_t tsc;
+        uint32_t probe;
+        uint32_t tid;
+        uint64_t id;
+    };
+
+    std::vector<Point> points;
+    for (const auto& thread : capture.threads) {
+        for (const TraceRecord& record : thread.records) {
+            if (span_of(record.probe) != TraceKind::None) {
+                points.push_back({record.tsc, record.probe, thread.tid, record.payload});
+            }
+        }
+    }
+    std::stable_sort(points.begin(), points.end(),
+                     [](const Point& a, const Point& b) { return a.tsc < b.tsc; });
+
+    // Ids can be reused (task nodes are recycled), so a publish or enqueue
+    // always opens a new timeline for its id.
+    std::vector<std::vector<Point>> timelines;
+    std::map<std::pair<int, uint64_t>, size_t> open;
+    for (const Point& point : points) {
+        const auto key = std::make_pair(static_cast<int>(span_of(point.probe)), point.id);
+        auto it = open.find(key);
+        if (it == open.end() || starts_span(point.probe)) {
+            open[key] = timelines.size();
+            timelines.emplace_back();
+            it = open.find(key);
+        }
+        timelines[it->second].push_back(point);
+    }
+
+    const double ns_per_tick = capture.tsc_frequency_hz
+        ? 1e9 / static_cast<double>(capture.tsc_frequency_hz) : 1.0;
+    for (const auto& timeline : timelines) {
+        const Point& head = timeline.front();
+        out << (span_of(head.probe) == TraceKind::Event ? "event " : "task ") << head.id;
+        for (const Point& point : timeline) {
+            out << "  " << probe_label(point.probe) << "@" << point.tid << " +"
+                << static_cast<uint64_t>(static_cast<double>(point.tsc - head.tsc) * ns_per_tick) << "ns";
+        }
+        out << "\n";
+    }
+}
+
+} // namespace hft::core
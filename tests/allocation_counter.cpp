@@ -0,0 +1,24 @@
+#include "allocation_counter.hpp"
+#include <cstdlib>
+#include <new>
+
+std::atomic<bool> g_count_allocations{false};
+std::atomic<size_t> g_allocations{0};
+
+void* operator new(size_t size) {
+    if (g_count_allocations.load(std::memory_order_relaxed)) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
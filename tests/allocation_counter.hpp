@@ -0,0 +1,10 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Global operator new/delete replacements live in allocation_counter.cpp so
+// no test translation unit sees both a replaced new and its delete inline.
+// While g_count_allocations is set, every operator new bumps g_allocations.
+extern std::atomic<bool> g_count_allocations;
+extern std::atomic<size_t> g_allocations;
@@ -2,6 +2,8 @@
 #include "hft_core/Config.hpp"
 #include <fstream>
 #include <filesystem>
+#include <atomic>
+#include <thread>
 
 using namespace hft::core;
 
@@ -88,4 +90,215 @@ TEST_F(ConfigTest, RemoveKey) {
     EXPECT_TRUE(config.has("string_value"));
     config.remove("string_value");
     EXPECT_FALSE(config.has("string_value"));
-}
\ No newline at end of file
+}
+
+TEST_F(ConfigTest, HandleReadsCurrentValue) {
+    auto& config = Config::instance();
+    config.load_from_file(test_file_);
+
+    auto threshold = config.handle<int>("int_value", -1);
+    EXPECT_EQ(threshold.get(), 42);
+
+    config.set("int_value", 7);
+    EXPECT_EQ(*threshold, 7);
+
+    config.remove("int_value");
+    EXPECT_EQ(threshold.get(), -1);
+}
+
+TEST_F(ConfigTest, HandleFallsBackOnTypeMismatch) {
+    auto& config = Config::instance();
+    config.load_from_file(test_file_);
+
+    auto as_int = config.handle<int>("double_value", 5);
+    EXPECT_EQ(as_int.get(), 5);
+
+    auto missing = config.handle<std::string>("handle_missing", "none");
+    EXPECT_EQ(missing.get(), "none");
+    config.set("handle_missing", std::string("present"));
+    EXPECT_EQ(missing.get(), "present");
+}
+
+TEST_F(ConfigTest, SnapshotIsImmutable) {
+    auto& config = Config::instance();
+    config.set("snapshot_key", 1);
+
+    const ConfigSnapshot& before = config.snapshot();
+    const uint64_t version = config.version();
+    config.set("snapshot_key", 2);
+
+    EXPECT_EQ(before.get<int>("snapshot_key"), 1);
+    EXPECT_EQ(config.get<int>("snapshot_key"), 2);
+    EXPECT_EQ(config.version(), version + 1);
+}
+
+TEST_F(ConfigTest, LoadPublishesOneVersion) {
+    auto& config = Config::instance();
+    config.set("int_value", 0);
+    config.set("bool_value", false);
+    const uint64_t version = config.version();
+    config.load_from_file(test_file_);
+    EXPECT_EQ(config.version(), version + 1);
+
+    // Nothing differs, so nothing is published.
+    config.load_from_file(test_file_);
+    EXPECT_EQ(config.version(), version + 1);
+}
+
+TEST_F(ConfigTest, HandleReadsDuringUpdates) {
+    auto& config = Config::instance();
+    config.set("concurrent_a", 0);
+    config.set("concurrent_b", 0);
+    auto a = config.handle<int>("concurrent_a");
+
+    std::atomic<bool> done{false};
+    std::atomic<bool> ordered{true};
+    std::thread reader([&] {
+        int last = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            const int value = a.get();
+            if (value < last) {
+                ordered = false;
+            }
+            last = value;
+
+            // b is set right after a, so one version never has them further apart.
+            const ConfigSnapshot& s = config.snapshot();
+            const int diff = s.get<int>("concurrent_a") - s.get<int>("concurrent_b");
+            if (diff != 0 && diff != 1) {
+                ordered = false;
+            }
+        }
+    });
+
+    for (int i = 1; i <= 1000; ++i) {
+        config.load_from_file(test_file_);
+        config.set("concurrent_a", i);
+        config.set("concurrent_b", i);
+    }
+    done = true;
+    reader.join();
+
+    EXPECT_TRUE(ordered.load());
+    EXPECT_EQ(a.get(), 1000);
+}
+
+TEST_F(ConfigTest, ParsesTypedValues) {
+    EXPECT_EQ(std::get<int>(Config::parse_value("42")), 42);
+    EXPECT_EQ(std::get<int>(Config::parse_value("+7")), 7);
+    EXPECT_EQ(std::get<int64_t>(Config::parse_value("5000000000")), 5000000000ll);
+    EXPECT_EQ(std::get<int64_t>(Config::parse_value("-9223372036854775808")), INT64_MIN);
+    EXPECT_EQ(std::get<uint64_t>(Config::parse_value("18446744073709551615")), UINT64_MAX);
+    EXPECT_DOUBLE_EQ(std::get<double>(Config::parse_value("1e3")), 1000.0);
+    EXPECT_EQ(std::get<std::string>(Config::parse_value("\"42\"")), "42");
+    EXPECT_EQ(std::get<std::string>(Config::parse_value("XNAS")), "XNAS");
+
+    using std::chrono::nanoseconds;
+    EXPECT_EQ(std::get<nanoseconds>(Config::parse_value("500us")), nanoseconds(500000));
+    EXPECT_EQ(std::get<nanoseconds>(Config::parse_value("1.5ms")), nanoseconds(1500000));
+    EXPECT_EQ(std::get<nanoseconds>(Config::parse_value("2min")), std::chrono::minutes(2));
+    EXPECT_EQ(std::get<std::string>(Config::parse_value("5parsecs")), "5parsecs");
+
+    EXPECT_EQ(std::get<std::vector<int64_t>>(Config::parse_value("[1, 2, 3]")),
+              (std::vector<int64_t>{1, 2, 3}));
+    EXPECT_EQ(std::get<std::vector<double>>(Config::parse_value("[1, 2.5]")),
+              (std::vector<double>{1.0, 2.5}));
+    EXPECT_EQ(std::get<std::vector<std::string>>(Config::parse_value("[\"a,b\", c]")),
+              (std::vector<std::string>{"a,b", "c"}));
+}
+
+TEST_F(ConfigTest, ConvertsBetweenNumericTypes) {
+    auto& config = Config::instance();
+    config.set("convert_small", 42);
+    config.set("convert_large", int64_t(5000000000));
+    config.set("convert_negative", -1);
+
+    EXPECT_EQ(config.get<int64_t>("convert_small"), 42);
+    EXPECT_EQ(config.get<uint64_t>("convert_small"), 42u);
+    EXPECT_DOUBLE_EQ(config.get<double>("convert_small"), 42.0);
+    EXPECT_EQ(config.get<int>("convert_large", -1), -1);
+    EXPECT_EQ(config.get<uint64_t>("convert_negative", 9), 9u);
+    EXPECT_FALSE(config.get<bool>("convert_small", false));
+
+    auto handle = config.handle<int64_t>("convert_small");
+    EXPECT_EQ(handle.get(), 42);
+}
+
+TEST_F(ConfigTest, LooksUpByStringView) {
+    auto& config = Config::instance();
+    config.load_from_file(test_file_);
+
+    const std::string buffer = "int_value=...";
+    const std::string_view key(buffer.data(), 9);
+    EXPECT_EQ(config.get<int>(key), 42);
+    EXPECT_TRUE(config.has(key));
+    EXPECT_FALSE(config.has(std::string_view(buffer.data(), 8)));
+}
+
+TEST_F(ConfigTest, SaveRoundTripsEveryType) {
+    auto& config = Config::instance();
+    config.set("round.text", std::string("a b"));
+    config.set("round.int", 3);
+    config.set("round.int64", int64_t(-5000000000));
+    config.set("round.uint64", UINT64_MAX);
+    config.set("round.double", 2.0);
+    config.set("round.precise", 0.1 + 0.2);
+    config.set("round.bool", false);
+    config.set("round.timeout", std::chrono::nanoseconds(std::chrono::microseconds(250)));
+    config.set("round.ids", std::vector<int64_t>{1, -2});
+    config.set("round.weights", std::vector<double>{0.5, 3.0});
+    config.set("round.venues", std::vector<std::string>{"XNAS", "a,b"});
+
+    const std::string saved = "test_config_saved.conf";
+    ASSERT_TRUE(config.save_to_file(saved));
+    ConfigValues loaded;
+    ASSERT_TRUE(Config::parse_file(saved, loaded));
+    std::filesystem::remove(saved);
+
+    for (const auto& [key, value] : config.snapshot().values()) {
+        ASSERT_EQ(loaded.count(key), 1u) << key;
+        EXPECT_TRUE(loaded.at(key) == value) << key << " = " << Config::format_value(value);
+    }
+}
+
+TEST_F(ConfigTest, ParsesLargeFile) {
+    const std::string large = "test_config_large.conf";
+    {
+        std::ofstream out(large);
+        for (int i = 0; i < 50000; ++i) {
+            out << "instrument." << i << ".max_qty = " << (i * 100) << "\n";
+        }
+        out << "  # indented comment\n\nmissing_equals\n";
+    }
+
+    ConfigValues values;
+    ASSERT_TRUE(Config::parse_file(large, values));
+    std::filesystem::remove(large);
+
+    EXPECT_EQ(values.size(), 50000u);
+    EXPECT_EQ(std::get<int>(values.at("instrument.49999.max_qty")), 4999900);
+}
+
+TEST_F(ConfigTest, IndependentInstancesAndThreadBinding) {
+    Config local;
+    local.set("binding.limit", 7);
+    EXPECT_FALSE(Config::instance().has("binding.limit"));
+    EXPECT_EQ(&Config::current(), &Config::instance());
+    EXPECT_EQ(CONFIG_GET_INT("binding.limit", -1), -1);
+
+    {
+        ThreadBinding<Config> bind(local);
+        EXPECT_EQ(&Config::current(), &local);
+        EXPECT_EQ(CONFIG_GET_INT("binding.limit", -1), 7);
+        CONFIG_SET("binding.other", 1);
+
+        // Bindings are per thread.
+        int seen = 0;
+        std::thread([&seen] { seen = CONFIG_GET_INT("binding.limit", -1); }).join();
+        EXPECT_EQ(seen, -1);
+    }
+
+    EXPECT_EQ(&Config::current(), &Config::instance());
+    EXPECT_TRUE(local.has("binding.other"));
+    EXPECT_FALSE(Config::instance().has("binding.other"));
+}
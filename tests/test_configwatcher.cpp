@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include "hft_core/ConfigWatcher.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+using namespace hft::core;
+
+class ConfigWatcherTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory_ = std::filesystem::temp_directory_path() /
+                     ("hft_config_watch." + std::to_string(::getpid()));
+        std::filesystem::create_directories(directory_);
+        file_ = (directory_ / "risk.conf").string();
+
+        EventBus::instance().subscribe<ConfigChanged>([this](const ConfigChanged& event) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            events_.push_back(event);
+            seen_in_handler_.push_back(Config::instance().has(event.key) != event.removed());
+        });
+    }
+
+    void TearDown() override {
+        EventBus::instance().unsubscribe<ConfigChanged>();
+        std::filesystem::remove_all(directory_);
+    }
+
+    // Replaces the file the way editors do: write a temporary, rename over.
+    void write_file(const std::string& contents) {
+        const std::string temporary = file_ + ".tmp";
+        {
+            std::ofstream out(temporary);
+            out << contents;
+        }
+        std::filesystem::rename(temporary, file_);
+    }
+
+    std::vector<ConfigChanged> events() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return events_;
+    }
+
+    std::filesystem::path directory_;
+    std::string file_;
+    std::mutex mutex_;
+    std::vector<ConfigChanged> events_;
+    std::vector<bool> seen_in_handler_;
+};
+
+TEST_F(ConfigWatcherTest, ReloadAppliesDiffAndPublishes) {
+    auto& config = Config::instance();
+    write_file("cw.limit=100\ncw.venue=\"XNAS\"\n");
+
+    ConfigWatcher watcher(file_);
+    EXPECT_EQ(watcher.reload().size(), 2u);
+    EXPECT_EQ(config.get<int>("cw.limit"), 100);
+
+    write_file("cw.limit=250\ncw.enabled=true\n");
+    const auto changes = watcher.reload();
+    ASSERT_EQ(changes.size(), 3u);
+    EXPECT_EQ(config.get<int>("cw.limit"), 250);
+    EXPECT_TRUE(config.get<bool>("cw.enabled"));
+    EXPECT_FALSE(config.has("cw.venue"));
+
+    const auto published = events();
+    ASSERT_EQ(published.size(), 5u);
+    int added = 0, modified = 0, removed = 0;
+    for (size_t i = 2; i < published.size(); ++i) {
+        const auto& event = published[i];
+        if (event.removed()) {
+            ++removed;
+            EXPECT_EQ(event.key, "cw.venue");
+        } else if (event.added()) {
+            ++added;
+            EXPECT_EQ(event.key, "cw.enabled");
+        } else {
+            ++modified;
+            EXPECT_EQ(std::get<int>(*event.old_value), 100);
+            EXPECT_EQ(std::get<int>(*event.new_value), 250);
+        }
+    }
+    EXPECT_EQ(added, 1);
+    EXPECT_EQ(modified, 1);
+    EXPECT_EQ(removed, 1);
+
+    // Handlers already see the version that carries their change.
+    for (bool seen : seen_in_handler_) {
+        EXPECT_TRUE(seen);
+    }
+
+    // Unchanged file: no new version, no events.
+    const uint64_t version = config.version();
+    EXPECT_TRUE(watcher.reload().empty());
+    EXPECT_EQ(config.version(), version);
+    EXPECT_EQ(events().size(), 5u);
+}
+
+TEST_F(ConfigWatcherTest, RuntimeOverridesSurviveReload) {
+    auto& config = Config::instance();
+    config.set("cw.override", 5);
+    write_file("cw.file_only=1\n");
+
+    ConfigWatcher watcher(file_);
+    watcher.reload();
+    write_file("cw.file_only=2\n");
+    watcher.reload();
+
+    EXPECT_EQ(config.get<int>("cw.override"), 5);
+    EXPECT_EQ(config.get<int>("cw.file_only"), 2);
+}
+
+TEST_F(ConfigWatcherTest, UnreadableFileKeepsCurrentValues) {
+    auto& config = Config::instance();
+    write_file("cw.kept=9\n");
+
+    ConfigWatcher watcher(file_);
+    watcher.reload();
+    std::filesystem::remove(file_);
+
+    EXPECT_TRUE(watcher.reload().empty());
+    EXPECT_EQ(watcher.failure_count(), 1u);
+    EXPECT_EQ(config.get<int>("cw.kept"), 9);
+}
+
+TEST_F(ConfigWatcherTest, WatchesFileReplacement) {
+    auto& config = Config::instance();
+    write_file("cw.watched=1\n");
+    auto watched = config.handle<int>("cw.watched", 0);
+
+    ConfigWatcherOptions options;
+    options.settle = std::chrono::milliseconds(5);
+    ConfigWatcher watcher(file_, options);
+    watcher.start();
+    EXPECT_TRUE(watcher.running());
+    EXPECT_EQ(watched.get(), 1);
+    EXPECT_THROW(watcher.start(), std::logic_error);
+
+    write_file("cw.watched=2\n");
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (watched.get() != 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(watched.get(), 2);
+
+    // Other files in the directory are ignored.
+    const uint64_t reloads = watcher.reload_count();
+    std::ofstream(directory_ / "other.conf") << "x=1\n";
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(watcher.reload_count(), reloads);
+
+    watcher.stop();
+    EXPECT_FALSE(watcher.running());
+}
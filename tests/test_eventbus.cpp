@@ -3,6 +3,8 @@
 #include <atomic>
 #include <thread>
 #include <chrono>
+#include <algorithm>
+#include <vector>
 
 using namespace hft::core;
 
@@ -25,8 +27,9 @@ private:
 class EventBusTest : public ::testing::Test {
 protected:
     void SetUp() override {
-        // Clean up any existing handlers
+        // Clean up any existing handlers and async workers
         auto& bus = EventBus::instance();
+        bus.shutdown();
         bus.unsubscribe<TestEvent>();
         bus.unsubscribe<AnotherTestEvent>();
     }
@@ -119,4 +122,369 @@ TEST_F(EventBusTest, AsyncMode) {
     EXPECT_EQ(received_value.load(), 999);
     
     bus.set_async_mode(false);
-}
\ No newline at end of file
+}
+
+TEST_F(EventBusTest, ShutdownWhilePublishing) {
+    auto& bus = EventBus::instance();
+    std::atomic<int> handled{0};
+    bus.subscribe<TestEvent>([&handled](const TestEvent&) { handled.fetch_add(1); });
+
+    std::atomic<bool> running{true};
+    std::atomic<int> published{0};
+    std::vector<std::thread> publishers;
+    for (int t = 0; t < 2; ++t) {
+        publishers.emplace_back([&] {
+            while (running.load()) {
+                bus.emit<TestEvent>(1);
+                published.fetch_add(1);
+            }
+        });
+    }
+    for (int i = 0; i < 20; ++i) {
+        bus.set_async_mode(true);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        bus.shutdown();
+    }
+    running.store(false);
+    for (auto& publisher : publishers) {
+        publisher.join();
+    }
+
+    // Events that raced with a shutdown are still queued, not lost.
+    bus.set_async_mode(true);
+    bus.flush();
+    bus.shutdown();
+    EXPECT_EQ(handled.load(), published.load());
+}
+
+DECLARE_EVENT(LargeTestEvent) {
+public:
+    explicit LargeTestEvent(int value) : value_(value) {}
+    int get_value() const { return value_; }
+private:
+    int value_;
+    char payload_[512] = {};
+};
+
+TEST_F(EventBusTest, AsyncSingleProducerPreservesOrder) {
+    auto& bus = EventBus::instance();
+    std::vector<int> received;
+
+    bus.subscribe<TestEvent>([&received](const TestEvent& event) {
+        received.push_back(event.get_value());
+    });
+
+    AsyncOptions options;
+    options.queue_capacity = 64;
+    options.producer_mode = ProducerMode::Single;
+    options.wait_strategy = WaitStrategy::Yield;
+    bus.set_async_options(options);
+    bus.set_async_mode(true);
+
+    for (int i = 0; i < 1000; ++i) {
+        bus.emit<TestEvent>(i);
+    }
+    bus.flush();
+
+    ASSERT_EQ(received.size(), 1000);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(received[i], i);
+    }
+
+    bus.shutdown();
+}
+
+TEST_F(EventBusTest, AsyncMultiProducer) {
+    auto& bus = EventBus::instance();
+    std::atomic<int> count{0};
+
+    bus.subscribe<TestEvent>([&count](const TestEvent&) {
+        count.fetch_add(1);
+    });
+
+    bus.set_async_mode(true);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 4; ++p) {
+        producers.emplace_back([&bus] {
+            for (int i = 0; i < 500; ++i) {
+                bus.emit<TestEvent>(i);
+            }
+        });
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    bus.flush();
+
+    EXPECT_EQ(count.load(), 2000);
+    bus.shutdown();
+}
+
+TEST_F(EventBusTest, AsyncLargeEventOutOfLine) {
+    auto& bus = EventBus::instance();
+    std::atomic<int> received_value{0};
+
+    bus.subscribe<LargeTestEvent>([&received_value](const LargeTestEvent& event) {
+        received_value.store(event.get_value());
+    });
+
+    bus.set_async_mode(true);
+    bus.emit<LargeTestEvent>(7);
+    bus.flush();
+
+    EXPECT_EQ(received_value.load(), 7);
+    bus.shutdown();
+}
+
+TEST_F(EventBusTest, AsyncOptionsLockedWhileRunning) {
+    auto& bus = EventBus::instance();
+    bus.set_async_mode(true);
+
+    EXPECT_THROW(bus.set_async_options(AsyncOptions{}), std::logic_error);
+
+    bus.shutdown();
+    EXPECT_NO_THROW(bus.set_async_options(AsyncOptions{}));
+}
+
+TEST_F(EventBusTest, AsyncLargeEventsUseWarmPool) {
+    auto& bus = EventBus::instance();
+    std::atomic<int> count{0};
+
+    bus.subscribe<LargeTestEvent>([&count](const LargeTestEvent&) {
+        count.fetch_add(1);
+    });
+
+    EventBus::reserve_event_pool<LargeTestEvent>(256);
+    size_t misses_before = EventBus::event_pool_misses<LargeTestEvent>();
+
+    bus.set_async_mode(true);
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 100; ++i) {
+            bus.emit<LargeTestEvent>(i);
+        }
+        bus.flush();
+    }
+    bus.emit<TestEvent>(1);
+    bus.flush();
+
+    EXPECT_EQ(count.load(), 1000);
+    EXPECT_EQ(EventBus::event_pool_misses<LargeTestEvent>(), misses_before);
+
+    AsyncStats stats = bus.async_stats();
+    EXPECT_EQ(stats.pooled_events, 1000);
+    EXPECT_EQ(stats.inline_events, 1);
+    EXPECT_EQ(stats.dispatched, 1001);
+
+    bus.shutdown();
+}
+
+TEST_F(EventBusTest, TscTimestampSource) {
+    Event::set_timestamp_source(TimestampSource::Tsc);
+    uint64_t before = Timer::rdtsc();
+    TestEvent event(1);
+    uint64_t after = Timer::rdtsc();
+    Event::set_timestamp_source(TimestampSource::Chrono);
+
+    EXPECT_GE(event.timestamp, before);
+    EXPECT_LE(event.timestamp, after);
+}
+
+DECLARE_EVENT(InstrumentEvent) {
+public:
+    InstrumentEvent(uint32_t instrument, int seq) : instrument_(instrument), seq_(seq) {}
+    uint32_t shard_key() const { return instrument_; }
+    uint32_t instrument() const { return instrument_; }
+    int seq() const { return seq_; }
+private:
+    uint32_t instrument_;
+    int seq_;
+};
+
+TEST_F(EventBusTest, ShardedWorkersPreservePerKeyOrder) {
+    auto& bus = EventBus::instance();
+    constexpr uint32_t kInstruments = 16;
+    constexpr int kPerInstrument = 200;
+
+    std::vector<int> last_seq(kInstruments, -1);
+    std::vector<std::thread::id> owner(kInstruments);
+    std::atomic<int> out_of_order{0};
+    std::atomic<int> count{0};
+
+    bus.unsubscribe<InstrumentEvent>();
+    bus.subscribe<InstrumentEvent>([&](const InstrumentEvent& event) {
+        // Each instrument is owned by exactly one worker, so per-instrument
+        // state needs no synchronisation.
+        uint32_t id = event.instrument();
+        if (event.seq() != last_seq[id] + 1) {
+            out_of_order.fetch_add(1);
+        }
+        last_seq[id] = event.seq();
+        owner[id] = std::this_thread::get_id();
+        count.fetch_add(1);
+    });
+
+    AsyncOptions options;
+    options.worker_count = 4;
+    options.worker_cpus = {0};
+    bus.set_async_options(options);
+    bus.set_async_mode(true);
+    EXPECT_EQ(bus.worker_count(), 4);
+
+    for (int seq = 0; seq < kPerInstrument; ++seq) {
+        for (uint32_t id = 0; id < kInstruments; ++id) {
+            bus.emit<InstrumentEvent>(id, seq);
+        }
+    }
+    bus.flush();
+
+    EXPECT_EQ(count.load(), static_cast<int>(kInstruments) * kPerInstrument);
+    EXPECT_EQ(out_of_order.load(), 0);
+    EXPECT_NE(owner[0], owner[1]);
+    EXPECT_EQ(owner[0], owner[4]);
+
+    bus.shutdown();
+}
+
+TEST_F(EventBusTest, ExplicitShardKey) {
+    auto& bus = EventBus::instance();
+    std::vector<std::thread::id> seen(2);
+
+    bus.subscribe<TestEvent>([&seen](const TestEvent& event) {
+        seen[event.get_value()] = std::this_thread::get_id();
+    });
+
+    AsyncOptions options;
+    options.worker_count = 2;
+    bus.set_async_options(options);
+    bus.set_async_mode(true);
+
+    bus.publish(TestEvent(0), 0);
+    bus.publish(TestEvent(1), 1);
+    bus.flush();
+
+    EXPECT_NE(seen[0], seen[1]);
+    bus.shutdown();
+
+    options.worker_count = 0;
+    EXPECT_THROW(bus.set_async_options(options), std::invalid_argument);
+}
+
+TEST_F(EventBusTest, PublishBatchSync) {
+    auto& bus = EventBus::instance();
+    std::vector<size_t> batch_sizes;
+    int single_count = 0;
+
+    bus.subscribe_batch<TestEvent>([&batch_sizes](Span<const TestEvent> events) {
+        batch_sizes.push_back(events.size());
+    });
+    bus.subscribe<TestEvent>([&single_count](const TestEvent&) {
+        ++single_count;
+    });
+
+    std::vector<TestEvent> packet;
+    for (int i = 0; i < 10; ++i) {
+        packet.emplace_back(i);
+    }
+    bus.publish_batch(Span<const TestEvent>(packet));
+    bus.emit<TestEvent>(99);
+
+    ASSERT_EQ(batch_sizes.size(), 2);
+    EXPECT_EQ(batch_sizes[0], 10);
+    EXPECT_EQ(batch_sizes[1], 1);
+    EXPECT_EQ(single_count, 11);
+}
+
+TEST_F(EventBusTest, PublishBatchAsyncPreservesOrder) {
+    auto& bus = EventBus::instance();
+    std::vector<int> received;
+    size_t largest_batch = 0;
+
+    bus.subscribe_batch<TestEvent>([&](Span<const TestEvent> events) {
+        largest_batch = std::max(largest_batch, events.size());
+        for (const auto& event : events) {
+            received.push_back(event.get_value());
+        }
+    });
+
+    bus.set_async_mode(true);
+
+    std::vector<TestEvent> packet;
+    for (int i = 0; i < 100; ++i) {
+        packet.emplace_back(i);
+    }
+    bus.publish_batch(Span<const TestEvent>(packet));
+    bus.emit<TestEvent>(100);
+    bus.flush();
+
+    ASSERT_EQ(received.size(), 101);
+    for (int i = 0; i <= 100; ++i) {
+        EXPECT_EQ(received[i], i);
+    }
+    EXPECT_EQ(largest_batch, detail::kBatchChunkEvents);
+
+    AsyncStats stats = bus.async_stats();
+    EXPECT_EQ(stats.batched_events, 100);
+    EXPECT_EQ(stats.inline_events, 1);
+    EXPECT_EQ(stats.dispatched, 101);
+    EXPECT_GE(stats.drains, 1);
+
+    bus.shutdown();
+}
+
+TEST_F(EventBusTest, DispatchArenaScopesHandlers) {
+    auto& bus = EventBus::instance();
+    std::atomic<int> with_arena{0};
+
+    bus.subscribe<TestEvent>([&with_arena](const TestEvent& event) {
+        if (Arena* arena = Arena::current()) {
+            auto* scratch = arena->allocate_array<int>(256);
+            scratch[255] = event.get_value();
+            with_arena.fetch_add(scratch[255] == event.get_value());
+        }
+    });
+
+    bus.publish(TestEvent(1));
+    EXPECT_EQ(with_arena.load(), 0);
+
+    bus.set_dispatch_arena(true);
+    bus.publish(TestEvent(2));
+    EXPECT_EQ(with_arena.load(), 1);
+    EXPECT_EQ(Arena::current(), nullptr);
+
+    bus.set_async_mode(true);
+    for (int i = 0; i < 100; ++i) {
+        bus.publish(TestEvent(i));
+    }
+    bus.flush();
+    EXPECT_EQ(with_arena.load(), 101);
+
+    bus.shutdown();
+    bus.set_dispatch_arena(false);
+}
+
+TEST_F(EventBusTest, IndependentBusesShareNothing) {
+    EventBus local;
+    std::atomic<int> default_seen{0};
+    std::atomic<int> local_seen{0};
+    EventBus::instance().subscribe<TestEvent>([&](const TestEvent&) { default_seen.fetch_add(1); });
+    local.subscribe<TestEvent>([&](const TestEvent& event) { local_seen.fetch_add(event.get_value()); });
+
+    local.publish(TestEvent(5));
+    EXPECT_EQ(local_seen.load(), 5);
+    EXPECT_EQ(default_seen.load(), 0);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&local) % kCacheLineSize, 0u);
+
+    {
+        ThreadBinding<EventBus> bind(local);
+        EventBus::current().emit<TestEvent>(2);
+    }
+    EventBus::current().emit<TestEvent>(100);
+    EXPECT_EQ(local_seen.load(), 7);
+    EXPECT_EQ(default_seen.load(), 1);
+
+    local.set_async_mode(true);
+    local.publish(TestEvent(1));
+    local.flush();
+    EXPECT_EQ(local_seen.load(), 8);
+}
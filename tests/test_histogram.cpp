@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include "hft_core/Histogram.hpp"
+#include "hft_core/Timer.hpp"
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace hft::core;
+
+TEST(HistogramTest, LayoutRoundTripsWithinPrecision) {
+    namespace layout = histogram_layout;
+    EXPECT_EQ(layout::index_of(0), 0u);
+    EXPECT_EQ(layout::index_of(255), 255u);
+    EXPECT_EQ(layout::index_of(~uint64_t(0)), layout::kBucketCount - 1);
+    EXPECT_EQ(layout::highest_value(layout::kBucketCount - 1), ~uint64_t(0));
+
+    for (uint64_t value : {1ull, 200ull, 256ull, 1000ull, 123456ull, 987654321ull, 1ull << 40}) {
+        const size_t index = layout::index_of(value);
+        EXPECT_LE(layout::lowest_value(index), value);
+        EXPECT_GE(layout::highest_value(index), value);
+        EXPECT_LE(layout::highest_value(index) - layout::lowest_value(index), value / 128);
+    }
+
+    // Buckets are contiguous.
+    for (size_t i = 1; i < layout::kBucketCount; ++i) {
+        ASSERT_EQ(layout::lowest_value(i), layout::highest_value(i - 1) + 1) << i;
+    }
+}
+
+TEST(HistogramTest, QuantilesOfUniformValues) {
+    auto histogram = std::make_unique<Histogram>();
+    for (uint64_t v = 1; v <= 10000; ++v) {
+        histogram->record(v);
+    }
+
+    const HistogramSnapshot snapshot = histogram->snapshot();
+    EXPECT_EQ(snapshot.count(), 10000u);
+    EXPECT_EQ(snapshot.min(), 1u);
+    EXPECT_EQ(snapshot.max(), 10000u);
+    EXPECT_DOUBLE_EQ(snapshot.mean(), 5000.5);
+
+    EXPECT_NEAR(static_cast<double>(snapshot.p50()), 5000.0, 5000.0 / 128);
+    EXPECT_NEAR(static_cast<double>(snapshot.p99()), 9900.0, 9900.0 / 128);
+    EXPECT_NEAR(static_cast<double>(snapshot.p999()), 9990.0, 9990.0 / 128);
+    EXPECT_EQ(snapshot.value_at_quantile(1.0), 10000u);
+    EXPECT_EQ(snapshot.value_at_quantile(0.0), 1u);
+}
+
+TEST(HistogramTest, OutlierShowsUpInTail) {
+    auto histogram = std::make_unique<Histogram>();
+    for (int i = 0; i < 999; ++i) {
+        histogram->record(100);
+    }
+    histogram->record(1000000);
+
+    const HistogramSnapshot snapshot = histogram->snapshot();
+    EXPECT_EQ(snapshot.p50(), 100u);
+    EXPECT_EQ(snapshot.p99(), 100u);
+    EXPECT_EQ(snapshot.value_at_quantile(0.9995), 1000000u);
+    EXPECT_EQ(snapshot.max(), 1000000u);
+    EXPECT_EQ(snapshot.count_at(100), 999u);
+}
+
+TEST(HistogramTest, EmptyAndReset) {
+    auto histogram = std::make_unique<Histogram>();
+    HistogramSnapshot empty = histogram->snapshot();
+    EXPECT_EQ(empty.count(), 0u);
+    EXPECT_EQ(empty.min(), 0u);
+    EXPECT_EQ(empty.max(), 0u);
+    EXPECT_EQ(empty.p99(), 0u);
+
+    histogram->record(42);
+    histogram->reset();
+    EXPECT_EQ(histogram->snapshot().count(), 0u);
+    histogram->record(7);
+    EXPECT_EQ(histogram->snapshot().min(), 7u);
+    EXPECT_EQ(histogram->snapshot().max(), 7u);
+}
+
+TEST(HistogramTest, SnapshotsMerge) {
+    auto a = std::make_unique<Histogram>();
+    auto b = std::make_unique<Histogram>();
+    for (int i = 0; i < 100; ++i) {
+        a->record(10);
+        b->record(5000);
+    }
+
+    HistogramSnapshot merged = a->snapshot();
+    merged.merge(b->snapshot());
+    EXPECT_EQ(merged.count(), 200u);
+    EXPECT_EQ(merged.min(), 10u);
+    EXPECT_EQ(merged.max(), 5000u);
+    EXPECT_EQ(merged.value_at_quantile(0.5), 10u);
+    EXPECT_EQ(merged.value_at_quantile(0.75), 5000u);
+}
+
+TEST(HistogramTest, ConcurrentRecordingWhileSnapshotting) {
+    ConcurrentHistogram histogram(4);
+    constexpr int kThreads = 4;
+    constexpr uint64_t kPerThread = 20000;
+
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        uint64_t last = 0;
+        while (!done.load()) {
+            const uint64_t count = histogram.snapshot().count();
+            EXPECT_GE(count, last);
+            last = count;
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; ++t) {
+        writers.emplace_back([&, t] {
+            for (uint64_t i = 0; i < kPerThread; ++i) {
+                histogram.record(1000 * static_cast<uint64_t>(t + 1) + i % 100);
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    done.store(true);
+    reader.join();
+
+    const HistogramSnapshot snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count(), kThreads * kPerThread);
+    EXPECT_EQ(snapshot.min(), 1000u);
+    EXPECT_EQ(snapshot.max(), 4099u);
+}
+
+TEST(HistogramTest, ScopedTimerRecordsIntoHistogram) {
+    auto histogram = std::make_unique<Histogram>();
+    for (int i = 0; i < 3; ++i) {
+        ScopedTimer timer(*histogram);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const HistogramSnapshot snapshot = histogram->snapshot();
+    EXPECT_EQ(snapshot.count(), 3u);
+    EXPECT_GE(snapshot.min(), 900000u);
+
+    ConcurrentHistogram shared(2);
+    {
+        ScopedTimer timer(shared);
+    }
+    EXPECT_EQ(shared.snapshot().count(), 1u);
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "hft_core/InlineTask.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace hft::core;
+
+TEST(InlineTaskTest, InvokesStoredCallable) {
+    int calls = 0;
+    InlineTask task([&calls] { ++calls; });
+    ASSERT_TRUE(task);
+    task();
+    task();
+    EXPECT_EQ(calls, 2);
+
+    InlineTask empty;
+    EXPECT_FALSE(empty);
+}
+
+TEST(InlineTaskTest, MoveTransfersOwnership) {
+    auto counter = std::make_shared<int>(0);
+    InlineTask first([counter] { ++*counter; });
+    EXPECT_EQ(counter.use_count(), 2);
+
+    InlineTask second(std::move(first));
+    EXPECT_FALSE(first);
+    second();
+    EXPECT_EQ(*counter, 1);
+
+    InlineTask third;
+    third = std::move(second);
+    third();
+    EXPECT_EQ(*counter, 2);
+    EXPECT_EQ(counter.use_count(), 2);
+
+    third.reset();
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(InlineTaskTest, AcceptsMoveOnlyCallables) {
+    auto value = std::make_unique<int>(41);
+    int result = 0;
+    InlineTask task([value = std::move(value), &result] { result = *value + 1; });
+    task();
+    EXPECT_EQ(result, 42);
+}
+
+TEST(InlineTaskTest, CapacityIsCheckedAtCompileTime) {
+    std::array<char, 48> small{};
+    std::array<char, 128> large{};
+    auto fits = [small] { (void)small; };
+    auto too_big = [large] { (void)large; };
+    static_assert(InlineTask::fits<decltype(fits)>());
+    static_assert(!InlineTask::fits<decltype(too_big)>());
+}
+
+TEST(CountdownLatchTest, WaitReturnsAfterAllCountDowns) {
+    CountdownLatch latch;
+    std::atomic<int> done{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        latch.add();
+        threads.emplace_back([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            done.fetch_add(1);
+            latch.count_down();
+        });
+    }
+
+    latch.wait();
+    EXPECT_EQ(done.load(), 4);
+    EXPECT_TRUE(latch.try_wait());
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+TEST(CountdownLatchTest, ZeroCountDoesNotBlock) {
+    CountdownLatch latch;
+    EXPECT_TRUE(latch.try_wait());
+    latch.wait();
+}
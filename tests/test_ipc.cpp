@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include "hft_core/EventBus.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace hft::core;
+
+namespace {
+
+struct Quote {
+    uint64_t id;
+    double price;
+};
+
+struct Fill {
+    static constexpr uint64_t ipc_type_id = 0xF111;
+    uint64_t order_id;
+    uint32_t quantity;
+};
+
+struct Received {
+    uint64_t type_id;
+    std::vector<char> bytes;
+};
+
+void collect(void* context, uint64_t type_id, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    static_cast<std::vector<Received>*>(context)->push_back({type_id, std::vector<char>(bytes, bytes + size)});
+}
+
+template<typename Predicate>
+bool wait_until(Predicate predicate) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+class IpcTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        EventBus::instance().close_ipc();
+        EventBus::instance().unsubscribe<Quote>();
+        EventBus::instance().unsubscribe<Fill>();
+    }
+
+    std::string name(const char* suffix) const {
+        return std::string("/hft_ipc_test.") + suffix + "." + std::to_string(::getpid());
+    }
+};
+
+TEST_F(IpcTest, ReaderSeesEventsWrittenAfterAttach) {
+    IpcOptions options;
+    options.capacity = 16;
+    detail::IpcWriter writer(name("roundtrip"), options);
+
+    const Quote before{1, 10.0};
+    writer.write(detail::ipc_type_id<Quote>(), &before, sizeof(before));
+
+    detail::IpcReader reader(name("roundtrip"));
+    std::vector<Received> received;
+    EXPECT_EQ(reader.poll(&collect, &received, 64), 0u);
+
+    const Quote after{2, 20.5};
+    const Fill fill{7, 300};
+    writer.write(detail::ipc_type_id<Quote>(), &after, sizeof(after));
+    writer.write(detail::ipc_type_id<Fill>(), &fill, sizeof(fill));
+
+    ASSERT_EQ(reader.poll(&collect, &received, 64), 2u);
+    EXPECT_EQ(received[0].type_id, detail::ipc_type_id<Quote>());
+    ASSERT_EQ(received[0].bytes.size(), sizeof(Quote));
+    Quote quote;
+    std::memcpy(&quote, received[0].bytes.data(), sizeof(quote));
+    EXPECT_EQ(quote.id, 2u);
+    EXPECT_DOUBLE_EQ(quote.price, 20.5);
+    EXPECT_EQ(received[1].type_id, 0xF111u);
+
+    EXPECT_EQ(writer.published(), 3u);
+    EXPECT_EQ(reader.received(), 2u);
+    EXPECT_EQ(reader.lost(), 0u);
+}
+
+TEST_F(IpcTest, LappedReaderCountsLostEvents) {
+    IpcOptions options;
+    options.capacity = 8;
+    detail::IpcWriter writer(name("lapped"), options);
+    detail::IpcReader reader(name("lapped"));
+
+    for (uint64_t i = 0; i < 20; ++i) {
+        const Quote quote{i, 0.0};
+        writer.write(detail::ipc_type_id<Quote>(), &quote, sizeof(quote));
+    }
+
+    std::vector<Received> received;
+    while (reader.poll(&collect, &received, 64) != 0) {}
+    EXPECT_GT(reader.lost(), 0u);
+    EXPECT_EQ(reader.received() + reader.lost(), 20u);
+
+    // Whatever survived is the newest, in order.
+    ASSERT_FALSE(received.empty());
+    Quote last;
+    std::memcpy(&last, received.back().bytes.data(), sizeof(last));
+    EXPECT_EQ(last.id, 19u);
+}
+
+TEST_F(IpcTest, RejectsOversizedEventsAndMissingSegments) {
+    IpcOptions options;
+    options.max_event_size = 8;
+    detail::IpcWriter writer(name("limits"), options);
+    const Quote quote{1, 1.0};
+    EXPECT_THROW(writer.write(detail::ipc_type_id<Quote>(), &quote, sizeof(quote)), std::length_error);
+    EXPECT_EQ(writer.published(), 0u);
+
+    EXPECT_THROW(detail::IpcReader(name("missing")), std::system_error);
+}
+
+TEST_F(IpcTest, PlainStructsPublishLocally) {
+    auto& bus = EventBus::instance();
+    std::vector<uint64_t> ids;
+    bus.subscribe<Quote>([&ids](const Quote& quote) { ids.push_back(quote.id); });
+
+    bus.publish(Quote{5, 1.5});
+    const Quote batch[] = {{6, 2.5}, {7, 3.5}};
+    bus.publish_batch(Span<const Quote>(batch, 2));
+
+    EXPECT_EQ(ids, (std::vector<uint64_t>{5, 6, 7}));
+}
+
+TEST_F(IpcTest, BusWriterFeedsSegment) {
+    auto& bus = EventBus::instance();
+    const IpcStats start = bus.ipc_stats();
+    bus.open_ipc_writer(name("bus_writer"));
+    EXPECT_THROW(bus.open_ipc_writer(name("bus_writer")), std::logic_error);
+    detail::IpcReader reader(name("bus_writer"));
+
+    bus.publish(Quote{11, 99.0});
+    bus.publish(Fill{12, 5});
+
+    std::vector<Received> received;
+    ASSERT_EQ(reader.poll(&collect, &received, 64), 2u);
+    EXPECT_EQ(received[0].type_id, detail::ipc_type_id<Quote>());
+    EXPECT_EQ(received[1].type_id, 0xF111u);
+    EXPECT_EQ(bus.ipc_stats().published - start.published, 2u);
+}
+
+TEST_F(IpcTest, AttachedReaderDispatchesToSubscribers) {
+    auto& bus = EventBus::instance();
+    const IpcStats start = bus.ipc_stats();
+    std::atomic<uint64_t> last_id{0};
+    std::atomic<int> count{0};
+    bus.subscribe<Quote>([&](const Quote& quote) {
+        last_id.store(quote.id, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_release);
+    });
+
+    detail::IpcWriter writer(name("attach"), IpcOptions{});
+    IpcOptions options;
+    options.spin_budget = 64;
+    bus.attach_ipc_reader(name("attach"), options);
+
+    for (uint64_t i = 1; i <= 100; ++i) {
+        const Quote quote{i, 0.0};
+        writer.write(detail::ipc_type_id<Quote>(), &quote, sizeof(quote));
+    }
+    // Nobody here subscribes to Fill.
+    const Fill fill{1, 1};
+    writer.write(detail::ipc_type_id<Fill>(), &fill, sizeof(fill));
+
+    EXPECT_TRUE(wait_until([&] { return bus.ipc_stats().received - start.received == 101; }));
+    EXPECT_EQ(count.load(std::memory_order_acquire), 100);
+    EXPECT_EQ(last_id.load(std::memory_order_relaxed), 100u);
+    EXPECT_EQ(bus.ipc_stats().unknown - start.unknown, 1u);
+
+    bus.close_ipc();
+    EXPECT_EQ(bus.ipc_stats().received - start.received, 101u);
+}
+
+} // namespace
@@ -0,0 +1,263 @@
+#include <gtest/gtest.h>
+#include "hft_core/EventBus.hpp"
+#include "hft_core/Journal.hpp"
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <sys/resource.h>
+#include <unistd.h>
+
+using namespace hft::core;
+
+namespace {
+
+struct Trade {
+    uint64_t timestamp;
+    uint64_t id;
+    double price;
+};
+
+struct Heartbeat {
+    uint32_t sequence;
+};
+
+class JournalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() /
+                 ("hft_journal_test." + std::to_string(::getpid()) + ".bin")).string();
+    }
+
+    void TearDown() override {
+        EventBus::instance().close_journal();
+        EventBus::instance().unsubscribe<Trade>();
+        EventBus::instance().unsubscribe<Heartbeat>();
+        std::filesystem::remove(path_);
+    }
+
+    std::string path_;
+};
+
+TEST_F(JournalTest, RecordsRoundTripAcrossChunks) {
+    JournalOptions options;
+    options.chunk_size = 4096;      // Forces many chunk switches
+    {
+        JournalWriter writer(path_, options);
+        for (uint64_t i = 0; i < 1000; ++i) {
+            const Trade trade{i * 10, i, 100.0 + static_cast<double>(i)};
+            writer.append(detail::ipc_type_id<Trade>(), trade.timestamp, &trade, sizeof(trade));
+        }
+        const Heartbeat beats[] = {{1}, {2}, {3}};
+        writer.append(detail::ipc_type_id<Heartbeat>(), 7, beats, sizeof(Heartbeat), 3);
+        EXPECT_EQ(writer.records(), 1003u);
+        writer.flush();
+    }
+
+    JournalReader reader(path_);
+    JournalRecord record;
+    for (uint64_t i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(reader.next(record));
+        ASSERT_EQ(record.type_id, detail::ipc_type_id<Trade>());
+        ASSERT_EQ(record.size, sizeof(Trade));
+        Trade trade;
+        std::memcpy(&trade, record.data, sizeof(trade));
+        EXPECT_EQ(trade.id, i);
+        EXPECT_EQ(record.timestamp, i * 10);
+    }
+    for (uint32_t i = 1; i <= 3; ++i) {
+        ASSERT_TRUE(reader.next(record));
+        Heartbeat beat;
+        std::memcpy(&beat, record.data, sizeof(beat));
+        EXPECT_EQ(beat.sequence, i);
+        EXPECT_EQ(record.timestamp, 7u);
+    }
+    EXPECT_FALSE(reader.next(record));
+
+    reader.rewind();
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.timestamp, 0u);
+}
+
+TEST_F(JournalTest, IgnoresRecordCutShortByCrash) {
+    {
+        JournalWriter writer(path_);
+        for (uint64_t i = 0; i < 3; ++i) {
+            const Trade trade{i, i, 1.0};
+            writer.append(detail::ipc_type_id<Trade>(), trade.timestamp, &trade, sizeof(trade));
+        }
+    }
+    // What a crash mid-append leaves: header and part of the payload, but
+    // no size yet.
+    {
+        std::ofstream out(path_, std::ios::binary | std::ios::app);
+        const uint32_t header[2] = {0, 0};
+        const uint64_t ids[2] = {99, detail::ipc_type_id<Trade>()};
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(ids), sizeof(ids));
+        out.write("partial!", 8);
+    }
+
+    JournalReader reader(path_);
+    JournalRecord record;
+    int count = 0;
+    while (reader.next(record)) {
+        ++count;
+        EXPECT_NE(record.timestamp, 99u);
+    }
+    EXPECT_EQ(count, 3);
+}
+
+TEST_F(JournalTest, ChunkGrowFailureKeepsWriterUsable) {
+    // A file size limit stands in for a full disk.
+    struct rlimit saved {};
+    ASSERT_EQ(::getrlimit(RLIMIT_FSIZE, &saved), 0);
+    const auto saved_handler = std::signal(SIGXFSZ, SIG_IGN);
+    struct rlimit limited = saved;
+    limited.rlim_cur = 4096;
+    ASSERT_EQ(::setrlimit(RLIMIT_FSIZE, &limited), 0);
+
+    JournalOptions options;
+    options.chunk_size = 4096;
+    {
+        JournalWriter writer(path_, options);
+        // Two 32-byte heartbeats, then 48-byte trades until the grow fails:
+        // that leaves 32 bytes, room for one more heartbeat.
+        const Heartbeat beats[] = {{1}, {2}, {3}};
+        writer.append(detail::ipc_type_id<Heartbeat>(), 1, beats, sizeof(Heartbeat), 2);
+        const Trade trade{1, 1, 100.0};
+        EXPECT_THROW({
+            for (int i = 0; i < 100; ++i) {
+                writer.append(detail::ipc_type_id<Trade>(), trade.timestamp, &trade, sizeof(trade));
+            }
+        }, std::system_error);
+        EXPECT_EQ(writer.records(), 2u + (4096u - 64u - 64u) / 48u);
+
+        writer.append(detail::ipc_type_id<Heartbeat>(), 2, &beats[2], sizeof(Heartbeat));
+        EXPECT_THROW(writer.append(detail::ipc_type_id<Trade>(), trade.timestamp, &trade, sizeof(trade)),
+                     std::system_error);
+
+        // Once there is space again the next append grows the file.
+        ::setrlimit(RLIMIT_FSIZE, &saved);
+        writer.append(detail::ipc_type_id<Trade>(), trade.timestamp, &trade, sizeof(trade));
+        EXPECT_EQ(writer.bytes(), 4096u + 48u);
+    }
+    ::setrlimit(RLIMIT_FSIZE, &saved);
+    std::signal(SIGXFSZ, saved_handler);
+
+    JournalReader reader(path_);
+    JournalRecord record;
+    size_t count = 0;
+    uint32_t last_sequence = 0;
+    while (reader.next(record)) {
+        if (record.type_id == detail::ipc_type_id<Heartbeat>()) {
+            last_sequence = static_cast<const Heartbeat*>(record.data)->sequence;
+        }
+        ++count;
+    }
+    EXPECT_EQ(count, 3u + (4096u - 64u - 64u) / 48u + 1u);
+    EXPECT_EQ(last_sequence, 3u);
+}
+
+TEST_F(JournalTest, RejectsBadInput) {
+    JournalOptions options;
+    options.chunk_size = 4096;
+    {
+        JournalWriter writer(path_, options);
+        std::vector<char> large(8192);
+        EXPECT_THROW(writer.append(1, 0, large.data(), large.size()), std::length_error);
+    }
+    std::ofstream(path_, std::ios::trunc) << std::string(128, 'x');
+    EXPECT_THROW(JournalReader{path_}, std::runtime_error);
+    EXPECT_THROW(JournalReader{path_ + ".missing"}, std::system_error);
+}
+
+TEST_F(JournalTest, BusJournalsAndReplaysInOrder) {
+    auto& bus = EventBus::instance();
+    std::vector<uint64_t> live;
+    bus.subscribe<Trade>([&live](const Trade& trade) { live.push_back(trade.id); });
+
+    bus.open_journal(path_);
+    EXPECT_THROW(bus.open_journal(path_), std::logic_error);
+    for (uint64_t i = 0; i < 100; ++i) {
+        bus.publish(Trade{1000 + i, i, 1.0});
+    }
+    const Heartbeat beats[] = {{1}, {2}};
+    bus.publish_batch(Span<const Heartbeat>(beats, 2));
+    bus.close_journal();
+    ASSERT_EQ(live.size(), 100u);
+
+    std::vector<uint64_t> replayed;
+    std::vector<uint32_t> heartbeats;
+    bus.unsubscribe<Trade>();
+    bus.subscribe<Trade>([&replayed](const Trade& trade) { replayed.push_back(trade.id); });
+    bus.subscribe<Heartbeat>([&heartbeats](const Heartbeat& beat) { heartbeats.push_back(beat.sequence); });
+
+    const ReplayStats stats = bus.replay(path_);
+    EXPECT_EQ(stats.replayed, 102u);
+    EXPECT_EQ(stats.unknown, 0u);
+    EXPECT_EQ(replayed, live);
+    EXPECT_EQ(heartbeats, (std::vector<uint32_t>{1, 2}));
+
+    // Partial replay; types nobody here subscribes to are counted.
+    bus.unsubscribe<Heartbeat>();
+    JournalReader reader(path_);
+    JournalRecord record;
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.timestamp, 1000u);
+    reader.rewind();
+    ReplayOptions options;
+    options.max_events = 10;
+    EXPECT_EQ(bus.replay(reader, options).replayed, 10u);
+    EXPECT_EQ(bus.replay(reader).replayed, 92u);
+}
+
+TEST_F(JournalTest, PacedReplayKeepsRecordedGaps) {
+    {
+        JournalWriter writer(path_);
+        for (uint64_t i = 0; i < 5; ++i) {
+            const Trade trade{i * 10'000'000, i, 0.0};     // 10 ms apart
+            writer.append(detail::ipc_type_id<Trade>(), trade.timestamp, &trade, sizeof(trade));
+        }
+    }
+    auto& bus = EventBus::instance();
+    bus.subscribe<Trade>([](const Trade&) {});
+
+    ReplayOptions options;
+    options.mode = ReplayMode::Paced;
+    options.speed = 2.0;
+    const ReplayStats paced = bus.replay(path_, options);
+    EXPECT_EQ(paced.replayed, 5u);
+    EXPECT_GE(paced.elapsed_ns, 20'000'000u);
+
+    const ReplayStats fast = bus.replay(path_);
+    EXPECT_EQ(fast.replayed, 5u);
+    EXPECT_LT(fast.elapsed_ns, paced.elapsed_ns);
+}
+
+TEST_F(JournalTest, PacedReplayToleratesOutOfOrderTimestamps) {
+    {
+        JournalWriter writer(path_);
+        for (uint64_t timestamp : {5'000'000ull, 1'000'000ull, 0ull, 6'000'000ull}) {
+            const Trade trade{timestamp, timestamp, 0.0};
+            writer.append(detail::ipc_type_id<Trade>(), trade.timestamp, &trade, sizeof(trade));
+        }
+    }
+    auto& bus = EventBus::instance();
+    std::vector<uint64_t> order;
+    bus.subscribe<Trade>([&order](const Trade& trade) { order.push_back(trade.id); });
+
+    ReplayOptions options;
+    options.mode = ReplayMode::Paced;
+    const ReplayStats stats = bus.replay(path_, options);
+    EXPECT_EQ(stats.replayed, 4u);
+    EXPECT_LT(stats.elapsed_ns, 1'000'000'000u);
+    EXPECT_EQ(order, (std::vector<uint64_t>{5'000'000, 1'000'000, 0, 6'000'000}));
+}
+
+} // namespace
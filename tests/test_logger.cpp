@@ -1,16 +1,23 @@
 #include <gtest/gtest.h>
 #include "hft_core/Logger.hpp"
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <filesystem>
 #include <thread>
 #include <chrono>
+#include <sstream>
+#include <string_view>
+#include <vector>
 
 using namespace hft::core;
 
 class LoggerTest : public ::testing::Test {
 protected:
     void SetUp() override {
-        test_log_file_ = "test_log.txt";
+        // One file per test, so ctest -j runs don't share it
+        test_log_file_ = std::string("test_log_") +
+                         ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".txt";
     }
 
     void TearDown() override {
@@ -81,4 +88,473 @@ TEST_F(LoggerTest, MacroUsage) {
     EXPECT_TRUE(content.find("Macro error message") != std::string::npos);
     EXPECT_TRUE(content.find("[INFO]") != std::string::npos);
     EXPECT_TRUE(content.find("[ERROR]") != std::string::npos);
-}
\ No newline at end of file
+}
+
+TEST_F(LoggerTest, FormattedArguments) {
+    auto& logger = Logger::instance();
+    logger.set_level(LogLevel::TRACE);
+    logger.set_output_file(test_log_file_);
+
+    std::string symbol = "AAPL";
+    LOG_INFO("filled {} {} @ {} buy={}", 100, symbol, 187.25, true);
+    LOG_WARN("literal {{}} and missing {}");
+    logger.flush();
+
+    std::ifstream file(test_log_file_);
+    std::string content((std::istreambuf_iterator<char>(file)),
+                        std::istreambuf_iterator<char>());
+
+    EXPECT_NE(content.find("filled 100 AAPL @ 187.25 buy=true"), std::string::npos);
+    EXPECT_NE(content.find("literal {} and missing {}"), std::string::npos);
+    EXPECT_NE(content.find("[WARN]"), std::string::npos);
+}
+
+TEST_F(LoggerTest, FlushWritesRecordsFromExitedThreads) {
+    auto& logger = Logger::instance();
+    logger.set_level(LogLevel::INFO);
+    logger.set_output_file(test_log_file_);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 250; ++i) {
+                LOG_INFO("thread {} message {}", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    logger.flush();
+
+    std::ifstream file(test_log_file_);
+    size_t lines = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        ++lines;
+    }
+    EXPECT_EQ(lines, 1000u);
+}
+
+TEST_F(LoggerTest, BinaryRoundTrip) {
+    auto& logger = Logger::instance();
+    logger.set_level(LogLevel::INFO);
+    logger.set_output_file(test_log_file_, LogFormat::Binary);
+
+    LOG_INFO("order {} qty {}", std::string_view("O-1"), 42u);
+    logger.log(LogLevel::ERROR, "runtime message", "file.cpp", 7);
+    logger.flush();
+    logger.set_output_file(test_log_file_ + ".txt");
+
+    std::ifstream in(test_log_file_, std::ios::binary);
+    std::ostringstream decoded;
+    ASSERT_TRUE(decode_binary_log(in, decoded));
+
+    const std::string text = decoded.str();
+    EXPECT_NE(text.find("[INFO]"), std::string::npos);
+    EXPECT_NE(text.find("order O-1 qty 42"), std::string::npos);
+    EXPECT_NE(text.find("[ERROR]"), std::string::npos);
+    EXPECT_NE(text.find("runtime message (file.cpp:7)"), std::string::npos);
+
+    std::filesystem::remove(test_log_file_ + ".txt");
+}
+
+TEST_F(LoggerTest, BinaryDecoderRejectsCorruptLengths) {
+    auto& logger = Logger::instance();
+    logger.set_level(LogLevel::INFO);
+    logger.set_output_file(test_log_file_, LogFormat::Binary);
+    LOG_INFO("order {}", std::string_view("O-1"));
+    logger.log(LogLevel::ERROR, "runtime message", "file.cpp", 7);
+    logger.flush();
+    logger.set_output_file(test_log_file_ + ".txt");
+
+    std::string good;
+    {
+        std::ifstream in(test_log_file_, std::ios::binary);
+        good.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto decodes = [](const std::string& bytes) {
+        std::istringstream in(bytes);
+        std::ostringstream out;
+        return decode_binary_log(in, out);
+    };
+    ASSERT_TRUE(decodes(good));
+
+    // A string length pointing past its record, in a static site's and in
+    // a runtime record's payload.
+    for (std::string_view text : {std::string_view("O-1"), std::string_view("runtime message")}) {
+        std::string corrupt = good;
+        const size_t pos = corrupt.find(text);
+        ASSERT_NE(pos, std::string::npos);
+        const uint32_t huge = 0x7fffffff;
+        std::memcpy(&corrupt[pos - sizeof(huge)], &huge, sizeof(huge));
+        EXPECT_FALSE(decodes(corrupt)) << text;
+    }
+
+    EXPECT_FALSE(decodes(good.substr(0, good.size() - 3)));
+    std::filesystem::remove(test_log_file_ + ".txt");
+}
+
+namespace {
+
+size_t count_lines(const std::string& path, const std::string& needle) {
+    std::ifstream file(path);
+    size_t lines = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.find(needle) != std::string::npos) {
+            ++lines;
+        }
+    }
+    return lines;
+}
+
+// Logs `count` records from a fresh thread so it gets a staging buffer with
+// the current size and backpressure settings.
+LogThreadStats log_burst(size_t count, const std::string& tag) {
+    LogThreadStats stats;
+    std::thread producer([&] {
+        for (size_t i = 0; i < count; ++i) {
+            LOG_WARN("{} burst {}", tag, i);
+        }
+        stats = Logger::instance().current_thread_stats();
+    });
+    producer.join();
+    return stats;
+}
+
+} // namespace
+
+TEST_F(LoggerTest, CharBufferIsCopiedNotUsedAsFormat) {
+    auto& logger = Logger::instance();
+    logger.set_level(LogLevel::INFO);
+    logger.set_output_file(test_log_file_);
+
+    // Two calls through one site; the buffer is rewritten before the
+    // background thread formats the first record.
+    char message[64];
+    for (int order = 1; order <= 2; ++order) {
+        std::snprintf(message, sizeof(message), "order %d", order);
+        LOG_INFO(message);
+    }
+    std::memset(message, 'x', sizeof(message) - 1);
+    message[sizeof(message) - 1] = '\0';
+    logger.flush();
+
+    EXPECT_EQ(count_lines(test_log_file_, "order 1"), 1u);
+    EXPECT_EQ(count_lines(test_log_file_, "order 2"), 1u);
+    EXPECT_EQ(count_lines(test_log_file_, "xxx"), 0u);
+}
+
+TEST_F(LoggerTest, BackpressureBlockKeepsEveryRecord) {
+    auto& logger = Logger::instance();
+    logger.set_level(LogLevel::INFO);
+    logger.set_output_file(test_log_file_);
+    logger.set_thread_buffer_size(4096);
+    logger.set_backpressure(LogBackpressure::Block);
+
+    LogThreadStats stats = log_burst(5000, "block");
+    logger.flush();
+    logger.set_thread_buffer_size(Logger::kDefaultThreadBufferSize);
+
+    EXPECT_EQ(stats.enqueued, 5000u);
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_EQ(stats.overwritten, 0u);
+    EXPECT_EQ(count_lines(test_log_file_, "block burst"), 5000u);
+}
+
+TEST_F(LoggerTest, BackpressureDropCountsDiscardedRecords) {
+    auto& logger = Logger::instance();
+    logger.set_level(LogLevel::INFO);
+    logger.set_output_file(test_log_file_);
+    logger.set_thread_buffer_size(4096);
+    logger.set_backpressure(LogBackpressure::Drop);
+
+    LogThreadStats stats = log_burst(5000, "drop");
+    logger.flush();
+    logger.set_thread_buffer_size(Logger::kDefaultThreadBufferSize);
+    logger.set_backpressure(LogBackpressure::Block);
+
+    EXPECT_EQ(stats.enqueued + stats.dropped, 5000u);
+    EXPECT_EQ(stats.blocked, 0u);
+    EXPECT_EQ(count_lines(test_log_file_, "drop burst"), stats.enqueued);
+}
+
+TEST_F(LoggerTest, BackpressureOverwriteEvictsOldest) {
+    auto& logger = Logger::instance();
+    logger.set_level(LogLevel::INFO);
+    logger.set_output_file(test_log_file_);
+    logger.set_thread_buffer_size(4096);
+    logger.set_backpressure(LogBackpressure::OverwriteOldest);
+
+    LogThreadStats stats = log_burst(5000, "overwrite");
+    logger.flush();
+    logger.set_thread_buffer_size(Logger::kDefaultThreadBufferSize);
+    logger.set_backpressure(LogBackpressure::Block);
+
+    EXPECT_EQ(stats.enqueued, 5000u);
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_EQ(count_lines(test_log_file_, "overwrite burst") + stats.overwritten, 5000u);
+
+    // Whatever survived must include the newest record.
+    EXPECT_EQ(count_lines(test_log_file_, "overwrite burst 4999 "), 1u);
+}
+
+TEST_F(LoggerTest, OversizedRecordIsDropped) {
+    auto& logger = Logger::instance();
+    logger.set_level(LogLevel::INFO);
+    logger.set_output_file(test_log_file_);
+    logger.set_thread_buffer_size(4096);
+
+    LogThreadStats stats;
+    std::thread producer([&] {
+        LOG_INFO("{}", std::string(4096, 'x'));
+        LOG_INFO("small");
+        stats = Logger::instance().current_thread_stats();
+    });
+    producer.join();
+    logger.flush();
+    logger.set_thread_buffer_size(Logger::kDefaultThreadBufferSize);
+
+    EXPECT_EQ(stats.dropped, 1u);
+    EXPECT_EQ(stats.enqueued, 1u);
+    EXPECT_EQ(count_lines(test_log_file_, "small"), 1u);
+
+}
+
+TEST_F(LoggerTest, ThreadStatsListsRegisteredThreads) {
+    auto& logger = Logger::instance();
+    logger.set_level(LogLevel::INFO);
+    logger.set_output_file(test_log_file_);
+
+    LOG_INFO("register main thread");
+    logger.flush();
+
+    const LogThreadStats mine = logger.current_thread_stats();
+    EXPECT_GT(mine.enqueued, 0u);
+    EXPECT_EQ(mine.pending_bytes, 0u);
+
+    bool found = false;
+    for (const auto& thread : logger.thread_stats()) {
+        found = found || thread.thread_label == mine.thread_label;
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST_F(LoggerTest, SinkBatchesUntilIntervalOrFlush) {
+    auto& logger = Logger::instance();
+    logger.set_level(LogLevel::INFO);
+    const LogSinkOptions defaults = logger.sink_options();
+
+    LogSinkOptions options;
+    options.flush_interval = std::chrono::hours(1);
+    options.fsync = true;
+    options.fsync_interval = std::chrono::milliseconds(5);
+    logger.set_sink_options(options);
+    logger.set_output_file(test_log_file_);
+
+    for (int i = 0; i < 100; ++i) {
+        LOG_INFO("batched {}", i);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(count_lines(test_log_file_, "batched"), 0u);
+
+    logger.flush();
+    EXPECT_EQ(count_lines(test_log_file_, "batched"), 100u);
+
+    logger.set_sink_options(defaults);
+    logger.set_output_file(test_log_file_);
+}
+
+TEST_F(LoggerTest, SinkWritesWhenBufferFills) {
+    auto& logger = Logger::instance();
+    logger.set_level(LogLevel::INFO);
+    const LogSinkOptions defaults = logger.sink_options();
+
+    LogSinkOptions options;
+    options.buffer_size = 4096;
+    options.flush_interval = std::chrono::hours(1);
+    logger.set_sink_options(options);
+    logger.set_output_file(test_log_file_);
+
+    for (int i = 0; i < 1000; ++i) {
+        LOG_INFO("spill {}", i);
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (count_lines(test_log_file_, "spill") == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_GT(count_lines(test_log_file_, "spill"), 0u);
+
+    logger.flush();
+    EXPECT_EQ(count_lines(test_log_file_, "spill"), 1000u);
+
+    logger.set_sink_options(defaults);
+    logger.set_output_file(test_log_file_);
+}
+
+namespace {
+
+std::vector<std::string> segment_files(const std::string& base) {
+    std::vector<std::string> files;
+    if (std::filesystem::exists(base)) {
+        files.push_back(base);
+    }
+    for (int i = 1; std::filesystem::exists(base + "." + std::to_string(i)); ++i) {
+        files.push_back(base + "." + std::to_string(i));
+    }
+    return files;
+}
+
+void remove_segments(const std::string& base) {
+    for (const auto& file : segment_files(base)) {
+        std::filesystem::remove(file);
+    }
+}
+
+} // namespace
+
+TEST_F(LoggerTest, MemoryMappedSinkTrimsToWrittenSize) {
+    auto& logger = Logger::instance();
+    logger.set_level(LogLevel::INFO);
+    const LogSinkOptions defaults = logger.sink_options();
+
+    LogSinkOptions options;
+    options.memory_mapped = true;
+    options.mmap_window_size = 64 * 1024;
+    logger.set_sink_options(options);
+    logger.set_output_file(test_log_file_);
+
+    for (int i = 0; i < 2000; ++i) {
+        LOG_INFO("mapped {}", i);
+    }
+    logger.flush();
+    EXPECT_EQ(count_lines(test_log_file_, "mapped"), 2000u);
+
+    logger.set_sink_options(defaults);
+    logger.set_output_file(test_log_file_ + ".next");
+
+    std::ifstream file(test_log_file_, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(content.find('\0'), std::string::npos);
+    EXPECT_EQ(content.back(), '\n');
+    std::filesystem::remove(test_log_file_ + ".next");
+}
+
+TEST_F(LoggerTest, SinkRotatesBySize) {
+    auto& logger = Logger::instance();
+    logger.set_level(LogLevel::INFO);
+    const LogSinkOptions defaults = logger.sink_options();
+
+    const std::string base = test_log_file_ + ".rot";
+    remove_segments(base);
+
+    for (bool mapped : {false, true}) {
+        LogSinkOptions options;
+        options.memory_mapped = mapped;
+        options.mmap_window_size = 64 * 1024;
+        options.rotate_size = 8 * 1024;
+        logger.set_sink_options(options);
+        logger.set_output_file(base);
+
+        for (int chunk = 0; chunk < 10; ++chunk) {
+            for (int i = 0; i < 100; ++i) {
+                LOG_INFO("rotate {} {}", chunk, i);
+            }
+            logger.flush();
+        }
+        logger.set_output_file(test_log_file_);
+
+        const auto files = segment_files(base);
+        EXPECT_GT(files.size(), 2u) << "mapped=" << mapped;
+        size_t total = 0;
+        for (const auto& file : files) {
+            total += count_lines(file, "rotate");
+        }
+        EXPECT_EQ(total, 1000u) << "mapped=" << mapped;
+        remove_segments(base);
+    }
+
+    logger.set_sink_options(defaults);
+    logger.set_output_file(test_log_file_);
+}
+
+TEST_F(LoggerTest, BinarySegmentsDecodeIndependently) {
+    auto& logger = Logger::instance();
+    logger.set_level(LogLevel::INFO);
+    const LogSinkOptions defaults = logger.sink_options();
+
+    const std::string base = test_log_file_ + ".bin";
+    remove_segments(base);
+
+    LogSinkOptions options;
+    options.memory_mapped = true;
+    options.mmap_window_size = 64 * 1024;
+    options.rotate_size = 4 * 1024;
+    logger.set_sink_options(options);
+    logger.set_output_file(base, LogFormat::Binary);
+
+    for (int chunk = 0; chunk < 5; ++chunk) {
+        for (int i = 0; i < 100; ++i) {
+            LOG_INFO("segment {} {}", chunk, i);
+        }
+        logger.flush();
+    }
+    logger.set_sink_options(defaults);
+    logger.set_output_file(test_log_file_);
+
+    const auto files = segment_files(base);
+    EXPECT_GT(files.size(), 1u);
+    size_t total = 0;
+    for (const auto& file : files) {
+        std::ifstream in(file, std::ios::binary);
+        std::ostringstream decoded;
+        EXPECT_TRUE(decode_binary_log(in, decoded)) << file;
+        const std::string text = decoded.str();
+        for (size_t pos = text.find("segment "); pos != std::string::npos; pos = text.find("segment ", pos + 1)) {
+            ++total;
+        }
+    }
+    EXPECT_EQ(total, 500u);
+    remove_segments(base);
+}
+
+TEST_F(LoggerTest, IndependentLoggerFollowsThreadBinding) {
+    auto& global = Logger::instance();
+    global.set_level(LogLevel::TRACE);
+    global.set_output_file(test_log_file_);
+    const std::string local_file = test_log_file_ + ".local";
+
+    {
+        Logger local;
+        local.set_level(LogLevel::TRACE);
+        local.set_output_file(local_file);
+        {
+            ThreadBinding<Logger> bind(local);
+            LOG_INFO("bound {}", 1);
+            std::thread([] { LOG_INFO("unbound thread"); }).join();
+        }
+        LOG_INFO("default again");
+        EXPECT_EQ(local.current_thread_stats().enqueued, 1u);
+        local.flush();
+        global.flush();
+    }
+
+    auto read = [](const std::string& path) {
+        std::ifstream file(path);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    };
+    const std::string local_text = read(local_file);
+    const std::string global_text = read(test_log_file_);
+    EXPECT_NE(local_text.find("bound 1"), std::string::npos);
+    EXPECT_EQ(local_text.find("default again"), std::string::npos);
+    EXPECT_NE(global_text.find("default again"), std::string::npos);
+    EXPECT_NE(global_text.find("unbound thread"), std::string::npos);
+    EXPECT_EQ(global_text.find("bound 1"), std::string::npos);
+    std::filesystem::remove(local_file);
+
+    // The thread keeps logging to the default after the local one is gone.
+    LOG_INFO("after destruction");
+    global.flush();
+    EXPECT_NE(read(test_log_file_).find("after destruction"), std::string::npos);
+}
@@ -1,5 +1,11 @@
 #include <gtest/gtest.h>
 #include "hft_core/MemoryPool.hpp"
+#include "hft_core/RingBuffer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory_resource>
+#include <thread>
 #include <vector>
 
 using namespace hft::core;
@@ -105,4 +111,242 @@ TEST_F(MemoryPoolTest, LockFreeMemoryPool) {
     
     lock_free_pool.deallocate(obj1);
     lock_free_pool.deallocate(obj2);
-}
\ No newline at end of file
+}
+
+TEST_F(MemoryPoolTest, LockFreePoolReusesFreedNodes) {
+    LockFreeMemoryPool<TestObject> lock_free_pool(64);
+    const size_t capacity = lock_free_pool.capacity();
+
+    for (int round = 0; round < 100; ++round) {
+        std::vector<TestObject*> objects;
+        for (int i = 0; i < 48; ++i) {
+            objects.push_back(lock_free_pool.allocate());
+        }
+        for (auto* obj : objects) {
+            lock_free_pool.deallocate(obj);
+        }
+    }
+
+    EXPECT_EQ(lock_free_pool.heap_allocations(), 0u);
+    EXPECT_EQ(lock_free_pool.capacity(), capacity);
+}
+
+TEST_F(MemoryPoolTest, LockFreePoolGrowsWhenExhausted) {
+    LockFreeMemoryPool<TestObject> lock_free_pool(8);
+
+    std::vector<TestObject*> objects;
+    for (int i = 0; i < 200; ++i) {
+        objects.push_back(lock_free_pool.allocate());
+    }
+    std::sort(objects.begin(), objects.end());
+    EXPECT_EQ(std::unique(objects.begin(), objects.end()), objects.end());
+    EXPECT_GT(lock_free_pool.heap_allocations(), 0u);
+    EXPECT_GE(lock_free_pool.capacity(), 200u);
+
+    for (auto* obj : objects) {
+        lock_free_pool.deallocate(obj);
+    }
+}
+
+TEST_F(MemoryPoolTest, LockFreePoolCrossThreadFree) {
+    LockFreeMemoryPool<TestObject> lock_free_pool(1024);
+    SPSCRingBuffer<TestObject*> handoff(256);
+    constexpr int kCount = 20000;
+
+    std::thread gateway([&] {
+        for (int i = 0; i < kCount; ++i) {
+            TestObject* obj = lock_free_pool.allocate();
+            new (obj) TestObject(i, i * 0.5);
+            while (!handoff.try_push(obj)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::thread strategy([&] {
+        int expected = 0;
+        while (expected < kCount) {
+            TestObject* obj = nullptr;
+            if (!handoff.try_pop(obj)) {
+                std::this_thread::yield();
+                continue;
+            }
+            EXPECT_EQ(obj->value, expected);
+            obj->~TestObject();
+            lock_free_pool.deallocate(obj);
+            ++expected;
+        }
+    });
+
+    gateway.join();
+    strategy.join();
+
+    // Freed nodes flow back through the depot, so the pool never grows.
+    EXPECT_EQ(lock_free_pool.heap_allocations(), 0u);
+}
+
+TEST_F(MemoryPoolTest, LockFreePoolConcurrentChurn) {
+    LockFreeMemoryPool<TestObject> lock_free_pool(256);
+    std::atomic<bool> failed{false};
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            std::vector<TestObject*> held;
+            for (int i = 0; i < 20000; ++i) {
+                if (held.size() < 40 && (i % 3 != 0 || held.empty())) {
+                    TestObject* obj = lock_free_pool.allocate();
+                    obj->value = t;
+                    held.push_back(obj);
+                } else {
+                    TestObject* obj = held.back();
+                    held.pop_back();
+                    if (obj->value != t) {
+                        failed = true;
+                    }
+                    lock_free_pool.deallocate(obj);
+                }
+                if (i % 512 == 0) {
+                    std::this_thread::yield();
+                }
+            }
+            for (auto* obj : held) {
+                lock_free_pool.deallocate(obj);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_FALSE(failed.load());
+}
+
+TEST_F(MemoryPoolTest, InitialBlocksArePreallocated) {
+    MemoryPool<TestObject> one_block(1);
+    MemoryPool<TestObject> many_blocks(16);
+
+    EXPECT_GE(many_blocks.capacity(), 15 * one_block.capacity());
+    EXPECT_EQ(many_blocks.available(), many_blocks.capacity());
+
+    // Preallocated slots are handed out contiguously, in address order.
+    TestObject* first = many_blocks.allocate();
+    TestObject* second = many_blocks.allocate();
+    EXPECT_EQ(reinterpret_cast<char*>(second) - reinterpret_cast<char*>(first),
+              static_cast<std::ptrdiff_t>(sizeof(TestObject)));
+
+    const size_t capacity = many_blocks.capacity();
+    std::vector<TestObject*> objects{first, second};
+    while (objects.size() < capacity) {
+        objects.push_back(many_blocks.allocate());
+    }
+    EXPECT_EQ(many_blocks.capacity(), capacity);
+    EXPECT_EQ(many_blocks.available(), 0u);
+
+    for (auto* obj : objects) {
+        many_blocks.deallocate(obj);
+    }
+}
+
+TEST_F(MemoryPoolTest, FreedSlotIsReusedFirst) {
+    TestObject* a = pool_->allocate();
+    pool_->deallocate(a);
+    EXPECT_EQ(pool_->allocate(), a);
+    pool_->deallocate(a);
+}
+
+TEST_F(MemoryPoolTest, HugePageBackedPool) {
+    MemoryPoolOptions options;
+    options.huge_pages = true;
+    options.prefault = true;
+    options.lock_memory = true;
+
+    // Works whether or not the OS grants huge pages or the mlock.
+    MemoryPool<TestObject> huge_pool(4, options);
+    EXPECT_GE(huge_pool.capacity() * sizeof(TestObject), 4096u * 4 - 64);
+
+    std::vector<TestObject*> objects;
+    for (int i = 0; i < 1000; ++i) {
+        objects.push_back(huge_pool.construct(i, i * 1.5));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(objects[i]->value, i);
+    }
+    for (auto* obj : objects) {
+        huge_pool.destroy(obj);
+    }
+    EXPECT_EQ(huge_pool.available(), huge_pool.capacity());
+}
+
+TEST_F(MemoryPoolTest, ArenaBumpAllocationAndReset) {
+    Arena arena(1024);
+
+    auto* first = arena.create<TestObject>(1, 1.0);
+    auto* second = arena.create<TestObject>(2, 2.0);
+    EXPECT_EQ(first->value, 1);
+    EXPECT_EQ(second->value, 2);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % alignof(TestObject), 0u);
+    EXPECT_GT(second, first);
+
+    // Fill several blocks, including one oversized request.
+    for (int i = 0; i < 200; ++i) {
+        arena.allocate_bytes(24);
+    }
+    arena.allocate_bytes(4096);
+    const size_t capacity = arena.capacity();
+    EXPECT_GE(capacity, 200u * 24 + 4096);
+
+    arena.reset();
+    EXPECT_EQ(arena.create<TestObject>(3, 3.0), first);
+
+    // Warm arena: the same workload reuses the retained blocks.
+    for (int round = 0; round < 10; ++round) {
+        arena.reset();
+        for (int i = 0; i < 200; ++i) {
+            arena.allocate_bytes(24);
+        }
+        arena.allocate_bytes(4096);
+    }
+    EXPECT_EQ(arena.capacity(), capacity);
+}
+
+TEST_F(MemoryPoolTest, ArenaAlignmentAndPmr) {
+    Arena arena;
+    arena.allocate_bytes(1, 1);
+    void* wide = arena.allocate_bytes(32, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(wide) % 64, 0u);
+
+    std::pmr::vector<int> values(&arena);
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i);
+    }
+    EXPECT_EQ(values[999], 999);
+}
+
+TEST_F(MemoryPoolTest, ArenaScopesNest) {
+    EXPECT_EQ(Arena::current(), nullptr);
+    {
+        ArenaScope outer;
+        Arena* arena = Arena::current();
+        ASSERT_EQ(arena, &Arena::thread_local_instance());
+
+        char* kept = static_cast<char*>(arena->allocate_bytes(16));
+        char* inner_first = nullptr;
+        {
+            ArenaScope inner;
+            EXPECT_EQ(Arena::current(), arena);
+            inner_first = static_cast<char*>(arena->allocate_bytes(16));
+            EXPECT_NE(inner_first, kept);
+        }
+        // The inner scope released only its own allocations.
+        EXPECT_EQ(static_cast<char*>(arena->allocate_bytes(16)), inner_first);
+
+        Arena local(256);
+        {
+            ArenaScope scoped(local);
+            EXPECT_EQ(Arena::current(), &local);
+        }
+        EXPECT_EQ(Arena::current(), arena);
+    }
+    EXPECT_EQ(Arena::current(), nullptr);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "hft_core/Parallel.hpp"
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace hft::core;
+
+class ParallelTest : public ::testing::TestWithParam<SchedulingMode> {
+protected:
+    ThreadPool pool_{3, GetParam()};
+};
+
+TEST_P(ParallelTest, ForVisitsEveryIndexOnce) {
+    std::vector<std::atomic<int>> hits(10007);
+    parallel_for(pool_, 0, hits.size(), 16, [&](size_t i) { hits[i].fetch_add(1); });
+    for (size_t i = 0; i < hits.size(); ++i) {
+        ASSERT_EQ(hits[i].load(), 1) << "index " << i;
+    }
+
+    // Automatic grain and an offset range
+    std::atomic<size_t> sum{0};
+    parallel_for(pool_, 100, 200, [&](size_t i) { sum.fetch_add(i); });
+    EXPECT_EQ(sum.load(), (100u + 199u) * 100u / 2);
+
+    parallel_for(pool_, 5, 5, [&](size_t) { FAIL(); });
+}
+
+TEST_P(ParallelTest, ReduceIsDeterministic) {
+    const double total = parallel_reduce(pool_, 0, 100000, 0, 0.0,
+                                         [](size_t i) { return 1.0 / (1.0 + i); },
+                                         [](double a, double b) { return a + b; });
+    double expected = 0.0;
+    const size_t step = 100000 / (8 * (pool_.size() + 1));
+    for (size_t first = 0; first < 100000; first += step) {
+        double chunk = 0.0;
+        for (size_t i = first; i < std::min<size_t>(first + step, 100000); ++i) {
+            chunk += 1.0 / (1.0 + i);
+        }
+        expected += chunk;
+    }
+    EXPECT_EQ(total, expected);
+
+    // Non-commutative combine keeps index order
+    const std::string text = parallel_reduce(pool_, 0, 26, 3, std::string(),
+                                             [](size_t i) { return std::string(1, char('a' + i)); },
+                                             [](std::string a, const std::string& b) { return a + b; });
+    EXPECT_EQ(text, "abcdefghijklmnopqrstuvwxyz");
+}
+
+TEST_P(ParallelTest, TransformWritesOutput) {
+    std::vector<int> input(5000);
+    std::iota(input.begin(), input.end(), 0);
+    std::vector<long> output(input.size());
+
+    auto end = parallel_transform(pool_, input.begin(), input.end(), output.begin(), 64,
+                                  [](int x) { return static_cast<long>(x) * x; });
+    EXPECT_EQ(end, output.end());
+    for (size_t i = 0; i < input.size(); ++i) {
+        ASSERT_EQ(output[i], static_cast<long>(i) * static_cast<long>(i));
+    }
+}
+
+TEST_P(ParallelTest, NestedInsideWorkersDoesNotDeadlock) {
+    std::atomic<int> leaves{0};
+    auto outer = pool_.enqueue([&] {
+        parallel_for(pool_, 0, 8, 1, [&](size_t) {
+            parallel_for(pool_, 0, 100, 10, [&](size_t) { leaves.fetch_add(1); });
+        });
+    });
+    outer.get();
+    EXPECT_EQ(leaves.load(), 800);
+}
+
+TEST_P(ParallelTest, RethrowsFirstException) {
+    std::atomic<int> visited{0};
+    EXPECT_THROW(parallel_for(pool_, 0, 1000, 10, [&](size_t i) {
+        visited.fetch_add(1);
+        if (i == 500) {
+            throw std::runtime_error("bad instrument");
+        }
+    }), std::runtime_error);
+    EXPECT_LE(visited.load(), 1000);
+
+    // The pool is still usable afterwards.
+    EXPECT_EQ(pool_.enqueue([] { return 1; }).get(), 1);
+}
+
+INSTANTIATE_TEST_SUITE_P(Modes, ParallelTest,
+                         ::testing::Values(SchedulingMode::SharedQueue, SchedulingMode::WorkStealing));
+
+TEST(ParallelEmptyPoolTest, CallerDoesAllTheWork) {
+    ThreadPool pool(0);
+    std::vector<int> hits(100);
+    parallel_for(pool, 0, hits.size(), 7, [&](size_t i) { ++hits[i]; });
+    EXPECT_EQ(std::accumulate(hits.begin(), hits.end(), 0), 100);
+}
@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+#include "hft_core/Pipeline.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+
+using namespace hft::core;
+
+namespace {
+
+// Source producing 1..count, one item per call.
+Pipeline<uint64_t>::SourceFn counting_source(uint64_t count) {
+    auto next = std::make_shared<uint64_t>(0);
+    return [next, count](uint64_t& out) {
+        if (*next == count) {
+            return false;
+        }
+        out = ++*next;
+        return true;
+    };
+}
+
+} // namespace
+
+TEST(PipelineTest, LinearStagesTransformAndFilter) {
+    Pipeline<uint64_t> pipeline;
+    std::atomic<uint64_t> sum{0};
+
+    auto feed = pipeline.add_source("feed", counting_source(10000));
+    auto normalize = pipeline.add_stage("normalize", [](uint64_t& x) {
+        x *= 2;
+        return true;
+    }, {feed});
+    auto signal = pipeline.add_stage("signal", [](uint64_t& x) { return x % 3 == 0; }, {normalize});
+    auto orders = pipeline.add_stage("orders", [&sum](uint64_t& x) {
+        sum.fetch_add(x, std::memory_order_relaxed);
+        return true;
+    }, {signal});
+
+    pipeline.start();
+    pipeline.wait();
+
+    uint64_t expected = 0;
+    for (uint64_t i = 1; i <= 10000; ++i) {
+        if ((2 * i) % 3 == 0) {
+            expected += 2 * i;
+        }
+    }
+    EXPECT_EQ(sum.load(), expected);
+    EXPECT_EQ(pipeline.stats(feed).processed, 10000u);
+    EXPECT_EQ(pipeline.stats(signal).processed, 10000u);
+    EXPECT_EQ(pipeline.stats(signal).filtered, 10000u - 3333u);
+    EXPECT_EQ(pipeline.stats(orders).processed, 3333u);
+    EXPECT_EQ(pipeline.stats(orders).name, "orders");
+    EXPECT_GT(pipeline.stats(normalize).throughput(), 0.0);
+}
+
+TEST(PipelineTest, DiamondFanOutAndFanIn) {
+    Pipeline<uint64_t> pipeline;
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+
+    auto feed = pipeline.add_source("feed", counting_source(5000));
+    auto book = pipeline.add_stage("book", [](uint64_t&) { return true; }, {feed});
+    auto risk = pipeline.add_stage("risk", [](uint64_t& x) {
+        x += 1000000;
+        return true;
+    }, {feed});
+    pipeline.add_stage("merge", [&](uint64_t& x) {
+        count.fetch_add(1);
+        sum.fetch_add(x);
+        return true;
+    }, {book, risk});
+
+    pipeline.start();
+    pipeline.wait();
+
+    EXPECT_EQ(count.load(), 10000u);
+    EXPECT_EQ(sum.load(), 2 * (5000ull * 5001ull / 2) + 5000ull * 1000000ull);
+}
+
+TEST(PipelineTest, SlowStagePushesBack) {
+    Pipeline<uint64_t> pipeline;
+    std::atomic<uint64_t> seen{0};
+
+    StageOptions small;
+    small.queue_capacity = 4;
+    auto feed = pipeline.add_source("feed", counting_source(200));
+    pipeline.add_stage("slow", [&seen](uint64_t&) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        seen.fetch_add(1);
+        return true;
+    }, {feed}, small);
+
+    pipeline.start();
+    pipeline.wait();
+
+    EXPECT_EQ(seen.load(), 200u);
+    EXPECT_GT(pipeline.stats(feed).backpressure, 0u);
+    EXPECT_GE(pipeline.stats(1).latency_quantile(0.5), 50000u / 2);
+}
+
+TEST(PipelineTest, StagesCanRunOnHighPriorityPool) {
+    HighPriorityPoolOptions pool_options;
+    pool_options.realtime = false;
+    HighPriorityThreadPool pool(2, {}, pool_options);
+
+    Pipeline<uint64_t> pipeline;
+    std::atomic<uint64_t> sum{0};
+    StageOptions on_pool;
+    on_pool.pool = &pool;
+
+    auto feed = pipeline.add_source("feed", counting_source(1000), on_pool);
+    pipeline.add_stage("sink", [&sum](uint64_t& x) {
+        sum.fetch_add(x);
+        return true;
+    }, {feed}, on_pool);
+
+    pipeline.start();
+    pipeline.wait();
+    EXPECT_EQ(sum.load(), 1000u * 1001u / 2);
+}
+
+TEST(PipelineTest, RejectsMoreStagesThanPoolWorkers) {
+    HighPriorityPoolOptions pool_options;
+    pool_options.realtime = false;
+    HighPriorityThreadPool pool(1, {}, pool_options);
+
+    Pipeline<uint64_t> pipeline;
+    StageOptions on_pool;
+    on_pool.pool = &pool;
+    auto feed = pipeline.add_source("feed", counting_source(10), on_pool);
+    pipeline.add_stage("sink", [](uint64_t&) { return true; }, {feed}, on_pool);
+
+    EXPECT_THROW(pipeline.start(), std::logic_error);
+}
+
+TEST(PipelineTest, RejectsCollidingOrInvalidPoolWorkers) {
+    HighPriorityPoolOptions pool_options;
+    pool_options.realtime = false;
+    HighPriorityThreadPool pool(2, {}, pool_options);
+
+    Pipeline<uint64_t> pipeline;
+    StageOptions pinned;
+    pinned.pool = &pool;
+    pinned.pool_worker = 1;
+    auto feed = pipeline.add_source("feed", counting_source(10), pinned);
+    pipeline.add_stage("sink", [](uint64_t&) { return true; }, {feed}, pinned);
+    EXPECT_THROW(pipeline.start(), std::logic_error);
+
+    Pipeline<uint64_t> other;
+    pinned.pool_worker = 2;
+    EXPECT_THROW(other.add_source("feed", counting_source(10), pinned), std::invalid_argument);
+}
+
+TEST(PipelineTest, PinnedPoolStageRunsOnItsWorker) {
+    HighPriorityPoolOptions pool_options;
+    pool_options.realtime = false;
+    HighPriorityThreadPool pool(2, {}, pool_options);
+
+    std::thread::id worker_thread;
+    std::atomic<bool> seen{false};
+    pool.post_to_worker(1, [&] {
+        worker_thread = std::this_thread::get_id();
+        seen.store(true);
+    });
+    while (!seen.load()) {
+        std::this_thread::yield();
+    }
+
+    Pipeline<uint64_t> pipeline;
+    std::atomic<uint64_t> sum{0};
+    std::atomic<bool> on_worker{true};
+    StageOptions pinned;
+    pinned.pool = &pool;
+    pinned.pool_worker = 1;
+    StageOptions any;
+    any.pool = &pool;
+
+    auto feed = pipeline.add_source("feed", counting_source(100), any);
+    pipeline.add_stage("sink", [&](uint64_t& x) {
+        if (std::this_thread::get_id() != worker_thread) {
+            on_worker.store(false);
+        }
+        sum.fetch_add(x);
+        return true;
+    }, {feed}, pinned);
+
+    pipeline.start();
+    pipeline.wait();
+    EXPECT_EQ(sum.load(), 100u * 101u / 2);
+    EXPECT_TRUE(on_worker.load());
+}
+
+TEST(PipelineTest, StopEndsEndlessSource) {
+    Pipeline<uint64_t> pipeline;
+    auto feed = pipeline.add_source("ticks", [](uint64_t& out) {
+        out = 1;
+        return true;
+    });
+    pipeline.add_stage("sink", [](uint64_t&) { return true; }, {feed});
+
+    pipeline.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    pipeline.stop();
+    pipeline.wait();
+    EXPECT_GT(pipeline.stats(feed).processed, 0u);
+}
+
+TEST(PipelineTest, RejectsUnknownUpstream) {
+    Pipeline<uint64_t> pipeline;
+    EXPECT_THROW(pipeline.add_stage("orphan", [](uint64_t&) { return true; }, {3}),
+                 std::invalid_argument);
+    EXPECT_THROW(pipeline.add_stage("rootless", [](uint64_t&) { return true; }, {}),
+                 std::invalid_argument);
+}
@@ -0,0 +1,241 @@
+#include <gtest/gtest.h>
+#include "hft_core/RingBuffer.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hft::core;
+
+TEST(RingBufferTest, CapacityRoundsUpToPowerOfTwo) {
+    SPSCRingBuffer<int> spsc(100);
+    MPSCRingBuffer<int> mpsc(5);
+
+    EXPECT_EQ(spsc.capacity(), 128);
+    EXPECT_EQ(mpsc.capacity(), 8);
+}
+
+TEST(RingBufferTest, SPSCPushPopAndFull) {
+    SPSCRingBuffer<int> ring(4);
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.try_push(i));
+    }
+    EXPECT_FALSE(ring.try_push(99));
+    EXPECT_EQ(ring.size(), 4);
+
+    int value = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.try_pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(ring.try_pop(value));
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(RingBufferTest, ConsumeInPlaceDestroysElement) {
+    SPSCRingBuffer<std::string> ring(2);
+    ASSERT_TRUE(ring.try_emplace(64, 'x'));
+
+    size_t seen = 0;
+    EXPECT_TRUE(ring.consume_one([&seen](std::string& s) { seen = s.size(); }));
+    EXPECT_EQ(seen, 64);
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(RingBufferTest, SPSCCrossThreadOrdering) {
+    SPSCRingBuffer<int> ring(64);
+    constexpr int kCount = 100000;
+
+    std::thread producer([&ring] {
+        for (int i = 0; i < kCount; ++i) {
+            while (!ring.try_push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    while (expected < kCount) {
+        int value;
+        if (ring.try_pop(value)) {
+            ASSERT_EQ(value, expected);
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+}
+
+TEST(RingBufferTest, MPSCMultipleProducers) {
+    MPSCRingBuffer<int> ring(128);
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 20000;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&ring, p] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                while (!ring.try_push(p * kPerProducer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> last_seen(kProducers, -1);
+    int received = 0;
+    while (received < kProducers * kPerProducer) {
+        int value;
+        if (ring.try_pop(value)) {
+            int producer = value / kPerProducer;
+            ASSERT_GT(value, last_seen[producer]);
+            last_seen[producer] = value;
+            ++received;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    for (auto& t : producers) {
+        t.join();
+    }
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(RingBufferTest, WaiterWakesParkedConsumer) {
+    Waiter waiter(WaitStrategy::Block, 16);
+    std::atomic<bool> ready{false};
+
+    std::thread consumer([&] {
+        waiter.wait([&ready] { return ready.load(); });
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ready.store(true);
+    waiter.notify();
+    consumer.join();
+
+    EXPECT_TRUE(ready.load());
+}
+
+TEST(RingBufferTest, WorkStealingDequeOwnerLifoThiefFifo) {
+    WorkStealingDeque<int> deque(2);
+    for (int i = 0; i < 10; ++i) {
+        deque.push(i);
+    }
+    EXPECT_EQ(deque.size(), 10u);
+    EXPECT_GE(deque.capacity(), 16u);
+
+    int value = -1;
+    ASSERT_TRUE(deque.steal(value));
+    EXPECT_EQ(value, 0);
+    ASSERT_TRUE(deque.pop(value));
+    EXPECT_EQ(value, 9);
+
+    size_t remaining = 0;
+    while (deque.pop(value)) {
+        ++remaining;
+    }
+    EXPECT_EQ(remaining, 8u);
+    EXPECT_TRUE(deque.empty());
+    EXPECT_FALSE(deque.steal(value));
+}
+
+TEST(RingBufferTest, WorkStealingDequeConcurrentThieves) {
+    constexpr int kItems = 100000;
+    WorkStealingDeque<int> deque(64);
+    std::vector<std::atomic<int>> seen(kItems);
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; ++t) {
+        thieves.emplace_back([&] {
+            int value;
+            while (!done.load(std::memory_order_acquire) || !deque.empty()) {
+                if (deque.steal(value)) {
+                    seen[value].fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    int value;
+    for (int i = 0; i < kItems; ++i) {
+        deque.push(i);
+        if (i % 3 == 0 && deque.pop(value)) {
+            seen[value].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    while (deque.pop(value)) {
+        seen[value].fetch_add(1, std::memory_order_relaxed);
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+
+    for (int i = 0; i < kItems; ++i) {
+        ASSERT_EQ(seen[i].load(), 1) << "item " << i;
+    }
+}
+
+TEST(RingBufferTest, MPMCMultipleProducersAndConsumers) {
+    constexpr int kProducers = 3;
+    constexpr int kPerProducer = 20000;
+    MPMCRingBuffer<int> ring(256);
+    std::vector<std::atomic<int>> seen(kProducers * kPerProducer);
+    std::atomic<int> consumed{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < kProducers; ++p) {
+        threads.emplace_back([&ring, p] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                while (!ring.try_push(p * kPerProducer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < 2; ++c) {
+        threads.emplace_back([&] {
+            int value;
+            while (consumed.load() < kProducers * kPerProducer) {
+                if (ring.try_pop(value)) {
+                    seen[value].fetch_add(1);
+                    consumed.fetch_add(1);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_TRUE(ring.empty());
+    for (int i = 0; i < kProducers * kPerProducer; ++i) {
+        ASSERT_EQ(seen[i].load(), 1) << "item " << i;
+    }
+}
+
+TEST(RingBufferTest, MPMCFullAndDestroysLeftovers) {
+    auto tracker = std::make_shared<int>(0);
+    {
+        MPMCRingBuffer<std::shared_ptr<int>> ring(2);
+        EXPECT_TRUE(ring.try_push(tracker));
+        EXPECT_TRUE(ring.try_push(tracker));
+        EXPECT_FALSE(ring.try_push(tracker));
+        EXPECT_EQ(tracker.use_count(), 3);
+
+        std::shared_ptr<int> out;
+        EXPECT_TRUE(ring.try_pop(out));
+        EXPECT_EQ(out, tracker);
+    }
+    EXPECT_EQ(tracker.use_count(), 1);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "hft_core/SlabAllocator.hpp"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace hft::core;
+
+TEST(SlabAllocatorTest, SizeClasses) {
+    EXPECT_EQ(SlabAllocator::class_index(1, 1), 0u);
+    EXPECT_EQ(SlabAllocator::class_index(8, 8), 0u);
+    EXPECT_EQ(SlabAllocator::class_index(9, 8), 1u);
+    EXPECT_EQ(SlabAllocator::class_index(4, 32), 2u);
+    EXPECT_EQ(SlabAllocator::class_index(4096, 8), SlabAllocator::kClassCount - 1);
+    EXPECT_EQ(SlabAllocator::class_index(4097, 8), SlabAllocator::kClassCount);
+    EXPECT_EQ(SlabAllocator::class_index(16, 128), SlabAllocator::kClassCount);
+}
+
+TEST(SlabAllocatorTest, BlocksAreAlignedAndRecycled) {
+    SlabAllocator slab;
+
+    void* a = slab.allocate(24, 8);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % 32, 0u);
+    slab.deallocate(a, 24, 8);
+    EXPECT_EQ(slab.allocate(24, 8), a);
+    slab.deallocate(a, 24, 8);
+
+    void* wide = slab.allocate(8, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(wide) % 64, 0u);
+    slab.deallocate(wide, 8, 64);
+
+    void* big = slab.allocate(10000, 8);
+    EXPECT_EQ(slab.upstream_allocations(), 1u);
+    slab.deallocate(big, 10000, 8);
+}
+
+TEST(SlabAllocatorTest, HighWaterMarkStats) {
+    SlabAllocator slab;
+    const size_t index = SlabAllocator::class_index(64, 8);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 100; ++i) {
+        blocks.push_back(slab.allocate(64, 8));
+    }
+    for (int i = 0; i < 60; ++i) {
+        slab.deallocate(blocks.back(), 64, 8);
+        blocks.pop_back();
+    }
+
+    SlabClassStats stats = slab.class_stats(index);
+    EXPECT_EQ(stats.block_size, 64u);
+    EXPECT_EQ(stats.in_use, 40u);
+    EXPECT_EQ(stats.high_water, 100u);
+    EXPECT_GE(stats.capacity, 100u);
+    EXPECT_EQ(slab.stats()[index].high_water, 100u);
+
+    for (void* block : blocks) {
+        slab.deallocate(block, 64, 8);
+    }
+    EXPECT_EQ(slab.class_stats(index).in_use, 0u);
+}
+
+TEST(SlabAllocatorTest, PmrContainersReachSteadyState) {
+    SlabAllocator slab;
+    std::pmr::unordered_map<int, std::pmr::string> orders(&slab);
+
+    auto churn = [&] {
+        for (int i = 0; i < 500; ++i) {
+            orders.emplace(i, std::pmr::string("order-with-a-long-client-id-", &slab));
+        }
+        orders.clear();
+    };
+
+    churn();
+    const size_t upstream_after_warmup = slab.upstream_allocations();
+    std::vector<size_t> capacity_after_warmup;
+    for (const auto& stats : slab.stats()) {
+        capacity_after_warmup.push_back(stats.capacity);
+    }
+
+    for (int round = 0; round < 5; ++round) {
+        churn();
+    }
+    for (size_t i = 0; i < SlabAllocator::kClassCount; ++i) {
+        EXPECT_EQ(slab.class_stats(i).capacity, capacity_after_warmup[i]) << "class " << i;
+    }
+    EXPECT_EQ(slab.upstream_allocations(), upstream_after_warmup);
+}
+
+TEST(SlabAllocatorTest, StlAllocatorAdapter) {
+    SlabAllocator slab;
+    slab.reserve(sizeof(std::pair<const int, double>) + 32, 256);
+
+    using MapAllocator = SlabStlAllocator<std::pair<const int, double>>;
+    std::map<int, double, std::less<int>, MapAllocator> book{MapAllocator(slab)};
+    for (int i = 0; i < 200; ++i) {
+        book[i] = i * 0.5;
+    }
+    EXPECT_EQ(book.size(), 200u);
+    EXPECT_DOUBLE_EQ(book[100], 50.0);
+
+    std::vector<int, SlabStlAllocator<int>> fills{SlabStlAllocator<int>(slab)};
+    for (int i = 0; i < 100; ++i) {
+        fills.push_back(i);
+    }
+    EXPECT_EQ(fills[99], 99);
+
+    EXPECT_TRUE(SlabStlAllocator<int>(slab) == MapAllocator(slab));
+    SlabAllocator other;
+    EXPECT_TRUE(SlabStlAllocator<int>(slab) != SlabStlAllocator<int>(other));
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "hft_core/StaticEventBus.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace hft::core;
+
+struct PriceTick {
+    int instrument;
+    double price;
+};
+
+struct OrderAck {
+    long order_id;
+};
+
+using TestBus = StaticEventBus<PriceTick, OrderAck>;
+
+namespace {
+
+void count_tick(void* context, const PriceTick& tick) {
+    static_cast<std::atomic<int>*>(context)->fetch_add(tick.instrument);
+}
+
+struct Strategy {
+    void on_tick(const PriceTick& tick) { last_price = tick.price; }
+    void on_ack(const OrderAck& ack) { last_order = ack.order_id; }
+
+    double last_price = 0.0;
+    long last_order = 0;
+};
+
+} // namespace
+
+TEST(StaticEventBusTest, SlotIndicesAreCompileTime) {
+    static_assert(TestBus::slot_index<PriceTick> == 0);
+    static_assert(TestBus::slot_index<OrderAck> == 1);
+}
+
+TEST(StaticEventBusTest, FunctionPointerHandler) {
+    TestBus bus;
+    std::atomic<int> total{0};
+
+    bus.subscribe<PriceTick>(&count_tick, &total);
+    bus.publish(PriceTick{5, 1.0});
+    bus.emit<PriceTick>(PriceTick{7, 2.0});
+
+    EXPECT_EQ(total.load(), 12);
+    EXPECT_EQ(bus.handler_count<PriceTick>(), 1);
+    EXPECT_EQ(bus.handler_count<OrderAck>(), 0);
+}
+
+TEST(StaticEventBusTest, MemberFunctionHandlers) {
+    TestBus bus;
+    Strategy strategy;
+
+    bus.subscribe<PriceTick, &Strategy::on_tick>(&strategy);
+    bus.subscribe<OrderAck, &Strategy::on_ack>(&strategy);
+
+    bus.publish(PriceTick{1, 101.5});
+    bus.publish(OrderAck{42});
+
+    EXPECT_DOUBLE_EQ(strategy.last_price, 101.5);
+    EXPECT_EQ(strategy.last_order, 42);
+}
+
+TEST(StaticEventBusTest, CallableHandlerAndUnsubscribe) {
+    TestBus bus;
+    int calls = 0;
+    auto handler = [&calls](const OrderAck&) { ++calls; };
+
+    bus.subscribe<OrderAck>(handler);
+    bus.publish(OrderAck{1});
+    EXPECT_TRUE(bus.unsubscribe<OrderAck>(handler));
+    EXPECT_FALSE(bus.unsubscribe<OrderAck>(handler));
+    bus.publish(OrderAck{2});
+
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(StaticEventBusTest, UnsubscribeAll) {
+    TestBus bus;
+    std::atomic<int> total{0};
+
+    bus.subscribe<PriceTick>(&count_tick, &total);
+    bus.subscribe<PriceTick>(&count_tick, &total);
+    bus.unsubscribe_all<PriceTick>();
+    bus.publish(PriceTick{3, 0.0});
+
+    EXPECT_EQ(total.load(), 0);
+    EXPECT_EQ(bus.handler_count<PriceTick>(), 0);
+}
+
+TEST(StaticEventBusTest, SubscribeWhilePublishing) {
+    TestBus bus;
+    std::atomic<int> total{0};
+    std::atomic<bool> done{false};
+
+    bus.subscribe<PriceTick>(&count_tick, &total);
+
+    std::thread publisher([&] {
+        while (!done.load()) {
+            bus.publish(PriceTick{1, 0.0});
+        }
+    });
+
+    for (int i = 0; i < 100; ++i) {
+        bus.subscribe<PriceTick>(&count_tick, &total);
+        std::this_thread::yield();
+    }
+    while (total.load() == 0) {
+        std::this_thread::yield();
+    }
+    done.store(true);
+    publisher.join();
+
+    EXPECT_EQ(bus.handler_count<PriceTick>(), 101);
+}
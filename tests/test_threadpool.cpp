@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 #include "hft_core/ThreadPool.hpp"
+#include "allocation_counter.hpp"
 #include <atomic>
 #include <chrono>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 using namespace hft::core;
@@ -105,4 +108,316 @@ TEST_F(ThreadPoolTest, HighPriorityThreadPool) {
     
     EXPECT_EQ(future.get(), 123);
     EXPECT_EQ(result.load(), 123);
-}
\ No newline at end of file
+}
+
+TEST_F(ThreadPoolTest, TasksRunInsideScopedArena) {
+    std::vector<std::future<size_t>> futures;
+    for (int i = 0; i < 50; ++i) {
+        futures.push_back(pool_->enqueue_in_arena([](int n) {
+            Arena* arena = Arena::current();
+            if (!arena) {
+                return size_t{0};
+            }
+            std::pmr::vector<int> scratch(arena);
+            for (int j = 0; j < n; ++j) {
+                scratch.push_back(j);
+            }
+            return scratch.size();
+        }, 1000));
+    }
+    for (auto& future : futures) {
+        EXPECT_EQ(future.get(), 1000u);
+    }
+
+    // Outside enqueue_in_arena no arena is bound.
+    auto plain = pool_->enqueue([] { return Arena::current() == nullptr; });
+    EXPECT_TRUE(plain.get());
+}
+
+TEST(WorkStealingThreadPoolTest, RunsExternalSubmissions) {
+    ThreadPool pool(4, SchedulingMode::WorkStealing);
+    EXPECT_EQ(pool.scheduling_mode(), SchedulingMode::WorkStealing);
+
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 1000; ++i) {
+        futures.push_back(pool.enqueue([i] { return i * 2; }));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(futures[i].get(), i * 2);
+    }
+}
+
+TEST(WorkStealingThreadPoolTest, NestedFanOutCompletes) {
+    std::atomic<int> leaves{0};
+    {
+        ThreadPool pool(4, SchedulingMode::WorkStealing);
+        std::vector<std::future<void>> roots;
+        for (int root = 0; root < 8; ++root) {
+            roots.push_back(pool.enqueue([&pool, &leaves] {
+                // Submitted from a worker: lands in its local deque.
+                for (int i = 0; i < 500; ++i) {
+                    pool.enqueue([&leaves] { leaves.fetch_add(1, std::memory_order_relaxed); });
+                }
+            }));
+        }
+        for (auto& root : roots) {
+            root.get();
+        }
+        // The destructor drains every queued task, local or injected.
+    }
+    EXPECT_EQ(leaves.load(), 8 * 500);
+}
+
+TEST(WorkStealingThreadPoolTest, IdleWorkersWakeForLateTasks) {
+    ThreadPool pool(2, SchedulingMode::WorkStealing);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    auto future = pool.enqueue([] { return 7; });
+    EXPECT_EQ(future.get(), 7);
+    EXPECT_EQ(pool.pending_tasks(), 0u);
+}
+
+// Has each of the pool's `workers` run one task before returning: every
+// task holds its worker until all of them have started, so no worker can
+// take two. Lets per-thread first-use allocations happen before counting.
+template<typename Pool>
+void warm_up_every_worker(Pool& pool, size_t workers) {
+    CountdownLatch started(workers);
+    CountdownLatch finished(workers);   // `started` must outlive its waiters
+    for (size_t i = 0; i < workers; ++i) {
+        pool.post([&started, &finished] {
+            started.count_down();
+            started.wait();
+            finished.count_down();
+        });
+    }
+    finished.wait();
+}
+
+// Posts `count` tasks joined by a latch; returns the heap allocations made
+// by all threads meanwhile.
+template<typename Pool>
+size_t allocations_while_posting(Pool& pool, int count, std::atomic<int>& sum) {
+    CountdownLatch latch;
+    g_allocations.store(0);
+    g_count_allocations.store(true);
+    latch.add(count);
+    for (int i = 0; i < count; ++i) {
+        pool.post([&latch, &sum, i] {
+            sum.fetch_add(i, std::memory_order_relaxed);
+            latch.count_down();
+        });
+    }
+    latch.wait();
+    g_count_allocations.store(false);
+    return g_allocations.load();
+}
+
+TEST(PostTest, SharedQueuePostDoesNotAllocate) {
+    ThreadPool pool(2);
+    std::atomic<int> sum{0};
+    warm_up_every_worker(pool, 2);
+    allocations_while_posting(pool, 100, sum);
+
+    sum.store(0);
+    EXPECT_EQ(allocations_while_posting(pool, 500, sum), 0u);
+    EXPECT_EQ(sum.load(), 499 * 500 / 2);
+}
+
+TEST(PostTest, WorkStealingPostDoesNotAllocate) {
+    ThreadPool pool(2, SchedulingMode::WorkStealing);
+    std::atomic<int> sum{0};
+    warm_up_every_worker(pool, 2);
+    allocations_while_posting(pool, 500, sum);
+
+    sum.store(0);
+    EXPECT_EQ(allocations_while_posting(pool, 500, sum), 0u);
+    EXPECT_EQ(sum.load(), 499 * 500 / 2);
+}
+
+TEST(PostTest, HighPriorityPoolPost) {
+    HighPriorityThreadPool pool(2);
+    std::atomic<int> sum{0};
+    warm_up_every_worker(pool, pool.size());
+    allocations_while_posting(pool, 100, sum);
+
+    sum.store(0);
+    EXPECT_EQ(allocations_while_posting(pool, 200, sum), 0u);
+    EXPECT_EQ(sum.load(), 199 * 200 / 2);
+}
+
+class HighPriorityWaitTest : public ::testing::TestWithParam<WaitStrategy> {};
+
+TEST_P(HighPriorityWaitTest, RunsTasksWithEachWaitStrategy) {
+    HighPriorityPoolOptions options;
+    options.wait_strategy = GetParam();
+    options.spin_budget = 256;
+    // Spinning at SCHED_FIFO would starve the test thread on small machines.
+    options.realtime = false;
+    HighPriorityThreadPool pool(1, {}, options);
+
+    for (int round = 0; round < 3; ++round) {
+        auto future = pool.enqueue_high_priority([round] { return round + 1; });
+        EXPECT_EQ(future.get(), round + 1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    std::atomic<int> sum{0};
+    CountdownLatch latch(100);
+    for (int i = 0; i < 100; ++i) {
+        pool.post([&sum, &latch, i] {
+            sum.fetch_add(i);
+            latch.count_down();
+        });
+    }
+    latch.wait();
+    EXPECT_EQ(sum.load(), 99 * 100 / 2);
+}
+
+INSTANTIATE_TEST_SUITE_P(Strategies, HighPriorityWaitTest,
+                         ::testing::Values(WaitStrategy::BusySpin, WaitStrategy::Yield,
+                                           WaitStrategy::Block));
+
+TEST(HighPriorityPoolTest, TryPostFailsWhenQueueIsFull) {
+    HighPriorityPoolOptions options;
+    options.queue_capacity = 4;
+    options.realtime = false;
+    HighPriorityThreadPool pool(1, {}, options);
+
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+    pool.post([&] {
+        started.store(true);
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    });
+    while (!started.load()) {
+        std::this_thread::yield();
+    }
+
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(pool.try_post([&ran] { ran.fetch_add(1); }));
+    }
+    EXPECT_FALSE(pool.try_post([&ran] { ran.fetch_add(1); }));
+    EXPECT_EQ(pool.pending_tasks(), 4u);
+
+    release.store(true);
+    CountdownLatch latch(1);
+    pool.post([&latch] { latch.count_down(); });
+    latch.wait();
+    EXPECT_EQ(ran.load(), 4);
+}
+
+namespace {
+
+// Occupies the single worker of `pool` until the returned flag is set.
+std::shared_ptr<std::atomic<bool>> block_worker(HighPriorityThreadPool& pool) {
+    auto release = std::make_shared<std::atomic<bool>>(false);
+    auto started = std::make_shared<std::atomic<bool>>(false);
+    pool.post(TaskPriority::Critical, [release, started] {
+        started->store(true);
+        while (!release->load()) {
+            std::this_thread::yield();
+        }
+    });
+    while (!started->load()) {
+        std::this_thread::yield();
+    }
+    return release;
+}
+
+HighPriorityPoolOptions plain_options() {
+    HighPriorityPoolOptions options;
+    options.realtime = false;
+    return options;
+}
+
+} // namespace
+
+TEST(HighPriorityPoolTest, HigherLanesRunFirst) {
+    HighPriorityThreadPool pool(1, {}, plain_options());
+    auto release = block_worker(pool);
+
+    std::mutex mutex;
+    std::vector<int> order;
+    auto record = [&](int value) {
+        return [&mutex, &order, value] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(value);
+        };
+    };
+    pool.post(TaskPriority::Low, record(3));
+    pool.post(TaskPriority::Normal, record(2));
+    pool.post(TaskPriority::Critical, record(0));
+    pool.post(TaskPriority::High, record(1));
+    EXPECT_EQ(pool.pending_tasks(TaskPriority::Low), 1u);
+    EXPECT_EQ(pool.pending_tasks(), 4u);
+
+    release->store(true);
+    auto done = pool.enqueue(TaskPriority::Low, 0, [] {});
+    done.get();
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3}));
+}
+
+TEST(HighPriorityPoolTest, DropsExpiredTasks) {
+    HighPriorityPoolOptions options = plain_options();
+    options.expired_policy = ExpiredTaskPolicy::Drop;
+    HighPriorityThreadPool pool(1, {}, options);
+    auto release = block_worker(pool);
+
+    std::atomic<int> ran{0};
+    const uint64_t deadline = Timer::nanos_since_epoch() + 1000000;
+    pool.post(TaskPriority::Normal, [&ran] { ran.fetch_add(1); }, deadline);
+    auto late = pool.enqueue(TaskPriority::Normal, deadline, [] { return 1; });
+    pool.post(TaskPriority::Normal, [&ran] { ran.fetch_add(10); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    release->store(true);
+    EXPECT_THROW(late.get(), std::future_error);
+    pool.enqueue(TaskPriority::Normal, 0, [] {}).get();
+
+    EXPECT_EQ(ran.load(), 10);
+    const TaskLaneStats stats = pool.lane_stats(TaskPriority::Normal);
+    EXPECT_EQ(stats.submitted, 4u);
+    EXPECT_EQ(stats.expired, 2u);
+    EXPECT_EQ(stats.dropped, 2u);
+    EXPECT_EQ(stats.executed, 2u);
+}
+
+TEST(HighPriorityPoolTest, FlagsExpiredTasks) {
+    HighPriorityPoolOptions options = plain_options();
+    options.expired_policy = ExpiredTaskPolicy::Flag;
+    HighPriorityThreadPool pool(1, {}, options);
+    auto release = block_worker(pool);
+
+    auto expired = pool.enqueue(TaskPriority::High, Timer::nanos_since_epoch() + 1000,
+                                [] { return HighPriorityThreadPool::current_task_expired(); });
+    auto on_time = pool.enqueue(TaskPriority::High, 0,
+                                [] { return HighPriorityThreadPool::current_task_expired(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    release->store(true);
+
+    EXPECT_TRUE(expired.get());
+    EXPECT_FALSE(on_time.get());
+    EXPECT_EQ(pool.lane_stats(TaskPriority::High).expired, 1u);
+}
+
+TEST(HighPriorityPoolTest, LaneStatsRecordDepthAndDelay) {
+    HighPriorityThreadPool pool(1, {}, plain_options());
+    auto release = block_worker(pool);
+    for (int i = 0; i < 8; ++i) {
+        pool.post(TaskPriority::Low, [] {});
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    release->store(true);
+    pool.enqueue(TaskPriority::Low, 0, [] {}).get();
+
+    const TaskLaneStats stats = pool.lane_stats(TaskPriority::Low);
+    EXPECT_EQ(stats.executed, 9u);
+    EXPECT_GE(TaskLaneStats::quantile(stats.queue_depth, 1.0), 8u);
+    // The first eight waited behind the blocker for at least ~2 ms.
+    EXPECT_GE(TaskLaneStats::quantile(stats.queue_delay_ns, 0.5), 1000000u);
+    EXPECT_EQ(pool.lane_stats(TaskPriority::Critical).executed, 1u);
+}
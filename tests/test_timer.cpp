@@ -82,4 +82,45 @@ TEST_F(TimerTest, TimeConsistency) {
     // The two measurements should be close (within 1ms tolerance)
     uint64_t diff = std::abs(static_cast<int64_t>(duration_chrono - duration_direct));
     EXPECT_LT(diff, 1000000); // Less than 1ms difference
-}
\ No newline at end of file
+}
+
+TEST_F(TimerTest, CalibrationIsConsistent) {
+    const TscCalibration calibration = Timer::tsc_calibration();
+    EXPECT_GT(calibration.frequency_hz, 100000000u);     // > 100 MHz
+    EXPECT_EQ(calibration.shift, 32u);
+    EXPECT_NE(calibration.mult, 0u);
+
+    // One second of ticks converts to one second, within fixed-point error.
+    const uint64_t ns = Timer::ticks_to_nanos(calibration.frequency_hz);
+    EXPECT_NEAR(static_cast<double>(ns), 1e9, 1e3);
+}
+
+TEST_F(TimerTest, TscConversionTracksMonotonicClock) {
+    const auto wall_start = std::chrono::steady_clock::now();
+    const uint64_t tsc_start = Timer::rdtscp();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const uint64_t tsc_end = Timer::rdtsc_ordered();
+    const auto wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - wall_start).count();
+
+    const double tsc_ns = Timer::tsc_to_nanos(tsc_start, tsc_end);
+    EXPECT_NEAR(tsc_ns, static_cast<double>(wall_ns), static_cast<double>(wall_ns) * 0.02);
+}
+
+TEST_F(TimerTest, EpochNanosMatchSystemClock) {
+    const uint64_t system_before = Timer::nanos_since_epoch();
+    const uint64_t tsc_epoch = Timer::epoch_ns();
+    const uint64_t system_after = Timer::nanos_since_epoch();
+
+    EXPECT_GE(tsc_epoch + 100000, system_before);    // Within 100 us of the system clock
+    EXPECT_LE(tsc_epoch, system_after + 100000);
+
+    Timer::reanchor();
+    const uint64_t first = Timer::epoch_ns();
+    const uint64_t second = Timer::epoch_ns();
+    EXPECT_LE(first, second);
+
+    // Readings from before the anchor still convert.
+    const uint64_t earlier = Timer::tsc_to_epoch_ns(Timer::rdtsc() - Timer::tsc_frequency() / 1000);
+    EXPECT_LT(earlier, second);
+}
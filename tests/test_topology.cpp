@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "hft_core/MemoryPool.hpp"
+#include "hft_core/ThreadPool.hpp"
+#include "hft_core/Topology.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+using namespace hft::core;
+
+namespace fs = std::filesystem;
+
+// Fake sysfs tree: 2 sockets x 2 cores x 2 SMT threads, one node per socket.
+// CPUs 0-3 are the first threads of each core, 4-7 their siblings.
+class TopologyTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root_ = fs::temp_directory_path() / ("hft_topology_" + std::to_string(::getpid()));
+        fs::remove_all(root_);
+        write("cpu/online", "0-7");
+        for (int cpu = 0; cpu < 8; ++cpu) {
+            const int primary = cpu % 4;
+            const std::string dir = "cpu/cpu" + std::to_string(cpu) + "/topology/";
+            write(dir + "physical_package_id", std::to_string(primary / 2));
+            write(dir + "core_id", std::to_string(primary % 2));
+            write(dir + "thread_siblings_list", std::to_string(primary) + "," + std::to_string(primary + 4));
+        }
+        write("node/online", "0-1");
+        write("node/node0/cpulist", "0-1,4-5");
+        write("node/node1/cpulist", "2-3,6-7");
+    }
+
+    void TearDown() override {
+        fs::remove_all(root_);
+    }
+
+    void write(const std::string& path, const std::string& contents) {
+        const fs::path file = root_ / path;
+        fs::create_directories(file.parent_path());
+        std::ofstream(file) << contents << "\n";
+    }
+
+    fs::path root_;
+};
+
+TEST(CpuListTest, ParsesRangesAndSingles) {
+    EXPECT_EQ(parse_cpu_list("0-3,8,10-11\n"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(parse_cpu_list("5"), (std::vector<int>{5}));
+    EXPECT_TRUE(parse_cpu_list("").empty());
+}
+
+TEST_F(TopologyTest, DetectsSocketsCoresAndNodes) {
+    const CpuTopology topology = CpuTopology::detect(root_.string());
+
+    ASSERT_EQ(topology.cpus().size(), 8u);
+    EXPECT_EQ(topology.socket_count(), 2u);
+    EXPECT_EQ(topology.numa_node_count(), 2u);
+    EXPECT_EQ(topology.physical_core_count(), 4u);
+    EXPECT_EQ(topology.numa_node_of(6), 1);
+    EXPECT_EQ(topology.numa_node_of(42), -1);
+    EXPECT_TRUE(topology.cpus()[2].primary);
+    EXPECT_FALSE(topology.cpus()[6].primary);
+}
+
+TEST_F(TopologyTest, PhysicalCoresOnNodeSkipSiblings) {
+    const CpuTopology topology = CpuTopology::detect(root_.string());
+
+    EXPECT_EQ(topology.select(PlacementPolicy{1, true}), (std::vector<int>{2, 3}));
+    EXPECT_EQ(topology.select(PlacementPolicy{1, false}), (std::vector<int>{2, 3, 6, 7}));
+    // Without a node filter, every physical core comes before any sibling.
+    EXPECT_EQ(topology.select(PlacementPolicy{}), (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}));
+    EXPECT_TRUE(topology.select(PlacementPolicy{3, false}).empty());
+}
+
+TEST(SystemTopologyTest, FallsBackWithoutSysfs) {
+    const CpuTopology topology = CpuTopology::detect("/nonexistent");
+
+    EXPECT_FALSE(topology.cpus().empty());
+    EXPECT_EQ(topology.numa_node_count(), 1u);
+    EXPECT_EQ(topology.physical_core_count(), topology.cpus().size());
+}
+
+TEST(SystemTopologyTest, PlacementPoolPinsWorkers) {
+    const std::vector<int> expected = CpuTopology::system().select(PlacementPolicy{-1, true});
+    ThreadPool pool(PlacementPolicy{-1, true});
+
+    ASSERT_EQ(pool.size(), expected.size());
+    EXPECT_EQ(pool.worker_cpus(), expected);
+
+#ifdef __linux__
+    std::vector<std::future<int>> cpus;
+    for (size_t i = 0; i < pool.size() * 4; ++i) {
+        cpus.push_back(pool.enqueue([] { return sched_getcpu(); }));
+    }
+    for (auto& cpu : cpus) {
+        const int value = cpu.get();
+        EXPECT_NE(std::find(expected.begin(), expected.end(), value), expected.end());
+    }
+#endif
+}
+
+TEST(SystemTopologyTest, PlacementWithNoMatchingCpuThrows) {
+    EXPECT_THROW(ThreadPool(PlacementPolicy{1 << 20, false}), std::invalid_argument);
+}
+
+TEST(SystemTopologyTest, PinningRejectsOutOfRangeCpus) {
+    EXPECT_FALSE(pin_current_thread(-1));
+    EXPECT_FALSE(pin_current_thread(1 << 20));
+}
+
+TEST(SystemTopologyTest, NodeLocalPoolsStayUsable) {
+    MemoryPoolOptions options;
+    options.numa_node = current_numa_node();
+
+    MemoryPool<int> pool(4, options);
+    int* value = pool.allocate();
+    *value = 7;
+    EXPECT_EQ(*value, 7);
+    pool.deallocate(value);
+
+    LockFreeMemoryPool<int> lock_free(128, options);
+    int* node = lock_free.allocate();
+    *node = 11;
+    lock_free.deallocate(node);
+    EXPECT_EQ(lock_free.capacity(), 128u);
+
+    // mbind() is refused on kernels without NUMA support; the pools then
+    // fall back to ordinary pages, so only check consistency.
+    EXPECT_EQ(pool.numa_bound(), lock_free.numa_bound());
+}
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include "hft_core/EventBus.hpp"
+#include "hft_core/ThreadPool.hpp"
+#include "hft_core/Trace.hpp"
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace hft::core;
+
+namespace {
+
+constexpr uint32_t kProbe = static_cast<uint32_t>(TraceProbe::User) + 1;
+
+class TraceTest : public ::testing::Test {
+protected:
+    void start(size_t threads = 8, size_t capacity = 1024) {
+        TraceOptions options;
+        options.name = "/hft_trace_test." + std::to_string(::getpid());
+        options.max_threads = threads;
+        options.ring_capacity = capacity;
+        Tracer::instance().start(options);
+    }
+
+    void TearDown() override {
+        Tracer::instance().stop(true);
+    }
+
+    static const TraceThread* find_thread(const TraceCapture& capture, uint64_t marker) {
+        for (const auto& thread : capture.threads) {
+            for (const auto& record : thread.records) {
+                if (record.probe == kProbe && record.payload == marker) {
+                    return &thread;
+                }
+            }
+        }
+        return nullptr;
+    }
+};
+
+} // namespace
+
+TEST_F(TraceTest, InactiveTracerRecordsNothing) {
+    EXPECT_FALSE(Tracer::instance().active());
+    trace_point(kProbe, 1);
+
+    start();
+    EXPECT_TRUE(Tracer::instance().active());
+    const TraceCapture capture = read_trace(Tracer::instance().segment_name());
+    EXPECT_TRUE(capture.threads.empty());
+}
+
+TEST_F(TraceTest, RecordsPerThreadInOrder) {
+    start();
+    for (uint64_t i = 0; i < 10; ++i) {
+        trace_point(kProbe, i);
+    }
+    std::thread other([] {
+        for (uint64_t i = 100; i < 105; ++i) {
+            trace_point(kProbe, i);
+        }
+    });
+    other.join();
+
+    const TraceCapture capture = read_trace(Tracer::instance().segment_name());
+    EXPECT_EQ(capture.pid, ::getpid());
+    EXPECT_GT(capture.tsc_frequency_hz, 0u);
+    ASSERT_EQ(capture.threads.size(), 2u);
+
+    const TraceThread* main_thread = find_thread(capture, 0);
+    const TraceThread* other_thread = find_thread(capture, 100);
+    ASSERT_NE(main_thread, nullptr);
+    ASSERT_NE(other_thread, nullptr);
+    EXPECT_NE(main_thread->tid, other_thread->tid);
+    ASSERT_EQ(main_thread->records.size(), 10u);
+    ASSERT_EQ(other_thread->records.size(), 5u);
+    for (size_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(main_thread->records[i].payload, i);
+        if (i > 0) {
+            EXPECT_GE(main_thread->records[i].tsc, main_thread->records[i - 1].tsc);
+        }
+    }
+
+    const uint64_t stamp = capture.to_epoch_ns(main_thread->records.front().tsc);
+    EXPECT_NEAR(static_cast<double>(stamp), static_cast<double>(Timer::nanos_since_epoch()), 5e9);
+}
+
+TEST_F(TraceTest, RingKeepsNewestRecords) {
+    start(4, 16);
+    for (uint64_t i = 0; i < 100; ++i) {
+        trace_point(kProbe, i);
+    }
+
+    const TraceCapture capture = read_trace(Tracer::instance().segment_name());
+    ASSERT_EQ(capture.threads.size(), 1u);
+    const TraceThread& thread = capture.threads.front();
+    ASSERT_EQ(thread.records.size(), 15u);
+    EXPECT_EQ(thread.lost, 85u);
+    EXPECT_EQ(thread.records.front().payload, 85u);
+    EXPECT_EQ(thread.records.back().payload, 99u);
+}
+
+TEST_F(TraceTest, ExtraThreadsAreCountedNotTraced) {
+    start(1, 16);
+    trace_point(kProbe, 1);
+    std::thread other([] { trace_point(kProbe, 2); });
+    other.join();
+
+    const TraceCapture capture = read_trace(Tracer::instance().segment_name());
+    EXPECT_EQ(capture.threads.size(), 1u);
+    EXPECT_EQ(capture.threads_dropped, 1u);
+}
+
+TEST_F(TraceTest, RestartAttachesToNewSegment) {
+    start();
+    trace_point(kProbe, 1);
+    Tracer::instance().stop(true);
+    trace_point(kProbe, 2);
+
+    start();
+    trace_point(kProbe, 3);
+    const TraceCapture capture = read_trace(Tracer::instance().segment_name());
+    ASSERT_EQ(capture.threads.size(), 1u);
+    ASSERT_EQ(capture.threads.front().records.size(), 1u);
+    EXPECT_EQ(capture.threads.front().records.front().payload, 3u);
+}
+
+TEST_F(TraceTest, ExportsChromeTraceAndTimelines) {
+    start();
+    trace_point(static_cast<uint32_t>(TraceProbe::EventPublish), 42);
+    std::thread handler([] {
+        TraceScope scope(TraceProbe::EventHandlerBegin, TraceProbe::EventHandlerEnd, 42);
+    });
+    handler.join();
+    trace_point(kProbe, 7);
+
+    const TraceCapture capture = read_trace(Tracer::instance().segment_name());
+
+    std::ostringstream json;
+    write_chrome_trace(capture, json);
+    const std::string text = json.str();
+    EXPECT_EQ(text.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(text.find("\"name\":\"publish\""), std::string::npos);
+    EXPECT_NE(text.find("\"ph\":\"B\""), std::string::npos);
+    EXPECT_NE(text.find("\"ph\":\"E\""), std::string::npos);
+    EXPECT_NE(text.find("\"ph\":\"s\",\"id\":\"e42\""), std::string::npos);
+    EXPECT_NE(text.find("\"ph\":\"f\",\"bp\":\"e\",\"id\":\"e42\""), std::string::npos);
+    EXPECT_NE(text.find("\"name\":\"probe_257\""), std::string::npos);
+
+    std::ostringstream timelines;
+    write_trace_timelines(capture, timelines);
+    const std::string lines = timelines.str();
+    EXPECT_EQ(lines.rfind("event 42  publish@", 0), 0u);
+    EXPECT_LT(lines.find("publish@"), lines.find("handler_begin@"));
+    EXPECT_LT(lines.find("handler_begin@"), lines.find("handler_end@"));
+    EXPECT_EQ(lines.find("\n"), lines.size() - 1);
+}
+
+TEST_F(TraceTest, RejectsNonTraceSegments) {
+    EXPECT_THROW(read_trace("/hft_trace_missing_segment"), std::runtime_error);
+    EXPECT_THROW(read_trace("/proc/self/cmdline"), std::runtime_error);
+}
+
+#ifdef HFT_ENABLE_TRACING
+TEST_F(TraceTest, LibraryProbesFollowEventsAndTasks) {
+    struct Quote : TypedEvent<Quote> {
+        uint64_t trace_id() const noexcept { return 77; }
+    };
+
+    start();
+    auto& bus = EventBus::instance();
+    bus.subscribe<Quote>([](const Quote&) {});
+    bus.publish(Quote{});
+    bus.unsubscribe<Quote>();
+
+    {
+        ThreadPool pool(1);
+        pool.enqueue([] {}).get();
+    }
+
+    const TraceCapture capture = read_trace(Tracer::instance().segment_name());
+    std::ostringstream timelines;
+    write_trace_timelines(capture, timelines);
+    const std::string lines = timelines.str();
+    EXPECT_NE(lines.find("event 77  publish@"), std::string::npos) << lines;
+    EXPECT_NE(lines.find("handler_end@"), std::string::npos) << lines;
+    EXPECT_NE(lines.find("task_enqueue@"), std::string::npos) << lines;
+    EXPECT_NE(lines.find("task_end@"), std::string::npos) << lines;
+}
+#endif
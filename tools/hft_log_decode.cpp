@@ -0,0 +1,35 @@
+#include "hft_core/Logger.hpp"
+
+#include <fstream>
+#include <iostream>
+
+// Converts a log written with LogFormat::Binary back to text.
+// Usage: hft_log_decode <binary-log> [output]
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "usage: " << argv[0] << " <binary-log> [output]\n";
+        return 2;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in) {
+        std::cerr << "cannot open " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::ofstream file;
+    if (argc == 3) {
+        file.open(argv[2]);
+        if (!file) {
+            std::cerr << "cannot open " << argv[2] << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = argc == 3 ? file : std::cout;
+
+    if (!hft::core::decode_binary_log(in, out)) {
+        std::cerr << "malformed or truncated log: " << argv[1] << "\n";
+        return 1;
+    }
+    return 0;
+}
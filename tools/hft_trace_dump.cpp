@@ -0,0 +1,57 @@
+#include "hft_core/Trace.hpp"
+
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+
+// Reads a trace segment written by a process built with HFT_ENABLE_TRACING.
+// Usage: hft_trace_dump [--timeline] <segment> [output]
+//   default  Chrome trace / Perfetto JSON (open in ui.perfetto.dev)
+//   --timeline  one line per event or task, probes in time order
+int main(int argc, char** argv) {
+    int arg = 1;
+    bool timeline = false;
+    if (arg < argc && std::strcmp(argv[arg], "--timeline") == 0) {
+        timeline = true;
+        ++arg;
+    }
+    if (argc - arg < 1 || argc - arg > 2) {
+        std::cerr << "usage: " << argv[0] << " [--timeline] <segment> [output]\n";
+        return 2;
+    }
+
+    hft::core::TraceCapture capture;
+    try {
+        capture = hft::core::read_trace(argv[arg]);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    std::ofstream file;
+    if (argc - arg == 2) {
+        file.open(argv[arg + 1]);
+        if (!file) {
+            std::cerr << "cannot open " << argv[arg + 1] << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = argc - arg == 2 ? file : std::cout;
+
+    if (timeline) {
+        hft::core::write_trace_timelines(capture, out);
+    } else {
+        hft::core::write_chrome_trace(capture, out);
+    }
+
+    for (const auto& thread : capture.threads) {
+        if (thread.lost != 0) {
+            std::cerr << "thread " << thread.tid << ": " << thread.lost << " records overwritten\n";
+        }
+    }
+    if (capture.threads_dropped != 0) {
+        std::cerr << capture.threads_dropped << " threads found no free ring\n";
+    }
+    return 0;
+}